@@ -8,12 +8,16 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/base/SkRandom.h"
 
+#include <memory>
+
 #define FILTER_WIDTH_SMALL  32
 #define FILTER_HEIGHT_SMALL 32
 #define FILTER_WIDTH_LARGE  256
@@ -60,19 +64,24 @@ static sk_sp<SkImage> make_checkerboard(int width, int height) {
 
 class BlurImageFilterBench : public Benchmark {
 public:
+    // With threads > 0, the raster blur is split across a pool of that many threads.
     BlurImageFilterBench(SkScalar sigmaX, SkScalar sigmaY,  bool small, bool cropped,
-                         bool expanded)
+                         bool expanded, int threads = 0)
       : fIsSmall(small)
       , fIsCropped(cropped)
       , fIsExpanded(expanded)
       , fInitialized(false)
       , fSigmaX(sigmaX)
-      , fSigmaY(sigmaY) {
+      , fSigmaY(sigmaY)
+      , fThreads(threads) {
         fName.printf("blur_image_filter_%s%s%s_%.2f_%.2f",
                      fIsSmall ? "small" : "large",
                      fIsCropped ? "_cropped" : "",
                      fIsExpanded ? "_expanded" : "",
                      sigmaX, sigmaY);
+        if (threads > 0) {
+            fName.appendf("_threads%d", threads);
+        }
         SkASSERT(!fIsExpanded || fIsCropped); // never want expansion w/o cropping
     }
 
@@ -85,6 +94,9 @@ protected:
         if (!fInitialized) {
             fCheckerboard = make_checkerboard(fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE,
                                               fIsSmall ? FILTER_HEIGHT_SMALL : FILTER_HEIGHT_LARGE);
+            if (fThreads > 0) {
+                fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            }
             fInitialized = true;
         }
     }
@@ -106,9 +118,11 @@ protected:
         paint.setImageFilter(SkImageFilters::Blur(fSigmaX, fSigmaY, std::move(input), crop));
         SkSamplingOptions sampling;
 
+        SkGraphics::SetRasterBlurExecutor(fExecutor.get());
         for (int i = 0; i < loops; i++) {
             canvas->drawImage(fCheckerboard, kX, kY, sampling, &paint);
         }
+        SkGraphics::SetRasterBlurExecutor(nullptr);
     }
 
 private:
@@ -120,9 +134,114 @@ private:
     bool fInitialized;
     sk_sp<SkImage> fCheckerboard;
     SkScalar fSigmaX, fSigmaY;
+    int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    using INHERITED = Benchmark;
+};
+
+// Draws a blurred image in a 256x256 window that scrolls down it a few pixels each loop, as a
+// scrolling layer would. With 'reuseOverlapping', the image filter cache reuses the blur from the
+// previous loop and only blurs the strip scrolled into view.
+class BlurImageFilterScrollingBench : public Benchmark {
+public:
+    explicit BlurImageFilterScrollingBench(bool reuseOverlapping)
+            : fReuseOverlapping(reuseOverlapping) {
+        fName.printf("blur_image_filter_scrolling%s", reuseOverlapping ? "_reuse_overlapping" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (!fContent) {
+            fContent = make_checkerboard(kWindowSize, 16 * kWindowSize);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        static constexpr int kScrollPerLoop = 3;
+
+        SkPaint paint;
+        paint.setImageFilter(SkImageFilters::Blur(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE,
+                                                  SkImageFilters::Image(fContent,
+                                                                        SkFilterMode::kNearest)));
+
+        SkGraphics::SetImageFilterCacheReuseOverlapping(fReuseOverlapping);
+        const int maxScroll = fContent->height() - kWindowSize;
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            canvas->clipRect(SkRect::MakeWH(kWindowSize, kWindowSize));
+            canvas->translate(0, -((i * kScrollPerLoop) % maxScroll));
+            canvas->drawPaint(paint);
+            canvas->restore();
+        }
+        SkGraphics::SetImageFilterCacheReuseOverlapping(false);
+    }
+
+private:
+    static constexpr int kWindowSize = 256;
+
+    SkString fName;
+    bool fReuseOverlapping;
+    sk_sp<SkImage> fContent;
     using INHERITED = Benchmark;
 };
 
+// Draws a blurred 256x256 image whose only change from one loop to the next is a blinking cursor,
+// as under a blurred backdrop. With 'recordDamage', each new frame is recorded as damaged only at
+// the cursor, so the image filter cache patches the blur of the previous frame around it.
+class BlurImageFilterDamagedSourceBench : public Benchmark {
+public:
+    explicit BlurImageFilterDamagedSourceBench(bool recordDamage) : fRecordDamage(recordDamage) {
+        fName.printf("blur_image_filter_blinking_cursor%s", recordDamage ? "_damage" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kRaster; }
+
+    void onDelayedSetup() override {
+        if (fFrame.isNull()) {
+            fFrame.allocN32Pixels(kFrameSize, kFrameSize);
+            SkCanvas canvas(fFrame);
+            canvas.drawImage(make_checkerboard(kFrameSize, kFrameSize), 0, 0);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkIRect cursor = SkIRect::MakeXYWH(120, 100, 2, 16);
+
+        SkPaint paint;
+        paint.setImageFilter(SkImageFilters::Blur(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, nullptr));
+
+        sk_sp<SkImage> previous = fFrame.asImage();
+        for (int i = 0; i < loops; i++) {
+            fFrame.erase((i & 1) ? SK_ColorBLACK : SK_ColorWHITE, cursor);
+            sk_sp<SkImage> current = fFrame.asImage();
+            if (fRecordDamage) {
+                SkGraphics::SetImageFilterSourceDamage(previous->uniqueID(), current->uniqueID(),
+                                                       cursor);
+            }
+            canvas->drawImage(current, 0, 0, SkSamplingOptions(), &paint);
+            previous = std::move(current);
+        }
+    }
+
+private:
+    static constexpr int kFrameSize = 256;
+
+    SkString fName;
+    bool fRecordDamage;
+    SkBitmap fFrame;
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurImageFilterScrollingBench(false);)
+DEF_BENCH(return new BlurImageFilterScrollingBench(true);)
+DEF_BENCH(return new BlurImageFilterDamagedSourceBench(false);)
+DEF_BENCH(return new BlurImageFilterDamagedSourceBench(true);)
+
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, 0, false, false, false);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_SMALL, 0, false, false, false);)
 DEF_BENCH(return new BlurImageFilterBench(0, BLUR_SIGMA_LARGE, false, false, false);)
@@ -161,3 +280,9 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false, 2);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, false, false, 4);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 2);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 4);)
+DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, false, false, 8);)
@@ -15,6 +15,8 @@
 #include "src/utils/SkCharToGlyphCache.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <memory>
+
 enum {
     NGLYPHS = 100
 };
@@ -124,3 +126,51 @@ DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "font_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(addcache_proc, "addcache_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", BIG); )
+
+// Latin text as UTF-8, the common case for textToGlyphs. The characters per second are the count
+// in the name divided by the time per loop.
+class UTF8ToGlyphsBench : public Benchmark {
+    SkString     fName;
+    SkString     fText;
+    SkFont       fFont;
+    int          fCount;
+    std::unique_ptr<SkGlyphID[]> fGlyphs;
+
+public:
+    UTF8ToGlyphsBench(int count) : fCount(count) {
+        fName.printf("font_utf8ToGlyph_latin_%d", count);
+        static const char kText[] = "The quick brown fox jumps over the lazy dog. "
+                                    "Voix ambigu\xC3\xAB d'un c\xC5\x93ur qui, au z\xC3\xA9phyr, "
+                                    "pr\xC3\xA9""f\xC3\xA8re les jattes de kiwis. ";
+        while (SkUTF::CountUTF8(fText.c_str(), fText.size()) < count) {
+            fText.append(kText);
+        }
+        const char* end = fText.c_str();
+        for (int i = 0; i < count; ++i) {
+            SkUTF::NextUTF8(&end, fText.c_str() + fText.size());
+        }
+        fText.resize(end - fText.c_str());
+        fGlyphs.reset(new SkGlyphID[count]);
+        fFont.setTypeface(ToolUtils::DefaultPortableTypeface());
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            fFont.textToGlyphs(fText.c_str(), fText.size(), SkTextEncoding::kUTF8,
+                               fGlyphs.get(), fCount);
+        }
+    }
+};
+
+DEF_BENCH( return new UTF8ToGlyphsBench(SMALL); )
+DEF_BENCH( return new UTF8ToGlyphsBench(BIG); )
+DEF_BENCH( return new UTF8ToGlyphsBench(4096); )
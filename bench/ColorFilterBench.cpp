@@ -9,14 +9,18 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkSurface.h"
+#include "include/effects/SkColorMatrix.h"
 #include "include/effects/SkHighContrastFilter.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkOverdrawColorFilter.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTo.h"
 #include "src/core/SkColorFilterPriv.h"
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
 
+#include <cmath>
 #include <functional>
 
 static constexpr char kRuntimeNone_GPU_SRC[] = R"(
@@ -201,6 +205,30 @@ DEF_BENCH( return new ColorFilterBench("compose_src",
     []() { return SkColorFilters::Compose(SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc),
                                           SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc));
     }); )
+// Chains like these, as feColorMatrix and feComponentTransfer build them, run as one matrix or
+// one table.
+DEF_BENCH( return new ColorFilterBench("compose_matrix",
+    []() {
+        SkColorMatrix saturate;
+        saturate.setSaturation(0.5f);
+        SkColorMatrix scale;
+        scale.setScale(0.9f, 0.8f, 0.7f);
+        auto matrix = [](const SkColorMatrix& cm) {
+            return SkColorFilters::Matrix(cm, SkColorFilters::Clamp::kNo);
+        };
+        return SkColorFilters::Compose(SkColorFilters::Matrix(kGrayscaleMatrix),
+                                       SkColorFilters::Compose(matrix(scale), matrix(saturate)));
+    }); )
+DEF_BENCH( return new ColorFilterBench("compose_table",
+    []() {
+        uint8_t invert[256], gamma[256];
+        for (int i = 0; i < 256; ++i) {
+            invert[i] = 255 - i;
+            gamma[i] = SkToU8(sk_float_round2int(255 * std::pow(i / 255.0f, 2.2f)));
+        }
+        return SkColorFilters::Compose(SkColorFilters::TableARGB(nullptr, gamma, gamma, gamma),
+                                       SkColorFilters::TableARGB(nullptr, invert, invert, invert));
+    }); )
 DEF_BENCH( return new ColorFilterBench("lerp_src",
     []() { return SkColorFilters::Lerp(0.3f,
                                        SkColorFilters::Blend(0x80808080, SkBlendMode::kSrc),
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "tools/ProcStats.h"
+#include "tools/Resources.h"
+
+#if defined(SK_FONTMGR_FREETYPE_DIRECTORY_AVAILABLE)
+#include "include/ports/SkFontMgr_directory.h"
+
+#include <cstdio>
+
+#if defined(SK_BUILD_FOR_ANDROID)
+static constexpr const char* kIndexFile = "/data/local/tmp/fontmgr_directory_bench.index";
+#else
+static constexpr const char* kIndexFile = "/tmp/fontmgr_directory_bench.index";
+#endif
+
+/*
+ * Measures creating a directory font manager over the resource fonts, either scanning every
+ * font file or starting from an up to date index. Reports the resident set size the font
+ * managers add.
+ */
+class FontMgrDirectoryBench : public Benchmark {
+public:
+    explicit FontMgrDirectoryBench(bool useIndex) : fUseIndex(useIndex) {
+        fName.printf("FontMgrDirectory_%s", useIndex ? "indexed" : "scan");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        fDirectory = GetResourcePath("fonts");
+        if (fUseIndex) {
+            remove(kIndexFile);
+            SkFontMgr_New_Custom_Directory(fDirectory.c_str(), kIndexFile);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int64_t rssBefore = sk_tools::getCurrResidentSetSizeBytes();
+        for (int i = 0; i < loops; ++i) {
+            sk_sp<SkFontMgr> fm = fUseIndex
+                    ? SkFontMgr_New_Custom_Directory(fDirectory.c_str(), kIndexFile)
+                    : SkFontMgr_New_Custom_Directory(fDirectory.c_str());
+            if (i == loops - 1 && rssBefore >= 0) {
+                fRSSBytes = sk_tools::getCurrResidentSetSizeBytes() - rssBefore;
+            }
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fRSSBytes >= 0 && !fReported) {
+            SkDebugf("%s: font manager adds %lld KB resident\n",
+                     fName.c_str(), (long long)(fRSSBytes >> 10));
+            fReported = true;
+        }
+    }
+
+private:
+    const bool fUseIndex;
+    SkString fName;
+    SkString fDirectory;
+    int64_t fRSSBytes = -1;
+    bool fReported = false;
+};
+
+DEF_BENCH(return new FontMgrDirectoryBench(false);)
+DEF_BENCH(return new FontMgrDirectoryBench(true);)
+
+#endif  // SK_FONTMGR_FREETYPE_DIRECTORY_AVAILABLE
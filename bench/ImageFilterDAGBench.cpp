@@ -7,11 +7,15 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
 #include "include/effects/SkImageFilters.h"
 #include "tools/DecodeUtils.h"
 #include "tools/Resources.h"
 
+#include <memory>
+
 #if defined(SK_GANESH)
 #include "include/gpu/GrRecordingContext.h"
 #include "include/gpu/ganesh/SkImageGanesh.h"
@@ -180,7 +184,57 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Exercise a merge of several independent, expensive inputs. With threads > 0, the inputs are
+// evaluated concurrently on a pool of that many threads.
+class ImageFilterIndependentInputsBench : public Benchmark {
+public:
+    explicit ImageFilterIndependentInputsBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_independent_inputs");
+        if (threads > 0) {
+            fName.appendf("_threads%d", threads);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0 && !fExecutor) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect rect = SkRect::MakeWH(400, 400);
+
+        SkGraphics::SetImageFilterExecutor(fExecutor.get());
+        for (int j = 0; j < loops; j++) {
+            // The filters are made in the loop so the raster image filter cache can't skip the
+            // work of earlier loops.
+            sk_sp<SkImageFilter> inputs[kNumInputs];
+            for (int i = 0; i < kNumInputs; ++i) {
+                inputs[i] = SkImageFilters::Offset(
+                        5.0f * i, 0.0f, SkImageFilters::Blur(4.0f + 4 * i, 12.0f, nullptr));
+            }
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Merge(inputs, kNumInputs));
+            canvas->drawRect(rect, paint);
+        }
+        SkGraphics::SetImageFilterExecutor(nullptr);
+    }
+
+private:
+    static const int kNumInputs = 4;
+    SkString fName;
+    int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterIndependentInputsBench(0);)
+DEF_BENCH(return new ImageFilterIndependentInputsBench(4);)
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkString.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#include <cstring>
+
+extern bool gSkUseMSDFText;
+
+/*
+ * Draws a line of text at many sizes, as zooming text does, either through a strike (or paths)
+ * for each size or, with gSkUseMSDFText, from one multi-channel distance field per glyph.
+ */
+class MSDFGlyphBench : public Benchmark {
+public:
+    explicit MSDFGlyphBench(bool useField) : fUseField(useField) {
+        fName.printf("MSDFGlyph_%s", useField ? "field" : "path");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        fFont = ToolUtils::DefaultPortableFont();
+        fFont.setHinting(SkFontHinting::kNone);
+        fBitmap.allocN32Pixels(400, 400);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const char* text = "Keep your sentences short";
+        SkCanvas canvas(fBitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        const bool wasUsingFields = gSkUseMSDFText;
+        gSkUseMSDFText = fUseField;
+        for (int i = 0; i < loops; ++i) {
+            for (float size = 32; size <= 256; size *= 1.25f) {
+                SkFont font = fFont;
+                font.setSize(size);
+                canvas.drawSimpleText(text, strlen(text), SkTextEncoding::kUTF8, 8, size, font,
+                                      paint);
+            }
+        }
+        gSkUseMSDFText = wasUsingFields;
+    }
+
+private:
+    const bool fUseField;
+    SkString fName;
+    SkFont fFont;
+    SkBitmap fBitmap;
+};
+
+DEF_BENCH(return new MSDFGlyphBench(false);)
+DEF_BENCH(return new MSDFGlyphBench(true);)
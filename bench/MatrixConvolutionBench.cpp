@@ -14,6 +14,8 @@
 
 #include "tools/ToolUtils.h"
 
+#include <vector>
+
 class MatrixConvolutionBench : public Benchmark {
 public:
     MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
@@ -74,6 +76,58 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Square kernels from 3x3 up to the largest allowed (16x16), either separable (a binomial blur)
+// or not (the same with its center coefficient changed).
+class MatrixConvolutionSizeBench : public Benchmark {
+public:
+    MatrixConvolutionSizeBench(int size, bool separable)
+        : fName(SkStringPrintf("matrixconvolution_%dx%d%s", size, size,
+                               separable ? "_separable" : "")) {
+        std::vector<float> binomial(size, 1.f);
+        for (int n = 1; n < size; ++n) {
+            for (int i = n - 1; i > 0; --i) {
+                binomial[i] += binomial[i - 1];
+            }
+        }
+        std::vector<float> kernel;
+        float sum = 0;
+        for (float y : binomial) {
+            for (float x : binomial) {
+                kernel.push_back(x * y);
+                sum += x * y;
+            }
+        }
+        if (!separable) {
+            kernel[(size / 2) * size + size / 2] *= 2;
+        }
+        fFilter = SkImageFilters::MatrixConvolution(SkISize::Make(size, size), kernel.data(),
+                                                    1 / sum, 0, SkIPoint::Make(size / 2, size / 2),
+                                                    SkTileMode::kDecal, true, nullptr);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setImageFilter(fFilter);
+        paint.setAntiAlias(true);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawOval(SkRect::MakeWH(256, 256), paint);
+        }
+    }
+
+private:
+    sk_sp<SkImageFilter> fFilter;
+    SkString fName;
+
+    using INHERITED = Benchmark;
+};
+
 DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
 DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
 DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
@@ -85,3 +139,12 @@ DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
 DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionSizeBench(3, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(3, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(5, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(5, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(9, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(9, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(16, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(16, false); )
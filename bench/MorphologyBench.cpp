@@ -16,6 +16,8 @@
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+#define LARGE    SkIntToScalar(64)
+#define MAXIMUM SkIntToScalar(256)
 
 enum MorphologyType {
     kErode_MT,
@@ -89,6 +91,12 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(LARGE, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT); )
+
+DEF_BENCH( return new MorphologyBench(MAXIMUM, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(MAXIMUM, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
@@ -11,9 +11,13 @@
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/docs/SkPDFDocument.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
@@ -85,40 +89,60 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 #include "src/pdf/SkPDFUtils.h"
 
 namespace {
+/** Serializes an image into a PDF. The encoded size is reported once so that changes to the
+    image encoding can be compared on size as well as on time. */
 class PDFImageBench : public Benchmark {
 public:
-    PDFImageBench() {}
+    enum class Source {
+        kDecoded,  // force decoding, throw away reference to encoded data.
+        kEncoded,  // keep the encoded data, so it may be passed through.
+    };
+    PDFImageBench(const char* name, const char* resource, Source source,
+                  int photographicEncodingQuality = 101)
+            : fName(name)
+            , fResource(resource)
+            , fSource(source)
+            , fPhotographicEncodingQuality(photographicEncodingQuality) {}
     ~PDFImageBench() override {}
 
 protected:
-    const char* onGetName() override { return "PDFImage"; }
+    const char* onGetName() override { return fName; }
     bool isSuitableFor(Backend backend) override {
         return backend == Backend::kNonRendering;
     }
     void onDelayedSetup() override {
-        sk_sp<SkImage> img(ToolUtils::GetResourceAsImage("images/color_wheel.png"));
-        if (img) {
-            // force decoding, throw away reference to encoded data.
+        sk_sp<SkImage> img(ToolUtils::GetResourceAsImage(fResource));
+        if (img && fSource == Source::kDecoded) {
             SkAutoPixmapStorage pixmap;
             pixmap.alloc(SkImageInfo::MakeN32Premul(img->dimensions()));
             if (img->readPixels(nullptr, pixmap, 0, 0)) {
                 fImage = SkImages::RasterFromPixmapCopy(pixmap);
             }
+        } else {
+            fImage = std::move(img);
         }
     }
     void onDraw(int loops, SkCanvas*) override {
         if (!fImage) {
             return;
         }
+        SkPDF::Metadata metadata;
+        metadata.fPhotographicEncodingQuality = fPhotographicEncodingQuality;
         while (loops-- > 0) {
             SkNullWStream nullStream;
-            SkPDFDocument doc(&nullStream, SkPDF::Metadata());
-            doc.beginPage(256, 256);
-            (void)SkPDFSerializeImage(fImage.get(), &doc);
+            {
+                SkPDFDocument doc(&nullStream, metadata);
+                doc.beginPage(256, 256);
+                (void)SkPDFSerializeImage(fImage.get(), &doc);
+            }
         }
     }
 
 private:
+    const char* fName;
+    const char* fResource;
+    Source fSource;
+    int fPhotographicEncodingQuality;
     sk_sp<SkImage> fImage;
 };
 
@@ -229,6 +253,77 @@ struct PDFShaderBench : public Benchmark {
     }
 };
 
+// Draws the same gradient many times under different translations, as charts do.
+struct PDFRepeatedShaderBench : public Benchmark {
+    sk_sp<SkShader> fShader;
+    const char* onGetName() final { return "PDFShader_repeated"; }
+    bool isSuitableFor(Backend b) final { return b == Backend::kNonRendering; }
+    void onDelayedSetup() final {
+        const SkPoint pts[2] = {{0.0f, 0.0f}, {20.0f, 20.0f}};
+        const SkColor colors[] = {
+            SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE,
+            SK_ColorWHITE, SK_ColorBLACK,
+        };
+        fShader = SkGradientShader::MakeLinear(
+                pts, colors, nullptr, std::size(colors),
+                SkTileMode::kClamp);
+    }
+    void onDraw(int loops, SkCanvas*) final {
+        SkASSERT(fShader);
+        SkPaint paint;
+        paint.setShader(fShader);
+        while (loops-- > 0) {
+            SkNullWStream stream;
+            auto doc = SkPDF::MakeDocument(&stream);
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            for (int y = 0; y < 792; y += 24) {
+                for (int x = 0; x < 612; x += 24) {
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->drawRect({0, 0, 20, 20}, paint);
+                    canvas->restore();
+                }
+            }
+            doc->close();
+        }
+    }
+};
+
+// Stamps the same multi-op picture all over a page, as headers, logos and map symbols do.
+struct PDFRepeatedPictureBench : public Benchmark {
+    sk_sp<SkPicture> fPicture;
+    const char* onGetName() final { return "PDFPicture_repeated"; }
+    bool isSuitableFor(Backend b) final { return b == Backend::kNonRendering; }
+    void onDelayedSetup() final {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(20, 20));
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 8; ++i) {
+            paint.setColor(SkColorSetARGB(0xFF, 0x20 * i, 0xFF - 0x20 * i, 0x80));
+            canvas->drawCircle(10, 10, 10 - i, paint);
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+    }
+    void onDraw(int loops, SkCanvas*) final {
+        SkASSERT(fPicture);
+        while (loops-- > 0) {
+            SkNullWStream stream;
+            auto doc = SkPDF::MakeDocument(&stream);
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            for (int y = 0; y < 792; y += 24) {
+                for (int x = 0; x < 612; x += 24) {
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->drawPicture(fPicture);
+                    canvas->restore();
+                }
+            }
+            doc->close();
+        }
+    }
+};
+
 struct WritePDFTextBenchmark : public Benchmark {
     std::unique_ptr<SkWStream> fWStream;
     WritePDFTextBenchmark() : fWStream(new SkNullWStream) {}
@@ -307,11 +402,20 @@ struct PDFClipPathBenchmark : public Benchmark {
 };
 
 }  // namespace
-DEF_BENCH(return new PDFImageBench;)
+DEF_BENCH(return new PDFImageBench("PDFImage", "images/color_wheel.png",
+                                   PDFImageBench::Source::kDecoded);)
+DEF_BENCH(return new PDFImageBench("PDFImage_photo", "images/mandrill_512.png",
+                                   PDFImageBench::Source::kDecoded);)
+DEF_BENCH(return new PDFImageBench("PDFImage_photo_jpeg", "images/mandrill_512.png",
+                                   PDFImageBench::Source::kDecoded, 75);)
+DEF_BENCH(return new PDFImageBench("PDFImage_png_passthrough", "images/mandrill_512.png",
+                                   PDFImageBench::Source::kEncoded);)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
+DEF_BENCH(return new PDFRepeatedShaderBench;)
+DEF_BENCH(return new PDFRepeatedPictureBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
 
@@ -51,9 +51,11 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
-DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data)
+DeserializePictureBench::DeserializePictureBench(const char* name, sk_sp<SkData> data,
+                                                 bool shareSourceData)
     : fName(name)
     , fEncodedPicture(std::move(data))
+    , fShareSourceData(shareSourceData)
 {}
 
 const char* DeserializePictureBench::onGetName() {
@@ -69,7 +71,9 @@ SkISize DeserializePictureBench::onGetSize() {
 }
 
 void DeserializePictureBench::onDraw(int loops, SkCanvas*) {
+    SkDeserialProcs procs;
+    procs.fShareSourceData = fShareSourceData;
     for (int i = 0; i < loops; ++i) {
-        SkPicture::MakeFromData(fEncodedPicture.get());
+        SkPicture::MakeFromData(fEncodedPicture.get(), &procs);
     }
 }
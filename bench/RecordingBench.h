@@ -42,7 +42,9 @@ private:
 
 class DeserializePictureBench : public Benchmark {
 public:
-    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture);
+    // If shareSourceData, the pictures reference encodedPicture rather than copying from it.
+    DeserializePictureBench(const char* name, sk_sp<SkData> encodedPicture,
+                            bool shareSourceData = false);
 
 protected:
     const char* onGetName() override;
@@ -53,6 +55,7 @@ protected:
 private:
     SkString      fName;
     sk_sp<SkData> fEncodedPicture;
+    bool          fShareSourceData;
 
     using INHERITED = Benchmark;
 };
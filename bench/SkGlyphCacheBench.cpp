@@ -10,17 +10,23 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkGraphics.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/chromium/SkChromeRemoteGlyphCache.h"
 #include "src/base/SkTLazy.h"
+#include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkStrikeStore.h"
 #include "src/core/SkTaskGroup.h"
 #include "tools/Resources.h"
 #include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 #include "tools/text/SkTextBlobTrace.h"
+#include <vector>
 
 using namespace skia_private;
 
@@ -122,6 +128,191 @@ DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
 
+// Renders text on `threads` threads at once with a cold glyph cache, so nearly all of the time is
+// spent generating glyph images. Every thread generates the same number of glyphs, so the time
+// per loop shows how glyph generation scales with the thread count.
+class SkGlyphGenerationMTBench : public Benchmark {
+public:
+    explicit SkGlyphGenerationMTBench(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphGenerationMT_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fTypeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+        if (!fTypeface) {
+            fTypeface = ToolUtils::DefaultPortableTypeface();
+        }
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr int kSizesPerThread = 8;
+        for (int work = 0; work < loops; work++) {
+            SkGraphics::PurgeFontCache();
+            SkTaskGroup(*fExecutor).batch(fThreads, [&](int threadIndex) {
+                SkFont font(fTypeface);
+                font.setEdging(SkFont::Edging::kAntiAlias);
+                font.setSubpixel(true);
+                SkPaint defaultPaint;
+                for (int i = 0; i < kSizesPerThread; i++) {
+                    // Each thread gets its own sizes, so every strike is generated exactly once.
+                    font.setSize(8 + threadIndex * kSizesPerThread + i);
+                    auto strikeSpec = SkStrikeSpec::MakeMask(
+                            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                            SkScalerContextFlags::kNone, SkMatrix::I());
+                    SkPackedGlyphID glyphs['z'];
+                    for (int c = ' '; c < 'z'; c++) {
+                        glyphs[c] = SkPackedGlyphID{font.unicharToGlyph(c)};
+                    }
+                    constexpr size_t glyphCount = 'z' - ' ';
+                    SkBulkGlyphMetricsAndImages images{strikeSpec};
+                    (void)images.glyphs({&glyphs[SkTo<int>(' ')], glyphCount});
+                }
+            });
+        }
+    }
+
+private:
+    const int fThreads;
+    SkString fName;
+    sk_sp<SkTypeface> fTypeface;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new SkGlyphGenerationMTBench(1); )
+DEF_BENCH( return new SkGlyphGenerationMTBench(4); )
+DEF_BENCH( return new SkGlyphGenerationMTBench(16); )
+DEF_BENCH( return new SkGlyphGenerationMTBench(32); )
+
+// Many threads looking up the same few hot strikes, as when every raster thread draws the same UI
+// text. Measures the cost of the strike cache's locking rather than glyph generation.
+class SkStrikeCacheContentionBench : public Benchmark {
+public:
+    explicit SkStrikeCacheContentionBench(int threads) : fThreads(threads) {
+        fName.printf("SkStrikeCacheContention_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        SkFont font = ToolUtils::DefaultFont();
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+        font.setTypeface(ToolUtils::CreatePortableTypeface("serif", SkFontStyle::Normal()));
+        SkPaint defaultPaint;
+        for (int i = 0; i < kStrikeCount; i++) {
+            font.setSize(10 + i);
+            fStrikeSpecs.push_back(SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I()));
+        }
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr int kLookupsPerThread = 1000;
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup(*fExecutor).batch(fThreads, [&](int threadIndex) {
+                for (int i = 0; i < kLookupsPerThread; i++) {
+                    const SkStrikeSpec& spec = fStrikeSpecs[(threadIndex + i) % kStrikeCount];
+                    sk_sp<SkStrike> strike = spec.findOrCreateStrike();
+                    (void)strike;
+                }
+            });
+        }
+    }
+
+private:
+    static constexpr int kStrikeCount = 4;
+    const int fThreads;
+    SkString fName;
+    std::vector<SkStrikeSpec> fStrikeSpecs;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new SkStrikeCacheContentionBench(1); )
+DEF_BENCH( return new SkStrikeCacheContentionBench(8); )
+DEF_BENCH( return new SkStrikeCacheContentionBench(32); )
+
+// Cold start text: a new process draws its first frame of text with an empty strike cache, either
+// rasterizing every glyph or reading them from a strike store written by an earlier process.
+class SkStrikeStoreColdStartBench : public Benchmark {
+public:
+    explicit SkStrikeStoreColdStartBench(bool useStore) : fUseStore(useStore) {}
+
+protected:
+    const char* onGetName() override {
+        return fUseStore ? "SkStrikeStoreColdStart_store" : "SkStrikeStoreColdStart_rasterize";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fTypeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+        if (!fTypeface) {
+            fTypeface = ToolUtils::DefaultPortableTypeface();
+        }
+        SkStrikeCache cache;
+        this->drawFirstFrame(&cache);
+        SkDynamicMemoryWStream stream;
+        if (SkStrikeStore::Write(&cache, &stream)) {
+            fStore = SkStrikeStore::MakeFromData(stream.detachAsData());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkStrikeCache cache;
+            if (fUseStore) {
+                cache.setStrikeStore(fStore);
+            }
+            this->drawFirstFrame(&cache);
+        }
+    }
+
+private:
+    void drawFirstFrame(SkStrikeCache* cache) {
+        SkFont font(fTypeface);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        SkPaint defaultPaint;
+        SkPackedGlyphID glyphs['z'];
+        const SkGlyph* results['z'];
+        for (SkScalar size = 10; size <= 24; size += 2) {
+            font.setSize(size);
+            auto strikeSpec = SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I());
+            for (int c = ' '; c < 'z'; c++) {
+                glyphs[c] = SkPackedGlyphID{font.unicharToGlyph(c)};
+            }
+            constexpr size_t glyphCount = 'z' - ' ';
+            sk_sp<SkStrike> strike = strikeSpec.findOrCreateStrike(cache);
+            strike->prepareImages({&glyphs[SkTo<int>(' ')], glyphCount}, results);
+        }
+    }
+
+    const bool fUseStore;
+    sk_sp<SkTypeface> fTypeface;
+    sk_sp<SkStrikeStore> fStore;
+};
+
+DEF_BENCH( return new SkStrikeStoreColdStartBench(false); )
+DEF_BENCH( return new SkStrikeStoreColdStartBench(true); )
+
 namespace {
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
                            public SkStrikeClient::DiscardableHandleManager {
@@ -7,18 +7,25 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkStrikeCache.h"
 #include "tools/Resources.h"
 #include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <memory>
+#include <vector>
+
 /*
  * A trivial test which benchmarks the performance of a textblob with a single run.
  */
@@ -109,3 +116,102 @@ class TextBlobMakeBench : public SkTextBlobBench {
     }
 };
 DEF_BENCH( return new TextBlobMakeBench(); )
+
+/*
+ * Rasterizes a paragraph of small glyphs as a single run into a raster surface, so the time is
+ * dominated by compositing the glyph masks.
+ */
+class TextBlobRasterBench : public SkTextBlobBench {
+public:
+    explicit TextBlobRasterBench(SkAlpha alpha) : fAlpha(alpha) {
+        fName.printf("TextBlobRasterBench_%s", alpha == 0xFF ? "opaque" : "translucent");
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kRaster; }
+
+    void onDelayedSetup() override {
+        SkFont font(ToolUtils::CreatePortableTypeface("serif", SkFontStyle()), 11);
+        font.setSubpixel(true);
+        const char* text = "Keep your sentences short, but not overly so.";
+        const int count = font.countText(text, strlen(text), SkTextEncoding::kUTF8);
+        skia_private::AutoTArray<SkGlyphID> glyphs(count);
+        skia_private::AutoTArray<SkScalar> xpos(count);
+        font.textToGlyphs(text, strlen(text), SkTextEncoding::kUTF8, glyphs.get(), count);
+        font.getXPos(glyphs.get(), count, xpos.get());
+
+        constexpr int kLines = 40;
+        SkTextBlobBuilder builder;
+        const SkTextBlobBuilder::RunBuffer& run = builder.allocRunPos(font, count * kLines);
+        for (int line = 0; line < kLines; ++line) {
+            for (int i = 0; i < count; ++i) {
+                run.glyphs[line * count + i] = glyphs[i];
+                run.points()[line * count + i] = SkPoint::Make(4 + xpos[i], 12.f + 12 * line);
+            }
+        }
+        fBlob = builder.make();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAlpha(fAlpha);
+        for (int i = 0; i < loops * 10; i++) {
+            canvas->drawTextBlob(fBlob, 0, 0, paint);
+        }
+    }
+
+    SkString          fName;
+    SkAlpha           fAlpha;
+    sk_sp<SkTextBlob> fBlob;
+};
+DEF_BENCH( return new TextBlobRasterBench(0xFF); )
+DEF_BENCH( return new TextBlobRasterBench(0x80); )
+
+/*
+ * Generates, from an empty strike cache, the glyphs for a page of text in many sizes, as a first
+ * frame would, either on this thread or spread over a thread pool by SkStrikeCache::PrewarmTextBlobs.
+ */
+class TextBlobPrewarmBench : public Benchmark {
+public:
+    explicit TextBlobPrewarmBench(int threads) : fThreads(threads) {
+        fName.printf("TextBlobPrewarmBench_%s", threads > 0 ? "parallel" : "serial");
+    }
+
+private:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        const char* text = "The quick brown fox jumps over the lazy dog. 0123456789 !?&%$#@";
+        SkFont font(ToolUtils::CreatePortableTypeface("serif", SkFontStyle()));
+        font.setSubpixel(true);
+        for (int size = 9; size <= 40; ++size) {
+            font.setSize(size);
+            fBlobs.push_back(SkTextBlob::MakeFromString(text, font));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+        const SkImageInfo dstInfo = SkImageInfo::MakeN32Premul(1024, 1024);
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            SkStrikeCache::PurgeAll();
+            SkStrikeCache::PrewarmTextBlobs(
+                    fBlobs, paint, SkMatrix::I(), dstInfo, props, fExecutor.get());
+        }
+    }
+
+    SkString                       fName;
+    const int                      fThreads;
+    std::unique_ptr<SkExecutor>    fExecutor;
+    std::vector<sk_sp<SkTextBlob>> fBlobs;
+};
+DEF_BENCH( return new TextBlobPrewarmBench(0); )
+DEF_BENCH( return new TextBlobPrewarmBench(4); )
@@ -74,6 +74,7 @@ using namespace skia_private;
 extern bool gSkForceRasterPipelineBlitter;
 extern bool gForceHighPrecisionRasterPipeline;
 extern bool gCreateProtectedContext;
+extern bool gSkUseMSDFText;
 
 static DEFINE_string(src, "tests gm skp mskp lottie rive svg image colorImage",
                      "Source types to test.");
@@ -109,6 +110,7 @@ static DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp
 static DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
 static DEFINE_bool(forceRasterPipelineHP, false, "sets gSkForceRasterPipelineBlitter and gForceHighPrecisionRasterPipeline");
 static DEFINE_bool(createProtected, false, "attempts to create a protected backend context");
+static DEFINE_bool(msdfText, false, "sets gSkUseMSDFText");
 
 static DEFINE_string(bisect, "",
         "Pair of: SKP file to bisect, followed by an l/r bisect trail string (e.g., 'lrll'). The "
@@ -1555,6 +1557,7 @@ int main(int argc, char** argv) {
     gSkForceRasterPipelineBlitter     = FLAGS_forceRasterPipelineHP || FLAGS_forceRasterPipeline;
     gForceHighPrecisionRasterPipeline = FLAGS_forceRasterPipelineHP;
     gCreateProtectedContext           = FLAGS_createProtected;
+    gSkUseMSDFText                    = FLAGS_msdfText;
 
     // The bots like having a verbose.log to upload, so always touch the file even if --verbose.
     if (!FLAGS_writePath.isEmpty()) {
@@ -16,9 +16,11 @@
 #include <memory>
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkOpenTypeSVGDecoder;
 class SkTraceMemoryDump;
+struct SkIRect;
 
 class SK_API SkGraphics {
 public:
@@ -69,6 +71,20 @@ public:
      */
     static int SetFontCacheCountLimit(int count);
 
+    /**
+     *  Use the glyphs stored in the file at path by an earlier WriteFontCacheStore(), which is
+     *  memory mapped, for strikes created from now on, instead of rasterizing them again.
+     *  Passing nullptr stops using any store. Returns false if the file is missing or was not
+     *  written by this version of Skia.
+     */
+    static bool SetFontCacheStore(const char path[]);
+
+    /**
+     *  Write the metrics, masks and paths of the glyphs currently in the font cache to the file
+     *  at path, keyed by font file contents, for SetFontCacheStore() in a later process.
+     */
+    static bool WriteFontCacheStore(const char path[]);
+
     /**
      *  Return the current limit to the number of entries in the typeface cache.
      *  A cache "entry" is associated with each typeface.
@@ -126,6 +142,49 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  These functions get/set the memory usage limit for the cache of blurred round rect masks
+     *  that the CPU backend stretches over round rects drawn with a blur mask filter. The masks
+     *  only depend on the corners and the blur, so they are shared by round rects of every size.
+     *  Set returns the previous limit.
+     */
+    static size_t GetBlurNinePatchCacheLimit();
+    static size_t SetBlurNinePatchCacheLimit(size_t bytes);
+
+    /**
+     *  Split the blurs that CPU image filters compute into bands of rows and columns that run on
+     *  executor's threads. The executor must outlive its use; nullptr, the default, blurs on the
+     *  calling thread. The blurred pixels are the same either way.
+     */
+    static void SetRasterBlurExecutor(SkExecutor* executor);
+
+    /**
+     *  Evaluate the independent inputs of CPU image filters (e.g. the inputs of a merge or blend
+     *  filter) concurrently on executor's threads, starting no more at once than are expected to
+     *  need inFlightByteLimit bytes of intermediate images. The executor must outlive its use;
+     *  nullptr, the default, evaluates the inputs one after another on the calling thread.
+     */
+    static void SetImageFilterExecutor(SkExecutor* executor,
+                                       size_t inFlightByteLimit = 64 * 1024 * 1024);
+
+    /**
+     *  Let the cache of CPU image filter results serve a request from a result that was computed
+     *  for another region of the layer, or before the layer was scrolled by whole pixels, when
+     *  that result covers the request, or all of it but one strip along an edge. Only the strip is
+     *  then filtered again. Off by default.
+     */
+    static void SetImageFilterCacheReuseOverlapping(bool reuseOverlapping);
+
+    /**
+     *  Tell the cache of CPU image filter results that the image with uniqueID() 'currentID' has
+     *  the same pixels as the one with 'previousID', except within 'damage' in their pixel
+     *  coordinates, as with successive frames of an animation. When the current image is filtered
+     *  with the same filter, matrix and clip that the previous one was, only the output that reads
+     *  the damaged pixels is filtered again, and patched into the previous result.
+     */
+    static void SetImageFilterSourceDamage(uint32_t previousID, uint32_t currentID,
+                                           const SkIRect& damage);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -70,6 +70,9 @@ public:
         may be used to provide user context to procs->fPictureProc; procs->fPictureProc
         is called with a pointer to data, data byte length, and user context.
 
+        If procs->fShareSourceData is true, the picture's encoded images reference
+        data in place and keep it alive, rather than copying their bytes.
+
         @param data   container for serial data
         @param procs  custom serial data decoders; may be nullptr
         @return       SkPicture constructed from data
@@ -112,6 +112,13 @@ struct SK_API SkDeserialProcs {
     // parameters and returns a bool). Given that there are only two valid implementations of that
     // proc, we just insert the bool directly.
     bool                         fAllowSkSL = true;
+
+    // If true, a picture read from an SkData, or from a stream over one (like the memory mapped
+    // file SkStream::MakeFromFile returns), references that data instead of copying out of it
+    // where it can: its encoded images share their bytes in place, and keep the data alive as
+    // long as they are. Only set this if the data owns its memory, i.e. it was not made with
+    // SkData::MakeWithoutCopy. SkPicture::MakeFromData(const void*, size_t) always copies.
+    bool                         fShareSourceData = false;
 };
 
 #endif
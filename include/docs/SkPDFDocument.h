@@ -148,6 +148,14 @@ struct Metadata {
     */
     int fEncodingQuality = 101;
 
+    /** Large opaque images that look photographic (most of their pixels have distinct
+        colors) compress poorly and slowly with lossless encoding. If this value is set to a
+        value <= 100, such images are encoded (using JPEG) with that quality setting even when
+        fEncodingQuality asks for lossless encoding. By default this is set to 101 percent,
+        which leaves them lossless.
+    */
+    int fPhotographicEncodingQuality = 101;
+
     /** An optional tree of structured document tags that provide
         a semantic representation of the content. The caller
         should retain ownership.
@@ -18,4 +18,10 @@ class SkFontMgr;
  */
 SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir);
 
+/** Like SkFontMgr_New_Custom_Directory(dir), but keeps an index of the fonts found at indexPath.
+ *  Font files whose size and modification time match their index entry are not opened until
+ *  they are used, and the index is rewritten when files are added, changed or removed.
+ */
+SK_API sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath);
+
 #endif // SkFontMgr_directory_DEFINED
@@ -2,17 +2,22 @@
 // Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
 
 #if !defined(SK_BUILD_FOR_ANDROID_FRAMEWORK) && !defined(SK_BUILD_FOR_GOOGLE3)
 
 #include "modules/skparagraph/include/FontCollection.h"
 #include "modules/skparagraph/include/Paragraph.h"
+#include "modules/skparagraph/include/ShapedRunCache.h"
 #include "modules/skparagraph/src/ParagraphBuilderImpl.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
 #include "tools/Resources.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <memory>
+#include <vector>
 #include "include/core/SkPictureRecorder.h"
 #include "modules/skparagraph/utils/TestFontCollection.h"
 
@@ -54,8 +59,123 @@ struct ParagraphBench : public Benchmark {
         }
     }
 };
+
+// Lays out the text again after changing one word each time, as an editor would, with and without
+// a ShapedRunCache. The long document repeats the text, so most of its words are already cached.
+struct ParagraphEditBench : public Benchmark {
+    ParagraphEditBench(bool cacheRuns, int repeats) : fCacheRuns(cacheRuns), fRepeats(repeats) {
+        if (repeats > 1) {
+            fName = cacheRuns ? "paragraph_edit_long_cached_runs" : "paragraph_edit_long";
+        } else {
+            fName = cacheRuns ? "paragraph_edit_cached_runs" : "paragraph_edit";
+        }
+    }
+    SkString fText;
+    sk_sp<FontCollection> fFontCollection;
+    const char* fName;
+    bool fCacheRuns;
+    int fRepeats;
+    const char* onGetName() override { return fName; }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData("text/english.txt");
+        if (!data) {
+            return;
+        }
+        // The edited word is replaced in place, so it is kept to the first line of the text.
+        const SkString text((const char*)data->data(), std::min<size_t>(data->size(), 2000));
+        for (int i = 0; i < fRepeats; ++i) {
+            fText.append(text);
+        }
+        fFontCollection = sk_make_sp<FontCollection>();
+        fFontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+        fFontCollection->getParagraphCache()->turnOn(false);
+        if (fCacheRuns) {
+            fFontCollection->setShapedRunCache(sk_make_sp<ShapedRunCache>());
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (fText.isEmpty()) {
+            return;
+        }
+
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        for (int i = 0; i < loops; ++i) {
+            fText[fText.size() / 2] = 'a' + i % 26;
+            ParagraphBuilderImpl builder(paragraph_style, fFontCollection);
+            builder.addText(fText.c_str(), fText.size());
+            auto paragraph = builder.Build();
+            paragraph->layout(500);
+        }
+    }
+};
+
+// Lays out the lines of the text as separate paragraphs, one after another or with
+// Paragraph::Layout on a thread pool.
+struct ParagraphBatchBench : public Benchmark {
+    ParagraphBatchBench(bool parallel) : fParallel(parallel) {
+        fName = parallel ? "paragraph_batch_parallel" : "paragraph_batch_serial";
+    }
+    std::vector<SkString> fLines;
+    std::unique_ptr<SkExecutor> fExecutor;
+    const char* fName;
+    bool fParallel;
+    const char* onGetName() override { return fName; }
+    bool isSuitableFor(Backend backend) override { return backend == Backend::kNonRendering; }
+    void onDelayedSetup() override {
+        sk_sp<SkData> data = GetResourceAsData("text/english.txt");
+        if (!data) {
+            return;
+        }
+        const char* text = (const char*)data->data();
+        const char* end = text + data->size();
+        while (text < end) {
+            const char* newline = std::find(text, end, '\n');
+            if (newline > text) {
+                fLines.emplace_back(text, newline - text);
+            }
+            text = newline + 1;
+        }
+        if (fParallel) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (fLines.empty()) {
+            return;
+        }
+
+        auto fontCollection = sk_make_sp<FontCollection>();
+        fontCollection->setDefaultFontManager(ToolUtils::TestFontMgr());
+        fontCollection->getParagraphCache()->turnOn(false);
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        std::vector<std::unique_ptr<Paragraph>> paragraphs;
+        std::vector<Paragraph*> batch;
+        for (const SkString& line : fLines) {
+            ParagraphBuilderImpl builder(paragraph_style, fontCollection);
+            builder.addText(line.c_str(), line.size());
+            paragraphs.push_back(builder.Build());
+            batch.push_back(paragraphs.back().get());
+        }
+        while (loops-- > 0) {
+            for (Paragraph* paragraph : batch) {
+                paragraph->markDirty();
+            }
+            Paragraph::Layout(batch, 500, fExecutor.get());
+        }
+    }
+};
 }  // namespace
 
+DEF_BENCH(return new ParagraphBatchBench(false);)
+DEF_BENCH(return new ParagraphBatchBench(true);)
+DEF_BENCH(return new ParagraphEditBench(false, 1);)
+DEF_BENCH(return new ParagraphEditBench(true, 1);)
+DEF_BENCH(return new ParagraphEditBench(false, 50);)
+DEF_BENCH(return new ParagraphEditBench(true, 50);)
+
 #define PARAGRAPH_BENCH(X) DEF_BENCH(return new ParagraphBench(50000, "text/" #X ".txt", "paragraph_" #X);)
 //PARAGRAPH_BENCH(arabic)
 //PARAGRAPH_BENCH(emoji)
@@ -8,8 +8,11 @@
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
 #include "modules/skparagraph/include/FontArguments.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
+#include "modules/skparagraph/include/ShapedRunCache.h"
 #include "modules/skparagraph/include/TextStyle.h"
 #include "src/core/SkTHash.h"
 
@@ -46,6 +49,11 @@ public:
 
     ParagraphCache* getParagraphCache() { return &fParagraphCache; }
 
+    // Shape paragraphs word by word through cache, which may be shared with other collections;
+    // see ShapedRunCache. Pass nullptr, the default, to shape whole runs without caching.
+    void setShapedRunCache(sk_sp<ShapedRunCache> cache) { fShapedRunCache = std::move(cache); }
+    ShapedRunCache* getShapedRunCache() { return fShapedRunCache.get(); }
+
     void clearCaches();
 
 private:
@@ -71,7 +79,10 @@ private:
     };
 
     bool fEnableFontFallback;
-    skia_private::THashMap<FamilyKey, std::vector<sk_sp<SkTypeface>>, FamilyKey::Hasher> fTypefaces;
+    // Paragraphs laid out on different threads (see Paragraph::Layout) share the collection.
+    SkMutex fTypefacesMutex;
+    skia_private::THashMap<FamilyKey, std::vector<sk_sp<SkTypeface>>, FamilyKey::Hasher> fTypefaces
+            SK_GUARDED_BY(fTypefacesMutex);
     sk_sp<SkFontMgr> fDefaultFontManager;
     sk_sp<SkFontMgr> fAssetFontManager;
     sk_sp<SkFontMgr> fDynamicFontManager;
@@ -79,6 +90,7 @@ private:
 
     std::vector<SkString> fDefaultFamilyNames;
     ParagraphCache fParagraphCache;
+    sk_sp<ShapedRunCache> fShapedRunCache;
 };
 }  // namespace textlayout
 }  // namespace skia
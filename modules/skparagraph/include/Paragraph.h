@@ -3,6 +3,7 @@
 #define Paragraph_DEFINED
 
 #include "include/core/SkPath.h"
+#include "include/core/SkSpan.h"
 #include "modules/skparagraph/include/FontCollection.h"
 #include "modules/skparagraph/include/Metrics.h"
 #include "modules/skparagraph/include/ParagraphStyle.h"
@@ -10,6 +11,7 @@
 #include <unordered_set>
 
 class SkCanvas;
+class SkExecutor;
 
 namespace skia {
 namespace textlayout {
@@ -41,6 +43,15 @@ public:
 
     virtual void layout(SkScalar width) = 0;
 
+    /* Lays out paragraphs that do not depend on each other, as if layout(width) were called on
+     * each in turn, but spread across the threads of executor.
+     *
+     * @param paragraphs  distinct paragraphs, which may share a FontCollection
+     * @param width       the width each paragraph is laid out to
+     * @param executor    runs the layouts; if nullptr they run on the calling thread
+     */
+    static void Layout(SkSpan<Paragraph* const> paragraphs, SkScalar width, SkExecutor* executor);
+
     virtual void paint(SkCanvas* canvas, SkScalar x, SkScalar y) = 0;
 
     virtual void paint(ParagraphPainter* painter, SkScalar x, SkScalar y) = 0;
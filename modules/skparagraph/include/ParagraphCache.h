@@ -31,7 +31,10 @@ public:
     }
     void printStatistics();
     void turnOn(bool value) { fCacheIsOn = value; }
-    int count() { return fLRUCacheMap.count(); }
+    int count() {
+        SkAutoMutexExclusive lock(fParagraphMutex);
+        return fLRUCacheMap.count();
+    }
 
     bool isPossiblyTextEditing(ParagraphImpl* paragraph);
 
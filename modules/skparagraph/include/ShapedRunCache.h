@@ -0,0 +1,113 @@
+// Copyright 2026 Google LLC.
+#ifndef ShapedRunCache_DEFINED
+#define ShapedRunCache_DEFINED
+
+#include "include/core/SkFont.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "modules/skshaper/include/SkShaper.h"
+#include "src/base/SkTInternalLList.h"
+#include "src/core/SkTHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace skia {
+namespace textlayout {
+
+/**
+ * A cache of shaped words, shared by the paragraphs of every FontCollection it is set on.
+ *
+ * The ParagraphCache only helps when a whole paragraph is laid out again unchanged. With a
+ * ShapedRunCache, left-to-right text is shaped one word (with its trailing spaces) at a time
+ * and each word's glyphs are looked up by its text, font, features, bidi level and locale, so
+ * after an edit only the words that changed go through HarfBuzz again.
+ *
+ * Shaping words separately drops kerning and ligatures across spaces, which fonts rarely have;
+ * the cache is off unless set with FontCollection::setShapedRunCache.
+ */
+class ShapedRunCache : public SkRefCnt {
+public:
+    static constexpr size_t kDefaultByteLimit = 4 * 1024 * 1024;
+
+    explicit ShapedRunCache(size_t byteLimit = kDefaultByteLimit);
+    ~ShapedRunCache() override;
+
+    size_t byteLimit() const;
+    // Evicts the least recently used words until the cache fits.
+    void setByteLimit(size_t byteLimit);
+    size_t bytesUsed() const;
+    int count() const;
+    void reset();
+
+    // How many words were found in, or had to be added to, the cache.
+    int hitCount() const;
+    int missCount() const;
+
+    // One run of glyphs as the shaper produced it for a word.
+    struct ShapedRun {
+        SkFont fFont;
+        uint8_t fBidiLevel;
+        SkVector fAdvance;
+        SkShaper::RunHandler::Range fUtf8Range;  // Relative to the start of the word.
+        std::vector<SkGlyphID> fGlyphs;
+        std::vector<SkPoint> fPositions;         // Relative to the start of the run.
+        std::vector<SkPoint> fOffsets;
+        std::vector<uint32_t> fClusters;         // Relative to the start of the word.
+    };
+    using ShapedRuns = std::vector<ShapedRun>;
+
+private:
+    friend class OneLineShaper;
+
+    struct Key {
+        SkString fText;
+        SkFont fFont;
+        uint8_t fBidiLevel;
+        SkString fLocale;
+        std::vector<SkShaper::Feature> fFeatures;  // Relative to the start of the word.
+
+        bool operator==(const Key& other) const;
+        uint32_t hash() const;
+    };
+
+    struct Entry {
+        Entry(Key key, std::shared_ptr<const ShapedRuns> runs);
+
+        Key fKey;
+        std::shared_ptr<const ShapedRuns> fRuns;
+        size_t fBytes;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    struct Traits {
+        static const Key& GetKey(const Entry* entry) { return entry->fKey; }
+        static uint32_t Hash(const Key& key) { return key.hash(); }
+    };
+
+    // Returns the runs for key, or nullptr if it has not been added.
+    std::shared_ptr<const ShapedRuns> find(const Key& key) SK_EXCLUDES(fMutex);
+    void add(Key key, std::shared_ptr<const ShapedRuns> runs) SK_EXCLUDES(fMutex);
+
+    void purge() SK_REQUIRES(fMutex);
+
+    mutable SkMutex fMutex;
+    skia_private::THashTable<Entry*, Key, Traits> fEntries SK_GUARDED_BY(fMutex);
+    SkTInternalLList<Entry> fLRU SK_GUARDED_BY(fMutex);
+    size_t fByteLimit SK_GUARDED_BY(fMutex);
+    size_t fBytesUsed SK_GUARDED_BY(fMutex) = 0;
+    int fHitCount SK_GUARDED_BY(fMutex) = 0;
+    int fMissCount SK_GUARDED_BY(fMutex) = 0;
+};
+
+}  // namespace textlayout
+}  // namespace skia
+
+#endif  // ShapedRunCache_DEFINED
@@ -7,7 +7,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 using namespace skia_private;
 
@@ -697,10 +700,15 @@ bool OneLineShaper::shape() {
                         }
                     }
 
-                    shaper->shape(unresolvedText.begin(), unresolvedText.size(),
-                            fontIter, bidiIter,*scriptIter, langIter,
-                            adjustedFeatures.data(), adjustedFeatures.size(),
-                            limitlessWidth, this);
+                    ShapedRunCache* runCache = fParagraph->fFontCollection->getShapedRunCache();
+                    if (runCache == nullptr ||
+                        !this->shapeByWords(runCache, *shaper, unresolvedText, font,
+                                            defaultBidiLevel, blockSpan, adjustedFeatures)) {
+                        shaper->shape(unresolvedText.begin(), unresolvedText.size(),
+                                fontIter, bidiIter,*scriptIter, langIter,
+                                adjustedFeatures.data(), adjustedFeatures.size(),
+                                limitlessWidth, this);
+                    }
 
                     // Take off the queue the block we tried to resolved -
                     // whatever happened, we have now smaller pieces of it to deal with
@@ -727,6 +735,151 @@ bool OneLineShaper::shape() {
     return result;
 }
 
+namespace {
+// Keeps the runs the shaper produces for a word, for the ShapedRunCache.
+class ShapedRunRecorder final : public SkShaper::RunHandler {
+public:
+    explicit ShapedRunRecorder(ShapedRunCache::ShapedRuns* runs) : fRuns(runs) {}
+
+private:
+    void beginLine() override {}
+    void runInfo(const RunInfo&) override {}
+    void commitRunInfo() override {}
+    void commitLine() override {}
+
+    Buffer runBuffer(const RunInfo& info) override {
+        fRuns->push_back({info.fFont, info.fBidiLevel, info.fAdvance, info.utf8Range,
+                          {}, {}, {}, {}});
+        ShapedRunCache::ShapedRun& run = fRuns->back();
+        run.fGlyphs.resize(info.glyphCount);
+        run.fPositions.resize(info.glyphCount);
+        run.fOffsets.resize(info.glyphCount);
+        run.fClusters.resize(info.glyphCount);
+        return {run.fGlyphs.data(), run.fPositions.data(), run.fOffsets.data(),
+                run.fClusters.data(), {0, 0}};
+    }
+
+    void commitRunBuffer(const RunInfo&) override {}
+
+    ShapedRunCache::ShapedRuns* fRuns;
+};
+}  // namespace
+
+bool OneLineShaper::shapeByWords(ShapedRunCache* cache,
+                                 const SkShaper& shaper,
+                                 SkSpan<const char> text,
+                                 const SkFont& font,
+                                 uint8_t bidiLevel,
+                                 SkSpan<Block> blockSpan,
+                                 SkSpan<const SkShaper::Feature> features) {
+    // Right to left words would have to be put together in reverse.
+    if (text.empty() || (bidiLevel & 1)) {
+        return false;
+    }
+    // Words are looked up by a single locale, so text in several languages is shaped whole.
+    const SkString& locale = blockSpan.front().fStyle.getLocale();
+    for (const Block& block : blockSpan) {
+        if (block.fStyle.getLocale() != locale) {
+            return false;
+        }
+    }
+
+    // A word ends after the spaces that follow it.
+    struct Word {
+        size_t fStart;
+        std::shared_ptr<const ShapedRunCache::ShapedRuns> fRuns;
+    };
+    std::vector<Word> words;
+    size_t wordStart = 0;
+    for (size_t i = 1; i <= text.size(); ++i) {
+        if (i < text.size() && !(text[i - 1] == ' ' && text[i] != ' ')) {
+            continue;
+        }
+        SkSpan<const char> wordText = text.subspan(wordStart, i - wordStart);
+        ShapedRunCache::Key key{SkString(wordText.data(), wordText.size()),
+                                font,
+                                bidiLevel,
+                                locale,
+                                {}};
+        for (const SkShaper::Feature& feature : features) {
+            if (feature.start < i && feature.end > wordStart) {
+                key.fFeatures.push_back({feature.tag,
+                                         feature.value,
+                                         std::max(feature.start, wordStart) - wordStart,
+                                         std::min(feature.end, i) - wordStart});
+            }
+        }
+
+        std::shared_ptr<const ShapedRunCache::ShapedRuns> runs = cache->find(key);
+        if (runs == nullptr) {
+            auto shaped = std::make_shared<ShapedRunCache::ShapedRuns>();
+            SkShaper::TrivialFontRunIterator fontIter(font, wordText.size());
+            SkShaper::TrivialLanguageRunIterator langIter(locale.c_str(), wordText.size());
+            SkShaper::TrivialBiDiRunIterator bidiIter(bidiLevel, wordText.size());
+            auto scriptIter = SkShapers::HB::ScriptRunIterator(wordText.begin(), wordText.size());
+            ShapedRunRecorder recorder(shaped.get());
+            shaper.shape(wordText.begin(), wordText.size(),
+                         fontIter, bidiIter, *scriptIter, langIter,
+                         key.fFeatures.data(), key.fFeatures.size(),
+                         std::numeric_limits<SkScalar>::max(), &recorder);
+            runs = shaped;
+            cache->add(std::move(key), std::move(shaped));
+        }
+        words.push_back({wordStart, std::move(runs)});
+        wordStart = i;
+    }
+
+    // Join the runs of consecutive words that have the same font and level, so the text comes
+    // out in as few runs as when it is shaped whole.
+    struct Piece {
+        size_t fWordStart;
+        const ShapedRunCache::ShapedRun* fRun;
+    };
+    std::vector<Piece> pieces;
+    for (const Word& word : words) {
+        for (const ShapedRunCache::ShapedRun& run : *word.fRuns) {
+            pieces.push_back({word.fStart, &run});
+        }
+    }
+    for (size_t first = 0, last; first < pieces.size(); first = last) {
+        const ShapedRunCache::ShapedRun& firstRun = *pieces[first].fRun;
+        SkVector advance = firstRun.fAdvance;
+        size_t glyphCount = firstRun.fGlyphs.size();
+        for (last = first + 1; last < pieces.size(); ++last) {
+            const ShapedRunCache::ShapedRun& run = *pieces[last].fRun;
+            if (run.fFont != firstRun.fFont || run.fBidiLevel != firstRun.fBidiLevel) {
+                break;
+            }
+            advance += run.fAdvance;
+            glyphCount += run.fGlyphs.size();
+        }
+        const size_t utf8Begin = pieces[first].fWordStart + firstRun.fUtf8Range.begin();
+        const Piece& lastPiece = pieces[last - 1];
+        const size_t utf8End = lastPiece.fWordStart + lastPiece.fRun->fUtf8Range.end();
+        const RunInfo info = {firstRun.fFont,
+                              firstRun.fBidiLevel,
+                              advance,
+                              glyphCount,
+                              SkShaper::RunHandler::Range(utf8Begin, utf8End - utf8Begin)};
+
+        const Buffer buffer = this->runBuffer(info);
+        SkVector runStart = buffer.point;
+        size_t glyph = 0;
+        for (size_t p = first; p < last; ++p) {
+            const ShapedRunCache::ShapedRun& run = *pieces[p].fRun;
+            for (size_t i = 0; i < run.fGlyphs.size(); ++i, ++glyph) {
+                buffer.glyphs[glyph] = run.fGlyphs[i];
+                buffer.positions[glyph] = runStart + run.fPositions[i];
+                buffer.offsets[glyph] = run.fOffsets[i];
+                buffer.clusters[glyph] = SkToU32(pieces[p].fWordStart + run.fClusters[i]);
+            }
+            runStart += run.fAdvance;
+        }
+        this->commitRunBuffer(info);
+    }
+    return true;
+}
+
 // When we extend TextRange to the grapheme edges, we also extend glyphs range
 TextRange OneLineShaper::clusteredText(GlyphRange& glyphs) {
 
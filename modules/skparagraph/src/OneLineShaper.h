@@ -5,6 +5,7 @@
 #include <functional>  // std::function
 #include <queue>
 #include "include/core/SkSpan.h"
+#include "modules/skparagraph/include/ShapedRunCache.h"
 #include "modules/skparagraph/include/TextStyle.h"
 #include "modules/skparagraph/src/ParagraphImpl.h"
 #include "modules/skparagraph/src/Run.h"
@@ -83,6 +84,17 @@ private:
 #endif
     void finish(const Block& block, SkScalar height, SkScalar& advanceX);
 
+    // Shape text, which starts at fCurrentText.start, one word at a time through cache, and
+    // pass the runs on to this handler as if the shaper had shaped the whole text. Returns
+    // false, having done nothing, if the text can't be shaped by words.
+    bool shapeByWords(ShapedRunCache* cache,
+                      const SkShaper& shaper,
+                      SkSpan<const char> text,
+                      const SkFont& font,
+                      uint8_t bidiLevel,
+                      SkSpan<Block> blockSpan,
+                      SkSpan<const SkShaper::Feature> features);
+
     void beginLine() override {}
     void runInfo(const RunInfo&) override {}
     void commitRunInfo() override {}
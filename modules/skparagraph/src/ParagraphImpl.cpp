@@ -21,6 +21,7 @@
 #include "modules/skparagraph/src/TextWrapper.h"
 #include "modules/skunicode/include/SkUnicode.h"
 #include "src/base/SkUTF.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 
 #include <algorithm>
@@ -70,6 +71,22 @@ Paragraph::Paragraph(ParagraphStyle style, sk_sp<FontCollection> fonts)
     SkASSERT(fFontCollection);
 }
 
+void Paragraph::Layout(SkSpan<Paragraph* const> paragraphs, SkScalar width,
+                       SkExecutor* executor) {
+    if (!executor || paragraphs.size() < 2) {
+        for (Paragraph* paragraph : paragraphs) {
+            paragraph->layout(width);
+        }
+        return;
+    }
+    // Each paragraph is shaped and wrapped on its own; the FontCollection caches they share
+    // are locked only to look up or store a result.
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(SkToInt(paragraphs.size()), [&](int i) {
+        paragraphs[i]->layout(width);
+    });
+}
+
 ParagraphImpl::ParagraphImpl(const SkString& text,
                              ParagraphStyle style,
                              TArray<Block, true> blocks,
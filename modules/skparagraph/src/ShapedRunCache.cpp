@@ -0,0 +1,148 @@
+// Copyright 2026 Google LLC.
+#include "modules/skparagraph/include/ShapedRunCache.h"
+
+#include "include/core/SkTypeface.h"
+#include "src/base/SkFloatBits.h"
+#include "src/core/SkChecksum.h"
+
+#include <utility>
+
+namespace skia {
+namespace textlayout {
+
+bool ShapedRunCache::Key::operator==(const Key& other) const {
+    if (fText != other.fText || fFont != other.fFont || fBidiLevel != other.fBidiLevel ||
+        fLocale != other.fLocale || fFeatures.size() != other.fFeatures.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < fFeatures.size(); ++i) {
+        const SkShaper::Feature& a = fFeatures[i];
+        const SkShaper::Feature& b = other.fFeatures[i];
+        if (a.tag != b.tag || a.value != b.value || a.start != b.start || a.end != b.end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t ShapedRunCache::Key::hash() const {
+    uint32_t hash = SkChecksum::Hash32(fText.c_str(), fText.size());
+    const uint32_t font[] = {
+        fFont.getTypeface() ? fFont.getTypeface()->uniqueID() : 0,
+        SkFloat2Bits(fFont.getSize()),
+        SkFloat2Bits(fFont.getScaleX()),
+        SkFloat2Bits(fFont.getSkewX()),
+        static_cast<uint32_t>(fFont.isEmbolden()) |
+                static_cast<uint32_t>(fFont.isSubpixel()) << 1 |
+                static_cast<uint32_t>(fFont.getEdging()) << 2 |
+                static_cast<uint32_t>(fFont.getHinting()) << 4,
+        fBidiLevel,
+    };
+    hash = SkChecksum::Hash32(font, sizeof(font), hash);
+    hash = SkChecksum::Hash32(fLocale.c_str(), fLocale.size(), hash);
+    for (const SkShaper::Feature& feature : fFeatures) {
+        const uint32_t data[] = {feature.tag, feature.value,
+                                 static_cast<uint32_t>(feature.start),
+                                 static_cast<uint32_t>(feature.end)};
+        hash = SkChecksum::Hash32(data, sizeof(data), hash);
+    }
+    return hash;
+}
+
+ShapedRunCache::Entry::Entry(Key key, std::shared_ptr<const ShapedRuns> runs)
+        : fKey(std::move(key)), fRuns(std::move(runs)) {
+    fBytes = sizeof(Entry) + fKey.fText.size() + fKey.fLocale.size() +
+             fKey.fFeatures.size() * sizeof(SkShaper::Feature);
+    for (const ShapedRun& run : *fRuns) {
+        fBytes += sizeof(ShapedRun) +
+                  run.fGlyphs.size() * (sizeof(SkGlyphID) + 2 * sizeof(SkPoint) +
+                                        sizeof(uint32_t));
+    }
+}
+
+ShapedRunCache::ShapedRunCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+ShapedRunCache::~ShapedRunCache() { this->reset(); }
+
+size_t ShapedRunCache::byteLimit() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fByteLimit;
+}
+
+void ShapedRunCache::setByteLimit(size_t byteLimit) {
+    SkAutoMutexExclusive lock(fMutex);
+    fByteLimit = byteLimit;
+    this->purge();
+}
+
+size_t ShapedRunCache::bytesUsed() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fBytesUsed;
+}
+
+int ShapedRunCache::count() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fEntries.count();
+}
+
+int ShapedRunCache::hitCount() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fHitCount;
+}
+
+int ShapedRunCache::missCount() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fMissCount;
+}
+
+void ShapedRunCache::reset() {
+    SkAutoMutexExclusive lock(fMutex);
+    fEntries.reset();
+    while (Entry* entry = fLRU.head()) {
+        fLRU.remove(entry);
+        delete entry;
+    }
+    fBytesUsed = 0;
+}
+
+std::shared_ptr<const ShapedRunCache::ShapedRuns> ShapedRunCache::find(const Key& key) {
+    SkAutoMutexExclusive lock(fMutex);
+    Entry** found = fEntries.find(key);
+    if (found == nullptr) {
+        ++fMissCount;
+        return nullptr;
+    }
+    ++fHitCount;
+    Entry* entry = *found;
+    if (entry != fLRU.head()) {
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+    }
+    return entry->fRuns;
+}
+
+void ShapedRunCache::add(Key key, std::shared_ptr<const ShapedRuns> runs) {
+    auto entry = std::make_unique<Entry>(std::move(key), std::move(runs));
+    SkAutoMutexExclusive lock(fMutex);
+    if (entry->fBytes > fByteLimit || fEntries.find(entry->fKey) != nullptr) {
+        // Too big to keep, or another paragraph added the word while this one shaped it.
+        return;
+    }
+    fBytesUsed += entry->fBytes;
+    fLRU.addToHead(entry.get());
+    fEntries.set(entry.release());
+    this->purge();
+}
+
+void ShapedRunCache::purge() {
+    while (fBytesUsed > fByteLimit) {
+        Entry* entry = fLRU.tail();
+        fEntries.remove(entry->fKey);
+        fLRU.remove(entry);
+        fBytesUsed -= entry->fBytes;
+        delete entry;
+    }
+}
+
+}  // namespace textlayout
+}  // namespace skia
@@ -7,6 +7,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontMgr.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkPaint.h"
@@ -25,6 +26,7 @@
 #include "modules/skparagraph/include/Paragraph.h"
 #include "modules/skparagraph/include/ParagraphCache.h"
 #include "modules/skparagraph/include/ParagraphStyle.h"
+#include "modules/skparagraph/include/ShapedRunCache.h"
 #include "modules/skparagraph/include/TextShadow.h"
 #include "modules/skparagraph/include/TextStyle.h"
 #include "modules/skparagraph/include/TypefaceFontProvider.h"
@@ -8481,3 +8483,145 @@ UNIX_ONLY_TEST(SkParagraph_ICU4X_EmojiRuns, reporter) {
     SkUnicode_Emoji(SkUnicodes::ICU4X::Make(), reporter);
 }
 #endif
+
+UNIX_ONLY_TEST(SkParagraph_ShapedRunCache, reporter) {
+    sk_sp<ResourceFontCollection> fontCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, fontCollection)
+    sk_sp<ResourceFontCollection> plainCollection = sk_make_sp<ResourceFontCollection>();
+    sk_sp<ShapedRunCache> runCache = sk_make_sp<ShapedRunCache>();
+    fontCollection->setShapedRunCache(runCache);
+    // Lay out every paragraph, so the words are shaped (or found) each time.
+    fontCollection->getParagraphCache()->turnOn(false);
+
+    auto layout = [&](sk_sp<FontCollection> collection, const char* text,
+                      const char* locale = "en") {
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        ParagraphBuilderImpl builder(paragraph_style, collection, get_unicode());
+        TextStyle text_style;
+        text_style.setFontFamilies({SkString("Roboto")});
+        text_style.setColor(SK_ColorBLACK);
+        text_style.setLocale(SkString(locale));
+        builder.pushStyle(text_style);
+        builder.addText(text, strlen(text));
+        builder.pop();
+        auto paragraph = builder.Build();
+        paragraph->layout(TestCanvasWidth);
+        return paragraph;
+    };
+
+    // The words come out as one run with the glyphs of the paragraph shaped whole.
+    auto paragraph = layout(fontCollection, "Hello World Text Dialog");
+    auto expected = layout(plainCollection, "Hello World Text Dialog");
+    REPORTER_ASSERT(reporter, runCache->missCount() == 4);
+    REPORTER_ASSERT(reporter, runCache->hitCount() == 0);
+    REPORTER_ASSERT(reporter, runCache->count() == 4);
+    auto impl = static_cast<ParagraphImpl*>(paragraph.get());
+    auto expectedImpl = static_cast<ParagraphImpl*>(expected.get());
+    REPORTER_ASSERT(reporter, impl->runs().size() == 1);
+    REPORTER_ASSERT(reporter, expectedImpl->runs().size() == 1);
+    const Run& run = impl->runs()[0];
+    const Run& expectedRun = expectedImpl->runs()[0];
+    REPORTER_ASSERT(reporter, run.size() == expectedRun.size());
+    REPORTER_ASSERT(reporter, run.textRange() == expectedRun.textRange());
+    for (size_t i = 0; i < std::min(run.size(), expectedRun.size()); ++i) {
+        REPORTER_ASSERT(reporter, run.glyphs()[i] == expectedRun.glyphs()[i]);
+        REPORTER_ASSERT(reporter, run.clusterIndex(i) == expectedRun.clusterIndex(i));
+    }
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(paragraph->getMaxIntrinsicWidth(),
+                                                  expected->getMaxIntrinsicWidth(), 0.5f));
+
+    // Laying out the paragraph again shapes nothing.
+    layout(fontCollection, "Hello World Text Dialog");
+    REPORTER_ASSERT(reporter, runCache->missCount() == 4);
+    REPORTER_ASSERT(reporter, runCache->hitCount() == 4);
+
+    // An edit only shapes the word it changed.
+    layout(fontCollection, "Hello World Test Dialog");
+    REPORTER_ASSERT(reporter, runCache->missCount() == 5);
+    REPORTER_ASSERT(reporter, runCache->hitCount() == 7);
+
+    // Words in another language are shaped again.
+    layout(fontCollection, "Hello World Test Dialog", "tr");
+    REPORTER_ASSERT(reporter, runCache->missCount() == 9);
+    REPORTER_ASSERT(reporter, runCache->hitCount() == 7);
+
+    // The cache keeps to its budget, evicting the least recently used words first.
+    const size_t bytesUsed = runCache->bytesUsed();
+    runCache->setByteLimit(bytesUsed / 2);
+    REPORTER_ASSERT(reporter, runCache->bytesUsed() <= bytesUsed / 2);
+    REPORTER_ASSERT(reporter, runCache->count() < 9);
+
+    fontCollection->clearCaches();
+    REPORTER_ASSERT(reporter, runCache->count() == 0);
+    REPORTER_ASSERT(reporter, runCache->bytesUsed() == 0);
+}
+
+UNIX_ONLY_TEST(SkParagraph_LayoutInParallel, reporter) {
+    // The serial reference is laid out with a collection of its own, set up the same way, and
+    // neither collection caches paragraphs, so the parallel layouts really shape their text.
+    sk_sp<ResourceFontCollection> serialCollection = sk_make_sp<ResourceFontCollection>();
+    SKIP_IF_FONTS_NOT_FOUND(reporter, serialCollection)
+    sk_sp<ResourceFontCollection> parallelCollection = sk_make_sp<ResourceFontCollection>();
+    for (ResourceFontCollection* collection : {serialCollection.get(), parallelCollection.get()}) {
+        collection->getParagraphCache()->turnOn(false);
+        collection->setShapedRunCache(sk_make_sp<ShapedRunCache>());
+    }
+
+    const char* texts[] = {
+        "Hello World Text Dialog",
+        "I'm a little teapot, short and stout",
+        "Here is my handle, here is my spout",
+        "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA",
+        "When I get all steamed up, hear me shout",
+        "Tip me over and pour me out!",
+    };
+    auto build = [&](const char* text, sk_sp<FontCollection> fontCollection) {
+        ParagraphStyle paragraph_style;
+        paragraph_style.turnHintingOff();
+        ParagraphBuilderImpl builder(paragraph_style, fontCollection, get_unicode());
+        TextStyle text_style;
+        text_style.setFontFamilies({SkString("Roboto")});
+        text_style.setColor(SK_ColorBLACK);
+        builder.pushStyle(text_style);
+        builder.addText(text, strlen(text));
+        builder.pop();
+        return builder.Build();
+    };
+
+    std::vector<std::unique_ptr<Paragraph>> serial, parallel;
+    std::vector<Paragraph*> batch;
+    for (int copy = 0; copy < 4; ++copy) {
+        for (const char* text : texts) {
+            serial.push_back(build(text, serialCollection));
+            parallel.push_back(build(text, parallelCollection));
+            batch.push_back(parallel.back().get());
+        }
+    }
+    for (auto& paragraph : serial) {
+        paragraph->layout(200);
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    Paragraph::Layout(batch, 200, executor.get());
+
+    for (size_t i = 0; i < serial.size(); ++i) {
+        REPORTER_ASSERT(reporter, serial[i]->lineNumber() == parallel[i]->lineNumber());
+        REPORTER_ASSERT(reporter, serial[i]->getHeight() == parallel[i]->getHeight());
+        REPORTER_ASSERT(reporter,
+                        serial[i]->getMaxIntrinsicWidth() == parallel[i]->getMaxIntrinsicWidth());
+        REPORTER_ASSERT(reporter, serial[i]->getLongestLine() == parallel[i]->getLongestLine());
+        auto serialImpl = static_cast<ParagraphImpl*>(serial[i].get());
+        auto parallelImpl = static_cast<ParagraphImpl*>(parallel[i].get());
+        REPORTER_ASSERT(reporter, serialImpl->runs().size() == parallelImpl->runs().size());
+        for (size_t r = 0; r < std::min(serialImpl->runs().size(),
+                                        parallelImpl->runs().size()); ++r) {
+            const Run& a = serialImpl->runs()[r];
+            const Run& b = parallelImpl->runs()[r];
+            REPORTER_ASSERT(reporter, a.size() == b.size());
+            for (size_t g = 0; g < std::min(a.size(), b.size()); ++g) {
+                REPORTER_ASSERT(reporter, a.glyphs()[g] == b.glyphs()[g]);
+                REPORTER_ASSERT(reporter, a.positionX(g) == b.positionX(g));
+            }
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include "src/base/SkUTF.h"
 
 #include "include/private/base/SkTFitsIn.h"
+#include "src/base/SkVx.h"
 
 static constexpr inline int32_t left_shift(int32_t value, int32_t shift) {
     return (int32_t) ((uint32_t) value << shift);
@@ -288,6 +289,38 @@ int SkUTF::UTF8ToUTF16(uint16_t dst[], int dstCapacity, const char src[], size_t
     return dstLength;
 }
 
+int SkUTF::UTF8ToUTF32(SkUnichar dst[], int dstCapacity, const char src[], size_t srcByteLength) {
+    if (!dst) {
+        dstCapacity = 0;
+    }
+
+    int dstLength = 0;
+    const char* endSrc = src + srcByteLength;
+    while (src < endSrc) {
+        if (endSrc - src >= 16 && (!dst || dstCapacity - dstLength >= 16)) {
+            const auto bytes = skvx::byte16::Load(src);
+            if (!any(bytes >= 0x80)) {
+                if (dst) {
+                    skvx::cast<int32_t>(bytes).store(dst + dstLength);
+                }
+                src += 16;
+                dstLength += 16;
+                continue;
+            }
+        }
+
+        SkUnichar uni = NextUTF8(&src, endSrc);
+        if (uni < 0) {
+            return -1;
+        }
+        if (dstLength < dstCapacity) {
+            dst[dstLength] = uni;
+        }
+        dstLength += 1;
+    }
+    return dstLength;
+}
+
 int SkUTF::UTF16ToUTF8(char dst[], int dstCapacity, const uint16_t src[], size_t srcLength) {
     if (!dst) {
         dstCapacity = 0;
@@ -78,6 +78,12 @@ SK_SPI size_t ToUTF16(SkUnichar uni, uint16_t utf16[2] = nullptr);
  */
 SK_SPI int UTF8ToUTF16(uint16_t dst[], int dstCapacity, const char src[], size_t srcByteLength);
 
+/** Returns the number of unicode codepoints in the src utf8 sequence. If dst is not null, it is
+ *  filled with the codepoints up to its capacity. Runs of ASCII are converted 16 bytes at a time.
+ *  If there is an error, -1 is returned and the dst[] buffer is undefined.
+ */
+SK_SPI int UTF8ToUTF32(SkUnichar dst[], int dstCapacity, const char src[], size_t srcByteLength);
+
 /** Returns the number of resulting UTF8 values needed to convert the src utf16 sequence.
  *  If dst is not null, it is filled with the corresponding values up to its capacity.
  *  If there is an error, -1 is returned and the dst[] buffer is undefined.
@@ -279,6 +279,15 @@ void SkBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     }
 }
 
+void SkBlitter::blitMasks(SkSpan<const SkMask> masks, const SkIRect& clip) {
+    for (const SkMask& mask : masks) {
+        SkIRect r;
+        if (r.intersect(mask.fBounds, clip)) {
+            this->blitMask(mask, r);
+        }
+    }
+}
+
 /////////////////////// these are not virtual, just helpers
 
 #if defined(SK_SUPPORT_LEGACY_ALPHA_BITMAP_AS_COVERAGE)
@@ -12,6 +12,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkRegion.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkDebug.h"
@@ -77,6 +78,10 @@ public:
     /// typically used for text.
     virtual void blitMask(const SkMask&, const SkIRect& clip);
 
+    /// Blit several masks, each clipped to clip, with the same result as calling blitMask() on
+    /// each in order; typically the glyphs of a text run.
+    virtual void blitMasks(SkSpan<const SkMask> masks, const SkIRect& clip);
+
     // (x, y), (x + 1, y)
     virtual void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
         int16_t runs[3];
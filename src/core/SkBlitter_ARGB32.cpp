@@ -16,6 +16,7 @@
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkUtils.h"
 #include "src/base/SkVx.h"
@@ -30,6 +31,8 @@
 #include <cstddef>
 #include <cstdint>
 
+using namespace skia_private;
+
 static inline int upscale_31_to_32(int value) {
     SkASSERT((unsigned)value <= 31);
     return value + (value >> 4);
@@ -1580,6 +1583,78 @@ void SkARGB32_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     }
 }
 
+void SkARGB32_Blitter::blitMasks(SkSpan<const SkMask> masks, const SkIRect& clip) {
+    if (fSrcA == 0) {
+        return;
+    }
+
+    // Clip every mask once up front. Anything other than A8 goes through blitMask().
+    struct Span {
+        const SkMask* fMask;
+        SkIRect       fBounds;
+    };
+    STArray<64, Span> spans;
+    for (const SkMask& mask : masks) {
+        if (mask.fFormat != SkMask::kA8_Format) {
+            INHERITED::blitMasks(masks, clip);
+            return;
+        }
+        SkIRect r;
+        if (r.intersect(mask.fBounds, clip)) {
+            spans.push_back({&mask, r});
+        }
+    }
+    if (spans.empty()) {
+        return;
+    }
+
+    // Blit row by row so each destination row is loaded once for all the masks that cover it.
+    // Within a row the masks are blitted in their original order, so overlapping glyphs
+    // composite exactly as they would one mask at a time.
+    STArray<64, int> byTop(spans.size());
+    for (int i = 0; i < spans.size(); ++i) {
+        byTop.push_back(i);
+    }
+    std::stable_sort(byTop.begin(), byTop.end(), [&](int a, int b) {
+        return spans[a].fBounds.fTop < spans[b].fBounds.fTop;
+    });
+
+    STArray<64, int> active, merged;
+    int next = 0;
+    int y = spans[byTop[0]].fBounds.fTop;
+    while (next < byTop.size() || !active.empty()) {
+        if (active.empty()) {
+            y = std::max(y, spans[byTop[next]].fBounds.fTop);
+        }
+        // Masks starting on this row are already in draw order; merge them into active.
+        int end = next;
+        while (end < byTop.size() && spans[byTop[end]].fBounds.fTop == y) {
+            ++end;
+        }
+        if (end > next) {
+            merged.clear();
+            merged.push_back_n(active.size() + end - next);
+            std::merge(active.begin(), active.end(),
+                       byTop.begin() + next, byTop.begin() + end, merged.begin());
+            active.swap(merged);
+            next = end;
+        }
+
+        uint32_t* row = fDevice.writable_addr32(0, y);
+        for (int i : active) {
+            const Span& span = spans[i];
+            SkOpts::blit_mask_d32_a8(row + span.fBounds.fLeft, fDevice.rowBytes(),
+                                     span.fMask->getAddr8(span.fBounds.fLeft, y),
+                                     span.fMask->fRowBytes, fColor, span.fBounds.width(), 1);
+        }
+
+        ++y;
+        active.resize_back(std::remove_if(active.begin(), active.end(), [&](int i) {
+            return spans[i].fBounds.fBottom <= y;
+        }) - active.begin());
+    }
+}
+
 void SkARGB32_Opaque_Blitter::blitMask(const SkMask& mask,
                                        const SkIRect& clip) {
     SkASSERT(mask.fBounds.contains(clip));
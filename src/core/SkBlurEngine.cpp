@@ -36,9 +36,11 @@
 #include "src/core/SkDevice.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
@@ -712,6 +714,31 @@ private:
     skvx::Vec<4, uint32_t>* fBuffer1Cursor;
 };
 
+// See SkBlurEngine::SetRasterBlurExecutor().
+std::atomic<SkExecutor*> gRasterBlurExecutor{nullptr};
+
+// The X pass runs in bands of rows and the Y pass in bands of columns, with each band of columns
+// blurred in strips of 16, a 64 byte cache line of pixels.
+constexpr int kRowsPerBand = 32;
+constexpr int kColumnsPerBand = 64;
+constexpr int kColumnsPerStrip = 16;
+
+// Calls fn(start, end) for bands of [0, count), on executor's threads when there is one.
+template <typename Fn>
+void for_each_band(SkExecutor* executor, int count, int bandSize, Fn&& fn) {
+    const int bands = (count + bandSize - 1) / bandSize;
+    if (!executor || bands < 2) {
+        if (count > 0) {
+            fn(0, count);
+        }
+        return;
+    }
+    SkTaskGroup taskGroup(*executor);
+    taskGroup.batch(bands, [&](int i) {
+        fn(i * bandSize, std::min(count, (i + 1) * bandSize));
+    });
+}
+
 class Raster8888BlurAlgorithm : public SkBlurEngine::Algorithm {
 public:
     // See analysis in description of TentPass for the max supported sigma.
@@ -792,9 +819,14 @@ public:
         }
         dst.eraseColor(SK_ColorTRANSPARENT);
 
-        auto buffer = alloc.makeBytesAlignedTo(std::max(makerX->bufferSizeBytes(),
-                                                        makerY->bufferSizeBytes()),
-                                            alignof(skvx::Vec<4, uint32_t>));
+        // Rows of the X pass and columns of the Y pass are independent, so each band of them
+        // gets its own pass (and its blur state).
+        SkExecutor* executor = gRasterBlurExecutor.load(std::memory_order_relaxed);
+        auto makePass = [](const PassMaker* maker, SkArenaAlloc* bandAlloc) {
+            auto buffer = bandAlloc->makeBytesAlignedTo(maker->bufferSizeBytes(),
+                                                        alignof(skvx::Vec<4, uint32_t>));
+            return maker->makePass(buffer, bandAlloc);
+        };
 
         // Basic Plan: The three cases to handle
         // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -813,20 +845,22 @@ public:
             loopStart = std::max(srcBounds.top(),    dstBounds.top());
             loopEnd   = std::min(srcBounds.bottom(), dstBounds.bottom());
 
-            auto srcAddr = src.getAddr32(0, loopStart - srcBounds.top());
-            auto dstAddr = dst.getAddr32(0, loopStart - dstBounds.top());
-
             // Iterate over each row to calculate 1D blur along X.
-            Pass* pass = makerX->makePass(buffer, &alloc);
-            for (int y = loopStart; y < loopEnd; ++y) {
-                pass->blur(srcBounds.left()  - dstBounds.left(),
-                           srcBounds.right() - dstBounds.left(),
-                           dstBounds.width(),
-                           srcAddr, 1,
-                           dstAddr, 1);
-                srcAddr += src.rowBytesAsPixels();
-                dstAddr += dst.rowBytesAsPixels();
-            }
+            for_each_band(executor, loopEnd - loopStart, kRowsPerBand, [&](int start, int end) {
+                SkSTArenaAlloc<1024> bandAlloc;
+                Pass* pass = makePass(makerX, &bandAlloc);
+                auto srcAddr = src.getAddr32(0, loopStart + start - srcBounds.top());
+                auto dstAddr = dst.getAddr32(0, loopStart + start - dstBounds.top());
+                for (int y = start; y < end; ++y) {
+                    pass->blur(srcBounds.left()  - dstBounds.left(),
+                               srcBounds.right() - dstBounds.left(),
+                               dstBounds.width(),
+                               srcAddr, 1,
+                               dstAddr, 1);
+                    srcAddr += src.rowBytesAsPixels();
+                    dstAddr += dst.rowBytesAsPixels();
+                }
+            });
 
             // Set up the Y pass to blur from the full dst into the non-outset portion of dst
             src = dst;
@@ -844,20 +878,47 @@ public:
         // Iterate over each column to calculate 1D blur along Y. This is either blurring from src
         // into dst for a 1D blur; or it's blurring from dst into dst for the second pass of a 2D
         // blur.
+        // Columns are blurred a strip at a time: the strip is transposed into rows, blurred
+        // along the rows, and transposed back, rather than blurred a pixel per row down each
+        // column. The strip is copied out before any of it is written, so the in-place second
+        // pass of a 2D blur still reads the X pass's results.
         if (makerY->window() > 1) {
-            auto srcAddr = src.getAddr32(loopStart - srcBounds.left(), 0);
-            auto dstAddr = dst.getAddr32(loopStart - dstBounds.left(), dstYOffset);
-
-            Pass* pass = makerY->makePass(buffer, &alloc);
-            for (int x = loopStart; x < loopEnd; ++x) {
-                pass->blur(srcBounds.top()    - dstBounds.top(),
-                           srcBounds.bottom() - dstBounds.top(),
-                           dstBounds.height(),
-                           srcAddr, src.rowBytesAsPixels(),
-                           dstAddr, dst.rowBytesAsPixels());
-                srcAddr += 1;
-                dstAddr += 1;
-            }
+            const int srcHeight = srcBounds.height();
+            const int dstHeight = dstBounds.height();
+            const size_t srcStride = src.rowBytesAsPixels();
+            const size_t dstStride = dst.rowBytesAsPixels();
+            for_each_band(executor, loopEnd - loopStart, kColumnsPerBand, [&](int start, int end) {
+                SkSTArenaAlloc<1024> bandAlloc;
+                Pass* pass = makePass(makerY, &bandAlloc);
+                uint32_t* srcRows = bandAlloc.makeArrayDefault<uint32_t>(kColumnsPerStrip *
+                                                                         srcHeight);
+                uint32_t* dstRows = bandAlloc.makeArrayDefault<uint32_t>(kColumnsPerStrip *
+                                                                         dstHeight);
+                for (int x = start; x < end; x += kColumnsPerStrip) {
+                    const int columns = std::min(kColumnsPerStrip, end - x);
+                    const uint32_t* srcAddr = src.getAddr32(loopStart + x - srcBounds.left(), 0);
+                    uint32_t* dstAddr = dst.getAddr32(loopStart + x - dstBounds.left(),
+                                                      dstYOffset);
+
+                    for (int y = 0; y < srcHeight; ++y, srcAddr += srcStride) {
+                        for (int c = 0; c < columns; ++c) {
+                            srcRows[c * srcHeight + y] = srcAddr[c];
+                        }
+                    }
+                    for (int c = 0; c < columns; ++c) {
+                        pass->blur(srcBounds.top()    - dstBounds.top(),
+                                   srcBounds.bottom() - dstBounds.top(),
+                                   dstHeight,
+                                   srcRows + c * srcHeight, 1,
+                                   dstRows + c * dstHeight, 1);
+                    }
+                    for (int y = 0; y < dstHeight; ++y, dstAddr += dstStride) {
+                        for (int c = 0; c < columns; ++c) {
+                            dstAddr[c] = dstRows[c * dstHeight + y];
+                        }
+                    }
+                }
+            });
         }
 
         dstBounds = originalDstBounds.makeOffset(-dstOrigin); // Make relative to dst's pixels
@@ -915,6 +976,10 @@ const SkBlurEngine* SkBlurEngine::GetRasterBlurEngine() {
     return &kInstance;
 }
 
+void SkBlurEngine::SetRasterBlurExecutor(SkExecutor* executor) {
+    gRasterBlurExecutor.store(executor, std::memory_order_relaxed);
+}
+
 // SkShaderBlurAlgorithm
 // ----------------------------------------------------------------------------
 
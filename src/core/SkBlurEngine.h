@@ -19,6 +19,7 @@
 #include <cmath>
 
 class SkDevice;
+class SkExecutor;
 class SkRuntimeEffect;
 class SkRuntimeShaderBuilder;
 class SkSpecialImage;
@@ -76,6 +77,10 @@ public:
     // and other color types, it uses SkShaderBlurAlgorithm backed by the raster pipeline.
     static const SkBlurEngine* GetRasterBlurEngine();
 
+    // Split the raster engine's box blurs into bands of rows and columns that run on executor,
+    // which must outlive its use. nullptr, the default, blurs on the calling thread.
+    static void SetRasterBlurExecutor(SkExecutor* executor);
+
     // TODO: These are internal functions of the raster blur engine but need to be public for legacy
     // code paths to invoke them directly.
 
@@ -32,6 +32,7 @@
 #include "src/base/SkTLazy.h"
 #include "src/core/SkBlitter_A8.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkBlurNinePatchCache.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkDrawBase.h"
 #include "src/core/SkMask.h"
@@ -211,17 +212,11 @@ static SkCachedData* copy_mask_to_cacheddata(SkMaskBuilder* mask) {
     return data;
 }
 
-static SkCachedData* find_cached_rrect(SkTLazy<SkMask>* mask, SkScalar sigma, SkBlurStyle style,
-                                       const SkRRect& rrect) {
-    return SkMaskCache::FindAndRef(sigma, style, rrect, mask);
-}
-
-static SkCachedData* add_cached_rrect(SkMaskBuilder* mask, SkScalar sigma, SkBlurStyle style,
-                                      const SkRRect& rrect) {
-    SkCachedData* cache = copy_mask_to_cacheddata(mask);
-    if (cache) {
-        SkMaskCache::Add(sigma, style, rrect, *mask, cache);
-    }
+static SkCachedData* add_cached_nine_patch(SkMaskBuilder* mask,
+                                           const SkBlurNinePatchCache::Key& key) {
+    // The cached data takes over the mask's pixels.
+    SkCachedData* cache = new SkCachedData(mask->image(), mask->computeTotalImageSize());
+    SkBlurNinePatchCache::Get()->add(key, *mask, cache);
     return cache;
 }
 
@@ -338,9 +333,10 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     radii[SkRRect::kLowerLeft_Corner] = LL;
     smallRR.setRectRadii(smallR, radii);
 
-    const SkScalar sigma = this->computeXformedSigma(matrix);
+    // The stretched mask only depends on the exact sigma and radii, not on the size of rrect.
+    const SkBlurNinePatchCache::Key key(this->computeXformedSigma(matrix), fBlurStyle, radii);
     SkTLazy<SkMask> cachedMask;
-    SkCachedData* cache = find_cached_rrect(&cachedMask, sigma, fBlurStyle, smallRR);
+    SkCachedData* cache = SkBlurNinePatchCache::Get()->findAndRef(key, &cachedMask);
     if (!cache) {
         SkMaskBuilder filterM;
         bool analyticBlurWorked = false;
@@ -360,7 +356,7 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
                 return kFalse_FilterReturn;
             }
         }
-        cache = add_cached_rrect(&filterM, sigma, fBlurStyle, smallRR);
+        cache = add_cached_nine_patch(&filterM, key);
         cachedMask.init(filterM);
     }
 
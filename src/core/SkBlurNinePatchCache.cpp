@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkBlurNinePatchCache.h"
+
+#include "include/core/SkBlurTypes.h"
+#include "include/core/SkRect.h"
+#include "src/base/SkTLazy.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkMask.h"
+
+#include <cstring>
+#include <memory>
+
+struct SkBlurNinePatchCache::Entry {
+    Entry(const Key& key, const SkMask& mask, SkCachedData* data)
+            : fKey(key), fBounds(mask.fBounds), fRowBytes(mask.fRowBytes), fData(data) {
+        fData->ref();
+    }
+    ~Entry() { fData->unref(); }
+
+    size_t bytes() const { return sizeof(*this) + fData->size(); }
+
+    Key           fKey;
+    SkIRect       fBounds;
+    size_t        fRowBytes;
+    SkCachedData* fData;
+
+    SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+};
+
+// Keys are hashed and compared as bytes.
+static_assert(sizeof(SkBlurNinePatchCache::Key) == 10 * sizeof(float), "Key has padding");
+
+SkBlurNinePatchCache::Key::Key(float sigma, SkBlurStyle style, const SkVector radii[4])
+        : fSigma(sigma), fStyle(style) {
+    memcpy(fRadii, radii, sizeof(fRadii));
+}
+
+bool SkBlurNinePatchCache::Key::operator==(const Key& other) const {
+    return 0 == memcmp(this, &other, sizeof(Key));
+}
+
+const SkBlurNinePatchCache::Key& SkBlurNinePatchCache::Traits::GetKey(const Entry* entry) {
+    return entry->fKey;
+}
+
+uint32_t SkBlurNinePatchCache::Traits::Hash(const Key& key) {
+    return SkChecksum::Hash32(&key, sizeof(Key));
+}
+
+SkBlurNinePatchCache* SkBlurNinePatchCache::Get() {
+    static SkBlurNinePatchCache* gCache = new SkBlurNinePatchCache;
+    return gCache;
+}
+
+SkBlurNinePatchCache::SkBlurNinePatchCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+SkBlurNinePatchCache::~SkBlurNinePatchCache() { this->purgeAll(); }
+
+SkCachedData* SkBlurNinePatchCache::findAndRef(const Key& key, SkTLazy<SkMask>* mask) {
+    SkAutoMutexExclusive lock(fMutex);
+    Entry** found = fEntries.find(key);
+    if (found == nullptr) {
+        ++fMissCount;
+        return nullptr;
+    }
+    ++fHitCount;
+    Entry* entry = *found;
+    if (entry != fLRU.head()) {
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+    }
+    entry->fData->ref();
+    mask->init(static_cast<const uint8_t*>(entry->fData->data()),
+               entry->fBounds, entry->fRowBytes, SkMask::kA8_Format);
+    return entry->fData;
+}
+
+void SkBlurNinePatchCache::add(const Key& key, const SkMask& mask, SkCachedData* data) {
+    SkASSERT(mask.fFormat == SkMask::kA8_Format);
+    auto entry = std::make_unique<Entry>(key, mask, data);
+    SkAutoMutexExclusive lock(fMutex);
+    if (entry->bytes() > fByteLimit || fEntries.find(key) != nullptr) {
+        // Too big to keep, or another thread added the mask while this one blurred it.
+        return;
+    }
+    fBytesUsed += entry->bytes();
+    fLRU.addToHead(entry.get());
+    fEntries.set(entry.release());
+    this->purge();
+}
+
+size_t SkBlurNinePatchCache::byteLimit() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fByteLimit;
+}
+
+size_t SkBlurNinePatchCache::setByteLimit(size_t byteLimit) {
+    SkAutoMutexExclusive lock(fMutex);
+    const size_t previous = fByteLimit;
+    fByteLimit = byteLimit;
+    this->purge();
+    return previous;
+}
+
+size_t SkBlurNinePatchCache::bytesUsed() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fBytesUsed;
+}
+
+int SkBlurNinePatchCache::count() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fEntries.count();
+}
+
+int SkBlurNinePatchCache::hitCount() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fHitCount;
+}
+
+int SkBlurNinePatchCache::missCount() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fMissCount;
+}
+
+void SkBlurNinePatchCache::purgeAll() {
+    SkAutoMutexExclusive lock(fMutex);
+    fEntries.reset();
+    while (Entry* entry = fLRU.head()) {
+        fLRU.remove(entry);
+        delete entry;
+    }
+    fBytesUsed = 0;
+}
+
+void SkBlurNinePatchCache::purge() {
+    while (fBytesUsed > fByteLimit) {
+        Entry* entry = fLRU.tail();
+        fEntries.remove(entry->fKey);
+        fLRU.remove(entry);
+        fBytesUsed -= entry->bytes();
+        delete entry;
+    }
+}
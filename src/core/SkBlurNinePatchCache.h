@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurNinePatchCache_DEFINED
+#define SkBlurNinePatchCache_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkTInternalLList.h"
+#include "src/core/SkTHash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class SkCachedData;
+enum SkBlurStyle : int;
+struct SkMask;
+template <typename T> class SkTLazy;
+
+// A process-wide cache of the blurred round rect masks that SkBlurMaskFilterImpl stretches over
+// a round rect as a nine patch. The mask only depends on the corner radii and the blur, not on
+// the size of the round rect, so every card with the same corners and shadow shares one. The masks
+// have their own byte budget, apart from SkResourceCache, so that large cached bitmaps don't evict
+// them.
+class SkBlurNinePatchCache {
+public:
+    static constexpr size_t kDefaultByteLimit = 2 * 1024 * 1024;
+
+    static SkBlurNinePatchCache* Get();
+
+    // The device-space sigma and corner radii of the mask, compared exactly.
+    struct Key {
+        Key(float sigma, SkBlurStyle style, const SkVector radii[4]);
+
+        float    fSigma;
+        int32_t  fStyle;
+        SkVector fRadii[4];
+
+        bool operator==(const Key& other) const;
+    };
+
+    explicit SkBlurNinePatchCache(size_t byteLimit = kDefaultByteLimit);
+    ~SkBlurNinePatchCache();
+
+    /**
+     * On success, return a ref to the SkCachedData that holds the pixels, and have mask
+     * already point to that memory.
+     *
+     * On failure, return nullptr.
+     */
+    SkCachedData* findAndRef(const Key&, SkTLazy<SkMask>* mask) SK_EXCLUDES(fMutex);
+
+    /**
+     * Add a mask and the SkCachedData holding its pixels, which the cache refs.
+     */
+    void add(const Key&, const SkMask& mask, SkCachedData* data) SK_EXCLUDES(fMutex);
+
+    size_t byteLimit() const;
+    // Evicts the least recently used masks until the cache fits; returns the previous limit.
+    size_t setByteLimit(size_t byteLimit);
+    size_t bytesUsed() const;
+    int count() const;
+    void purgeAll();
+
+    // How many lookups found, or did not find, a mask.
+    int hitCount() const;
+    int missCount() const;
+
+private:
+    struct Entry;
+
+    struct Traits {
+        static const Key& GetKey(const Entry* entry);
+        static uint32_t Hash(const Key& key);
+    };
+
+    void purge() SK_REQUIRES(fMutex);
+
+    mutable SkMutex fMutex;
+    skia_private::THashTable<Entry*, Key, Traits> fEntries SK_GUARDED_BY(fMutex);
+    SkTInternalLList<Entry> fLRU SK_GUARDED_BY(fMutex);
+    size_t fByteLimit SK_GUARDED_BY(fMutex);
+    size_t fBytesUsed SK_GUARDED_BY(fMutex) = 0;
+    int fHitCount SK_GUARDED_BY(fMutex) = 0;
+    int fMissCount SK_GUARDED_BY(fMutex) = 0;
+};
+
+#endif  // SkBlurNinePatchCache_DEFINED
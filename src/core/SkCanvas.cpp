@@ -2787,7 +2787,7 @@ void SkCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
     }
 
     SkAutoCanvasMatrixPaint acmp(this, matrix, paint, picture->cullRect());
-    picture->playback(this);
+    this->topDevice()->drawPicture(this, picture);
 }
 #endif
 
@@ -16,6 +16,7 @@
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathTypes.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRSXform.h"
@@ -299,6 +300,10 @@ void SkDevice::drawDrawable(SkCanvas* canvas, SkDrawable* drawable, const SkMatr
     drawable->draw(canvas, matrix);
 }
 
+void SkDevice::drawPicture(SkCanvas* canvas, const SkPicture* picture) {
+    picture->playback(canvas);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 void SkDevice::drawSpecial(SkSpecialImage*, const SkMatrix&, const SkSamplingOptions&,
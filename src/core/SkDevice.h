@@ -47,6 +47,7 @@ class SkDrawable;
 class SkImage;
 class SkPaint;
 class SkPath;
+class SkPicture;
 class SkPixmap;
 class SkRRect;
 class SkSurface;
@@ -412,6 +413,9 @@ public:
                                     SkCanvas::SrcRectConstraint);
 
     virtual void drawDrawable(SkCanvas*, SkDrawable*, const SkMatrix*);
+    // The canvas has already applied the picture's matrix and paint. Default impl plays the
+    // picture back into the canvas.
+    virtual void drawPicture(SkCanvas*, const SkPicture*);
 
     // -- "Special" drawing and image routines
 
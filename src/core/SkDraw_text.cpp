@@ -11,6 +11,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRegion.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkZip.h"
@@ -26,6 +27,8 @@
 #include <cstdint>
 #include <climits>
 
+using namespace skia_private;
+
 class SkCanvas;
 class SkPaint;
 namespace sktext { class GlyphRunList; }
@@ -93,22 +96,24 @@ void SkDraw::paintMasks(SkZip<const SkGlyph*, SkPoint> accepted, const SkPaint&
     } else {
         SkIRect clipBounds = fRC->isBW() ? fRC->bwRgn().getBounds()
                                          : fRC->aaRgn().getBounds();
+        // Collect the run's masks so the blitter can clip and composite them together. Color
+        // glyphs are drawn as sprites, so flush the pending masks first to keep the draw order.
+        STArray<64, SkMask> masks;
+        auto flushMasks = [&] {
+            if (!masks.empty()) {
+                blitter->blitMasks(masks, clipBounds);
+                masks.clear();
+            }
+        };
         for (auto [glyph, pos] : accepted) {
             if (check_glyph_position(pos)) {
                 SkMask mask = glyph->mask(pos);
-                SkIRect storage;
-                const SkIRect* bounds = &mask.fBounds;
-
-                // this extra test is worth it, assuming that most of the time it succeeds
-                // since we can avoid writing to storage
-                if (!clipBounds.containsNoEmptyCheck(mask.fBounds)) {
-                    if (!storage.intersect(mask.fBounds, clipBounds)) {
-                        continue;
-                    }
-                    bounds = &storage;
+                if (!SkIRect::Intersects(mask.fBounds, clipBounds)) {
+                    continue;
                 }
 
                 if (SkMask::kARGB32_Format == mask.fFormat) {
+                    flushMasks();
                     SkBitmap bm;
                     bm.installPixels(SkImageInfo::MakeN32Premul(mask.fBounds.size()),
                                      const_cast<uint8_t*>(mask.fImage),
@@ -116,10 +121,11 @@ void SkDraw::paintMasks(SkZip<const SkGlyph*, SkPoint> accepted, const SkPaint&
                     bm.setImmutable();
                     this->drawSprite(bm, mask.fBounds.x(), mask.fBounds.y(), paint);
                 } else {
-                    blitter->blitMask(mask, *bounds);
+                    masks.push_back(mask);
                 }
             }
         }
+        flushMasks();
     }
 }
 
@@ -25,16 +25,20 @@
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSpan_impl.h"
 #include "include/private/base/SkTArray.h"
+#include "src/base/SkNoDestructor.h"
 #include "src/core/SkGlyph.h"
+#include "src/core/SkMSDFGlyphCache.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrike.h"
+#include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/text/GlyphRun.h"
 
 #include <algorithm>
 #include <initializer_list>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace skia_private;
@@ -42,6 +46,10 @@ using namespace skia_private;
 using namespace skglyph;
 using namespace sktext;
 
+// Draw large glyphs from multi-channel distance fields (see SkMSDFGlyphCache) instead of from a
+// strike for each size. Experimental; set by --msdfText in dm and nanobench.
+bool gSkUseMSDFText = false;
+
 namespace {
 SkScalerContextFlags compute_scaler_context_flags(const SkColorSpace* cs) {
     // If we're doing linear blending, then we can disable the gamma hacks.
@@ -160,6 +168,79 @@ prepare_for_direct_mask_drawing(SkStrike* strike,
 
     return {acceptedBuffer.first(acceptedSize), rejectedBuffer.first(rejectedSize)};
 }
+
+// Whether glyphs of runFont drawn with paint through positionMatrix can be drawn from distance
+// fields: the coverage is exact only for plain, unhinted fills under a uniform scale, and the
+// fields are only good at or above the size they were generated at.
+bool can_draw_as_msdf(const SkPaint& paint, const SkFont& runFont,
+                      const SkMatrix& positionMatrix) {
+    return gSkUseMSDFText &&
+           positionMatrix.isScaleTranslate() &&
+           positionMatrix.getScaleX() > 0 &&
+           positionMatrix.getScaleX() == positionMatrix.getScaleY() &&
+           runFont.getSize() * positionMatrix.getScaleX() >= SkMSDFGlyphCache::kFieldSize &&
+           runFont.getEdging() != SkFont::Edging::kAlias &&
+           !runFont.isEmbolden() &&
+           paint.getStyle() == SkPaint::kFill_Style &&
+           paint.isSrcOver() &&
+           !paint.getShader() &&
+           !paint.getPathEffect() &&
+           !paint.getMaskFilter();
+}
+
+// Draws the glyphs in source that have an outline from their distance fields, and returns the
+// rest, such as color glyphs, in rejectedBuffer.
+SkZip<SkGlyphID, SkPoint> draw_as_msdf(
+        const SkGlyphRunListPainterCPU::BitmapDevicePainter* bitmapDevice,
+        const SkFont& runFont,
+        const SkPaint& paint,
+        const SkMatrix& positionMatrix,
+        SkZip<const SkGlyphID, const SkPoint> source,
+        SkZip<SkGlyphID, SkPoint> rejectedBuffer) {
+    static SkNoDestructor<SkMSDFGlyphCache> cache;
+
+    // drawBitmap maps through the device's matrix, so undo it to place the coverage in pixels.
+    SkMatrix deviceToSource;
+    if (!positionMatrix.invert(&deviceToSource)) {
+        return rejectedBuffer.first(0);
+    }
+    SkFont deviceFont = runFont;
+    deviceFont.setSize(runFont.getSize() * positionMatrix.getScaleX());
+
+    int rejectedSize = 0;
+    // Every glyph's coverage is drawn into the top left of one scratch bitmap, which only grows
+    // when a glyph doesn't fit.
+    SkBitmap scratch;
+    for (auto [glyphID, pos] : source) {
+        if (!SkIsFinite(pos.x(), pos.y())) {
+            continue;
+        }
+        const SkPoint devicePos = positionMatrix.mapPoint(pos);
+        const SkIRect bounds = cache->glyphBounds(deviceFont, glyphID, devicePos);
+        if (!bounds.isEmpty() &&
+            (bounds.width() > scratch.width() || bounds.height() > scratch.height())) {
+            const SkImageInfo info = SkImageInfo::MakeA8(std::max(bounds.width(), scratch.width()),
+                                                         std::max(bounds.height(),
+                                                                  scratch.height()));
+            if (!scratch.tryAllocPixels(info)) {
+                scratch.reset();
+            }
+        }
+        SkBitmap coverage;
+        if (bounds.isEmpty() ||
+            !scratch.extractSubset(&coverage, SkIRect::MakeSize(bounds.size()))) {
+            rejectedBuffer[rejectedSize++] = std::make_tuple(glyphID, pos);
+            continue;
+        }
+        if (cache->drawGlyph(deviceFont, glyphID, devicePos, coverage.pixmap(),
+                             bounds.topLeft())) {
+            SkMatrix m = deviceToSource;
+            m.preTranslate(bounds.fLeft, bounds.fTop);
+            bitmapDevice->drawBitmap(coverage, m, nullptr, SkFilterMode::kNearest, paint);
+        }
+    }
+    return rejectedBuffer.first(rejectedSize);
+}
 }  // namespace
 
 // -- SkGlyphRunListPainterCPU ---------------------------------------------------------------------
@@ -202,6 +283,14 @@ void SkGlyphRunListPainterCPU::drawForBitmapDevice(SkCanvas* canvas,
 
         SkZip<const SkGlyphID, const SkPoint> source = glyphRun.source();
 
+        if (can_draw_as_msdf(paint, runFont, positionMatrix)) {
+            source = draw_as_msdf(
+                    bitmapDevice, runFont, paint, positionMatrix, source, rejectedBuffer);
+            if (source.empty()) {
+                continue;  // to the next run.
+            }
+        }
+
         if (SkStrikeSpec::ShouldDrawAsPath(paint, runFont, positionMatrix)) {
             auto [strikeSpec, strikeToSourceScale] =
                     SkStrikeSpec::MakePath(runFont, paint, props, fScalerContextFlags);
@@ -380,3 +469,53 @@ void SkGlyphRunListPainterCPU::drawForBitmapDevice(SkCanvas* canvas,
         //  rejects in a more sophisticated stage.
     }
 }
+
+void SkGlyphRunListPainterCPU::collectPrewarmRequests(
+        const sktext::GlyphRunList& glyphRunList,
+        const SkPaint& paint,
+        const SkMatrix& drawMatrix,
+        std::vector<SkStrikeCache::PrewarmRequest>* requests) const {
+    // These choices follow drawForBitmapDevice.
+    auto& props = (kN32_SkColorType == fColorType && paint.isSrcOver())
+                          ? fDeviceProps
+                          : fBitmapFallbackProps;
+
+    SkPoint drawOrigin = glyphRunList.origin();
+    SkMatrix positionMatrix{drawMatrix};
+    positionMatrix.preTranslate(drawOrigin.x(), drawOrigin.y());
+    for (auto& glyphRun : glyphRunList) {
+        const SkFont& runFont = glyphRun.font();
+
+        if (can_draw_as_msdf(paint, runFont, positionMatrix)) {
+            continue;  // Drawn without a strike.
+        }
+        if (SkStrikeSpec::ShouldDrawAsPath(paint, runFont, positionMatrix)) {
+            auto [strikeSpec, strikeToSourceScale] =
+                    SkStrikeSpec::MakePath(runFont, paint, props, fScalerContextFlags);
+            SkStrikeCache::PrewarmRequest request{strikeSpec.findOrCreateStrike(), {}, {}};
+            for (auto [glyphID, pos] : glyphRun.source()) {
+                if (SkIsFinite(pos.x(), pos.y())) {
+                    request.fPaths.push_back(glyphID);
+                }
+            }
+            requests->push_back(std::move(request));
+        } else if (!positionMatrix.hasPerspective()) {
+            SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+                    runFont, paint, props, fScalerContextFlags, positionMatrix);
+            SkStrikeCache::PrewarmRequest request{strikeSpec.findOrCreateStrike(), {}, {}};
+
+            // Pick the same sub-pixel positions as prepare_for_direct_mask_drawing.
+            const SkIPoint mask = request.fStrike->roundingSpec().ignorePositionFieldMask;
+            const SkPoint halfSampleFreq = request.fStrike->roundingSpec().halfAxisSampleFreq;
+            SkMatrix positionMatrixWithRounding = positionMatrix;
+            positionMatrixWithRounding.postTranslate(halfSampleFreq.x(), halfSampleFreq.y());
+            for (auto [glyphID, pos] : glyphRun.source()) {
+                if (SkIsFinite(pos.x(), pos.y())) {
+                    const SkPoint mappedPos = positionMatrixWithRounding.mapPoint(pos);
+                    request.fImages.push_back(SkPackedGlyphID{glyphID, mappedPos, mask});
+                }
+            }
+            requests->push_back(std::move(request));
+        }
+    }
+}
@@ -11,8 +11,10 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSurfaceProps.h"
 #include "src/base/SkZip.h"
+#include "src/core/SkStrikeCache.h"
 
 #include <cstdint>
+#include <vector>
 
 class SkBitmap;
 class SkCanvas;
@@ -48,6 +50,14 @@ public:
             SkCanvas* canvas, const BitmapDevicePainter* bitmapDevice,
             const sktext::GlyphRunList& glyphRunList, const SkPaint& paint,
             const SkMatrix& drawMatrix);
+
+    // Append the glyphs drawForBitmapDevice would generate to draw glyphRunList, one request per
+    // run, for SkStrikeCache::Prewarm. Glyphs drawn as drawables, or through a perspective
+    // matrix, are not included.
+    void collectPrewarmRequests(const sktext::GlyphRunList& glyphRunList,
+                                const SkPaint& paint,
+                                const SkMatrix& drawMatrix,
+                                std::vector<SkStrikeCache::PrewarmRequest>* requests) const;
 private:
     // The props as on the actual device.
     const SkSurfaceProps fDeviceProps;
@@ -7,15 +7,22 @@
 
 #include "include/core/SkGraphics.h"
 
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
 #include "src/core/SkBitmapProcState.h"
 #include "src/core/SkBlitMask.h"
 #include "src/core/SkBlitRow.h"
+#include "src/core/SkBlurEngine.h"
+#include "src/core/SkBlurNinePatchCache.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrikeStore.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "src/core/SkTypefaceCache.h"
 
@@ -41,6 +48,7 @@ void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkBlurNinePatchCache::Get()->purgeAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -69,6 +77,50 @@ int SkGraphics::GetFontCacheCountUsed() {
     return SkStrikeCache::GlobalStrikeCache()->getCacheCountUsed();
 }
 
+bool SkGraphics::SetFontCacheStore(const char path[]) {
+    if (!path) {
+        SkStrikeCache::GlobalStrikeCache()->setStrikeStore(nullptr);
+        return true;
+    }
+    sk_sp<SkStrikeStore> store = SkStrikeStore::MakeFromData(SkData::MakeFromFileName(path));
+    if (!store) {
+        return false;
+    }
+    SkStrikeCache::GlobalStrikeCache()->setStrikeStore(std::move(store));
+    return true;
+}
+
+bool SkGraphics::WriteFontCacheStore(const char path[]) {
+    SkFILEWStream stream(path);
+    return stream.isValid() &&
+           SkStrikeStore::Write(SkStrikeCache::GlobalStrikeCache(), &stream);
+}
+
+size_t SkGraphics::GetBlurNinePatchCacheLimit() {
+    return SkBlurNinePatchCache::Get()->byteLimit();
+}
+
+size_t SkGraphics::SetBlurNinePatchCacheLimit(size_t bytes) {
+    return SkBlurNinePatchCache::Get()->setByteLimit(bytes);
+}
+
+void SkGraphics::SetRasterBlurExecutor(SkExecutor* executor) {
+    SkBlurEngine::SetRasterBlurExecutor(executor);
+}
+
+void SkGraphics::SetImageFilterExecutor(SkExecutor* executor, size_t inFlightByteLimit) {
+    skif::SetRasterExecutor(executor, inFlightByteLimit);
+}
+
+void SkGraphics::SetImageFilterCacheReuseOverlapping(bool reuseOverlapping) {
+    SkImageFilterCache::Get()->setReuseOverlapping(reuseOverlapping);
+}
+
+void SkGraphics::SetImageFilterSourceDamage(uint32_t previousID, uint32_t currentID,
+                                            const SkIRect& damage) {
+    SkImageFilterCache::Get()->setSourceDamage(previousID, currentID, damage);
+}
+
 void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
@@ -13,6 +13,8 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
@@ -24,6 +26,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
@@ -248,15 +251,69 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
                               context.mapping().layerMatrix(),
                               SkIRect(context.desiredOutput()),
                               srcGenID, srcSubset);
-    if (context.backend()->cache() && context.backend()->cache()->get(key, &result)) {
+    SkImageFilterCache* cache = context.backend()->cache();
+    if (cache && cache->get(key, &result)) {
         context.markCacheHit();
         return result;
     }
 
-    result = this->onFilterImage(context);
+    const SkIRect srcBounds = srcInKey ? SkIRect(context.source().layerBounds())
+                                       : SkIRect::MakeEmpty();
+    skif::FilterResult cached;
+    SkIRect sourceDamage;
+    std::optional<skif::LayerSpace<SkIRect>> damage;
+    if (cache && srcInKey && cache->getDamaged(key, srcBounds, &cached, &sourceDamage)) {
+        // The source only changed within 'sourceDamage' since 'cached' was filtered from it, so
+        // only the output that reads those pixels has to be filtered again.
+        damage = context.source().mapImageRect(sourceDamage.makeOffset(-srcSubset.topLeft()));
+        if (!damage->isEmpty()) {
+            damage = this->onGetDamagedLayerBounds(context.mapping(), *damage);
+        }
+    }
+    SkIVector translation;
+    SkIRect validBounds, uncovered;
+    if (damage) {
+        if (!damage->intersect(context.desiredOutput())) {
+            context.markCacheHit();
+            result = cached;
+        } else {
+            // The rest of the desired output is split into rects that don't overlap the damage or
+            // each other, so merging them matches filtering the whole region.
+            skif::FilterResult patch =
+                    this->onFilterImage(context.withNewDesiredOutput(*damage));
+            skif::FilterResult::Builder builder(context);
+            SkRegion unchanged(SkIRect(context.desiredOutput()));
+            unchanged.op(SkIRect(*damage), SkRegion::kDifference_Op);
+            for (SkRegion::Iterator iter(unchanged); !iter.done(); iter.next()) {
+                builder.add(cached.applyCrop(context, skif::LayerSpace<SkIRect>(iter.rect())));
+            }
+            result = builder.add(patch.applyCrop(context, *damage)).merge();
+        }
+    } else if (cache && cache->getOverlapping(key, srcBounds, &cached, &translation,
+                                              &validBounds, &uncovered)) {
+        cached = cached.applyTransform(
+                context,
+                skif::LayerSpace<SkMatrix>(SkMatrix::Translate(translation.fX, translation.fY)),
+                skif::FilterResult::kDefaultSampling);
+        if (uncovered.isEmpty()) {
+            context.markCacheHit();
+            return cached.applyCrop(context, context.desiredOutput());
+        }
+        // Only the strip the cached result doesn't cover is filtered; the two don't overlap, so
+        // merging them matches filtering the whole region.
+        const skif::LayerSpace<SkIRect> strip(uncovered);
+        skif::FilterResult stripResult =
+                this->onFilterImage(context.withNewDesiredOutput(strip));
+        result = skif::FilterResult::Builder(context)
+                .add(cached.applyCrop(context, skif::LayerSpace<SkIRect>(validBounds)))
+                .add(stripResult.applyCrop(context, strip))
+                .merge();
+    } else {
+        result = this->onFilterImage(context);
+    }
 
-    if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+    if (cache) {
+        cache->set(key, this, result, srcBounds);
     }
 
     return result;
@@ -380,11 +437,117 @@ std::optional<skif::LayerSpace<SkIRect>> SkImageFilter_Base::getChildOutputLayer
                        : contentBounds;
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkImageFilter_Base::getChildDamagedLayerBounds(
+        int index,
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // The damaged output of just childFilter, or 'damage' itself if the filter is null and the
+    // source image is used.
+    const SkImageFilter* childFilter = this->getInput(index);
+    return childFilter ? as_IFB(childFilter)->onGetDamagedLayerBounds(mapping, damage)
+                       : damage;
+}
+
+std::optional<skif::LayerSpace<SkIRect>> SkImageFilter_Base::onGetDamagedLayerBounds(
+        const skif::Mapping&,
+        const skif::LayerSpace<SkIRect>&) const {
+    if (!fUsesSrcInput) {
+        return skif::LayerSpace<SkIRect>::Empty();
+    }
+    return skif::LayerSpace<SkIRect>::Unbounded();
+}
+
 skif::FilterResult SkImageFilter_Base::getChildOutput(int index, const skif::Context& ctx) const {
     const SkImageFilter* input = this->getInput(index);
     return input ? as_IFB(input)->filterImage(ctx) : ctx.source();
 }
 
+namespace {
+
+// The number of filters evaluated for filter's subtree of the DAG, counting shared inputs once
+// for each path to them.
+int count_filters(const SkImageFilter* filter) {
+    if (!filter) {
+        return 0;
+    }
+    int count = 1;
+    for (int i = 0; i < filter->countInputs(); ++i) {
+        count += count_filters(filter->getInput(i));
+    }
+    return count;
+}
+
+} // anonymous namespace
+
+void SkImageFilter_Base::getChildOutputs(const skif::Context& ctx,
+                                         SkSpan<skif::FilterResult> outputs) const {
+    SkASSERT(outputs.size() == SkToSizeT(this->countInputs()));
+
+    // Inputs that are null use the source, and inputs shared by several branches of this filter
+    // are evaluated once; the remaining inputs are the independent branches.
+    skia_private::STArray<4, int> branches;
+    skia_private::STArray<4, int> evaluatedAs;
+    for (int i = 0; i < this->countInputs(); ++i) {
+        const SkImageFilter* input = this->getInput(i);
+        int first = i;
+        for (int j = 0; j < i; ++j) {
+            if (input && this->getInput(j) == input) {
+                first = j;
+                break;
+            }
+        }
+        evaluatedAs.push_back(first);
+        if (!input) {
+            outputs[i] = ctx.source();
+        } else if (first == i) {
+            branches.push_back(i);
+        }
+    }
+
+    SkExecutor* executor = ctx.backend()->executor();
+    if (!executor || branches.size() < 2) {
+        for (int i : branches) {
+            outputs[i] = this->getChildOutput(i, ctx);
+        }
+    } else {
+        // Each branch is assumed to hold an image the size of the desired output for each of its
+        // filters. Branches are started together until the next would not fit in the in-flight
+        // byte limit; one branch always runs, however large.
+        const SkIRect desiredOutput = SkIRect(ctx.desiredOutput());
+        const size_t imageBytes = SkColorTypeBytesPerPixel(ctx.backend()->colorType()) *
+                                  SkToSizeT(desiredOutput.width()) *
+                                  SkToSizeT(desiredOutput.height());
+        const size_t byteLimit = ctx.backend()->inFlightByteLimit();
+
+        skia_private::STArray<4, skif::Stats> stats;
+        stats.push_back_n(this->countInputs());
+        int next = 0;
+        while (next < branches.size()) {
+            SkTaskGroup taskGroup(*executor);
+            size_t inFlightBytes = 0;
+            do {
+                const int i = branches[next++];
+                inFlightBytes += imageBytes * count_filters(this->getInput(i));
+                taskGroup.add([&, i] {
+                    outputs[i] = this->getChildOutput(i, ctx.withNewStats(&stats[i]));
+                });
+            } while (next < branches.size() &&
+                     inFlightBytes + imageBytes * count_filters(this->getInput(branches[next])) <=
+                             byteLimit);
+            taskGroup.wait();
+        }
+        for (int i : branches) {
+            ctx.addStats(stats[i]);
+        }
+    }
+
+    for (int i = 0; i < this->countInputs(); ++i) {
+        if (evaluatedAs[i] != i) {
+            outputs[i] = outputs[evaluatedAs[i]];
+        }
+    }
+}
+
 void SkImageFilter_Base::PurgeCache() {
     auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo);
     if (cache) {
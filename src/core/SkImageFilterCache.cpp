@@ -7,15 +7,19 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include "include/core/SkPoint.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
 #include "src/base/SkTInternalLList.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkTDynamicHash.h"
 #include "src/core/SkTHash.h"
 
+#include <cstdint>
 #include <vector>
 
 using namespace skia_private;
@@ -28,21 +32,74 @@ using namespace skia_private;
 
 namespace {
 
+// Results that may serve each other's requests share a region key: the key without its clip
+// bounds and, when the matrix has no perspective, without the integer part of its translation,
+// which is returned in 'translation'.
+SkImageFilterCacheKey region_key(const SkImageFilterCacheKey& key, SkIVector* translation) {
+    SkMatrix matrix = key.fMatrix;
+    *translation = {0, 0};
+    if (!matrix.hasPerspective()) {
+        *translation = {sk_float_floor2int(matrix.getTranslateX()),
+                        sk_float_floor2int(matrix.getTranslateY())};
+        matrix.setTranslateX(matrix.getTranslateX() - translation->fX);
+        matrix.setTranslateY(matrix.getTranslateY() - translation->fY);
+    }
+    return SkImageFilterCacheKey(key.fUniqueID, matrix, SkIRect::MakeEmpty(),
+                                 key.fSrcGenID, key.fSrcSubset);
+}
+
+// Returns the part of 'clip' outside 'valid' if it is a single strip along one edge of 'clip',
+// or false if 'valid' doesn't cover the rest.
+bool uncovered_strip(const SkIRect& clip, const SkIRect& valid, SkIRect* strip) {
+    if (!SkIRect::Intersects(clip, valid)) {
+        return false;
+    }
+    if (valid.contains(clip)) {
+        *strip = SkIRect::MakeEmpty();
+        return true;
+    }
+    if (valid.fLeft <= clip.fLeft && valid.fRight >= clip.fRight) {
+        if (valid.fTop <= clip.fTop) {
+            *strip = {clip.fLeft, valid.fBottom, clip.fRight, clip.fBottom};
+            return true;
+        }
+        if (valid.fBottom >= clip.fBottom) {
+            *strip = {clip.fLeft, clip.fTop, clip.fRight, valid.fTop};
+            return true;
+        }
+    }
+    if (valid.fTop <= clip.fTop && valid.fBottom >= clip.fBottom) {
+        if (valid.fLeft <= clip.fLeft) {
+            *strip = {valid.fRight, clip.fTop, clip.fRight, clip.fBottom};
+            return true;
+        }
+        if (valid.fRight >= clip.fRight) {
+            *strip = {clip.fLeft, clip.fTop, valid.fLeft, clip.fBottom};
+            return true;
+        }
+    }
+    return false;
+}
+
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes)
+            : fSourceDamage(kMaxSourceDamage), fMaxBytes(maxBytes), fCurrentBytes(0) { }
     ~CacheImpl() override {
         fLookup.foreach([&](Value* v) { delete v; });
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, const SkIRect& srcBounds)
+            : fKey(key), fImage(image), fFilter(filter), fSrcBounds(srcBounds) {}
 
         Key fKey;
         skif::FilterResult fImage;
         const SkImageFilter* fFilter;
+        SkIRect fSrcBounds;
+        // Set when the value is also in fRegionValues.
+        bool fInRegion = false;
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
@@ -51,30 +108,129 @@ public:
         }
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
     };
+    struct KeyHash {
+        uint32_t operator()(const Key& key) const { return Value::Hash(key); }
+    };
 
     bool get(const Key& key, skif::FilterResult* result) const override {
         SkASSERT(result);
 
         SkAutoMutexExclusive mutex(fMutex);
+        fStats.fLookups++;
         if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
-
+            this->touch(v);
+            fStats.fHits++;
             *result = v->fImage;
             return true;
         }
         return false;
     }
 
+    bool getOverlapping(const Key& key, const SkIRect& srcBounds,
+                        skif::FilterResult* result, SkIVector* translation,
+                        SkIRect* validBounds, SkIRect* uncovered) const override {
+        SkASSERT(result && translation && validBounds && uncovered);
+
+        SkAutoMutexExclusive mutex(fMutex);
+        if (!fReuseOverlapping) {
+            return false;
+        }
+        SkIVector keyTranslation;
+        const std::vector<Value*>* values = fRegionValues.find(region_key(key, &keyTranslation));
+        if (!values) {
+            return false;
+        }
+
+        // Prefer a result that covers everything, then the one leaving the smallest strip.
+        Value* best = nullptr;
+        int64_t bestArea = 0;
+        for (Value* v : *values) {
+            SkIVector valueTranslation;
+            region_key(v->fKey, &valueTranslation);
+            const SkIVector d = keyTranslation - valueTranslation;
+            // The source must have moved with the layer matrix, if it's used at all.
+            if (srcBounds != v->fSrcBounds.makeOffset(d) &&
+                !(srcBounds.isEmpty() && v->fSrcBounds.isEmpty())) {
+                continue;
+            }
+            const SkIRect valid = v->fKey.fClipBounds.makeOffset(d);
+            SkIRect strip;
+            if (!uncovered_strip(key.fClipBounds, valid, &strip)) {
+                continue;
+            }
+            const int64_t area = strip.isEmpty() ? 0 : int64_t(strip.width()) * strip.height();
+            if (!best || area < bestArea) {
+                best = v;
+                bestArea = area;
+                *translation = d;
+                *validBounds = valid;
+                *uncovered = strip;
+                if (area == 0) {
+                    break;
+                }
+            }
+        }
+        if (!best) {
+            return false;
+        }
+        this->touch(best);
+        if (uncovered->isEmpty()) {
+            fStats.fOverlappingHits++;
+        } else {
+            fStats.fPartialHits++;
+        }
+        *result = best->fImage;
+        return true;
+    }
+
+    void setReuseOverlapping(bool reuseOverlapping) override {
+        SkAutoMutexExclusive mutex(fMutex);
+        fReuseOverlapping = reuseOverlapping;
+    }
+
+    void setSourceDamage(uint32_t previousID, uint32_t currentID,
+                         const SkIRect& damage) override {
+        SkAutoMutexExclusive mutex(fMutex);
+        fSourceDamage.insert_or_update(currentID, {previousID, damage});
+    }
+
+    bool getDamaged(const Key& key, const SkIRect& srcBounds,
+                    skif::FilterResult* result, SkIRect* damage) const override {
+        SkASSERT(result && damage);
+
+        SkAutoMutexExclusive mutex(fMutex);
+        if (key.fSrcGenID == SK_InvalidUniqueID) {
+            return false;
+        }
+        const SourceDamage* sourceDamage = fSourceDamage.find(key.fSrcGenID);
+        if (!sourceDamage) {
+            return false;
+        }
+        Key previousKey = key;
+        previousKey.fSrcGenID = sourceDamage->fPreviousID;
+        Value* v = fLookup.find(previousKey);
+        if (!v || v->fSrcBounds != srcBounds) {
+            return false;
+        }
+        this->touch(v);
+        fStats.fDamagedHits++;
+        *result = v->fImage;
+        *damage = sourceDamage->fDamage;
+        return true;
+    }
+
+    Stats stats() const override {
+        SkAutoMutexExclusive mutex(fMutex);
+        return fStats;
+    }
+
     void set(const Key& key, const SkImageFilter* filter,
-             const skif::FilterResult& result) override {
+             const skif::FilterResult& result, const SkIRect& srcBounds) override {
         SkAutoMutexExclusive mutex(fMutex);
         if (Value* v = fLookup.find(key)) {
             this->removeInternal(v);
         }
-        Value* v = new Value(key, result, filter);
+        Value* v = new Value(key, result, filter, srcBounds);
         fLookup.add(v);
         fLRU.addToHead(v);
         fCurrentBytes += result.image() ? result.image()->getSize() : 0;
@@ -83,6 +239,16 @@ public:
         } else {
             fImageFilterValues.set(filter, {v});
         }
+        if (fReuseOverlapping) {
+            SkIVector translation;
+            const Key regionKey = region_key(key, &translation);
+            if (auto* values = fRegionValues.find(regionKey)) {
+                values->push_back(v);
+            } else {
+                fRegionValues.set(regionKey, {v});
+            }
+            v->fInRegion = true;
+        }
 
         while (fCurrentBytes > fMaxBytes) {
             Value* tail = fLRU.tail();
@@ -96,6 +262,7 @@ public:
 
     void purge() override {
         SkAutoMutexExclusive mutex(fMutex);
+        fSourceDamage.reset();
         while (fCurrentBytes > 0) {
             Value* tail = fLRU.tail();
             SkASSERT(tail);
@@ -120,18 +287,40 @@ public:
 
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
+    void touch(Value* v) const {
+        if (v != fLRU.head()) {
+            fLRU.remove(v);
+            fLRU.addToHead(v);
+        }
+    }
+
+    static void RemoveValue(std::vector<Value*>* values, Value* v) {
+        for (auto it = values->begin(); it != values->end(); ++it) {
+            if (*it == v) {
+                values->erase(it);
+                break;
+            }
+        }
+    }
+
     void removeInternal(Value* v) {
         if (v->fFilter) {
             if (auto* values = fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
                     fImageFilterValues.remove(v->fFilter);
                 } else {
-                    for (auto it = values->begin(); it != values->end(); ++it) {
-                        if (*it == v) {
-                            values->erase(it);
-                            break;
-                        }
-                    }
+                    RemoveValue(values, v);
+                }
+            }
+        }
+        if (v->fInRegion) {
+            SkIVector translation;
+            const Key regionKey = region_key(v->fKey, &translation);
+            if (auto* values = fRegionValues.find(regionKey)) {
+                if (values->size() == 1 && (*values)[0] == v) {
+                    fRegionValues.remove(regionKey);
+                } else {
+                    RemoveValue(values, v);
                 }
             }
         }
@@ -141,12 +330,23 @@ private:
         delete v;
     }
 private:
+    struct SourceDamage {
+        uint32_t fPreviousID;
+        SkIRect  fDamage;
+    };
+
     SkTDynamicHash<Value, Key>                          fLookup;
     mutable SkTInternalLList<Value>                     fLRU;
     // Value* always points to an item in fLookup.
     THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+    // The values in each region (see region_key()), when reusing overlapping results.
+    THashMap<Key, std::vector<Value*>, KeyHash>         fRegionValues;
+    // The damage recorded for each source image, by its unique ID.
+    mutable SkLRUCache<uint32_t, SourceDamage>          fSourceDamage;
     size_t                                              fMaxBytes;
     size_t                                              fCurrentBytes;
+    bool                                                fReuseOverlapping = false;
+    mutable Stats                                       fStats;
     mutable SkMutex                                     fMutex;
 };
 
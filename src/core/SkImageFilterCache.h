@@ -70,9 +70,50 @@ public:
     virtual bool get(const SkImageFilterCacheKey& key,
                      skif::FilterResult* result) const = 0;
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
-    // results when it is destroyed.
+    // results when it is destroyed. 'srcBounds' are the layer-space bounds of the source image
+    // the result was filtered from, or empty if it didn't use the source.
     virtual void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
-                     const skif::FilterResult& result) = 0;
+                     const skif::FilterResult& result,
+                     const SkIRect& srcBounds = SkIRect::MakeEmpty()) = 0;
+
+    // When the cache reuses overlapping results, a request that misses in get() can still be served
+    // by a result of the same filter and source image that was computed for another region, or
+    // for a layer matrix that differs from the key's by only an integer translation (as when a
+    // layer scrolls). Returns true if such a result covers all of the key's clip bounds, or all
+    // but one strip along an edge of them. 'result' is then the cached result in its own layer
+    // space, 'translation' maps that to the key's layer space, 'validBounds' is the region it was
+    // computed for in the key's layer space, and 'uncovered' is the strip of the key's clip bounds
+    // left to compute (empty when the result covers it all).
+    virtual bool getOverlapping(const SkImageFilterCacheKey& key, const SkIRect& srcBounds,
+                                skif::FilterResult* result, SkIVector* translation,
+                                SkIRect* validBounds, SkIRect* uncovered) const = 0;
+
+    // Off by default, since results for regions that are never requested again stay cached.
+    virtual void setReuseOverlapping(bool reuseOverlapping) = 0;
+
+    // Records that the source image with unique ID 'currentID' has the same pixels as the one with
+    // 'previousID' except within 'damage', in the pixel coordinates of the images, as when it is
+    // the next frame of an animation. Only the kMaxSourceDamage most recent records are kept.
+    static constexpr int kMaxSourceDamage = 64;
+    virtual void setSourceDamage(uint32_t previousID, uint32_t currentID,
+                                 const SkIRect& damage) = 0;
+
+    // Returns true if the key's source image was recorded as a damaged version of another image,
+    // and the result of the same request filtered from that image, placed at the same 'srcBounds',
+    // is cached. 'result' is then that result and 'damage' the recorded damage, so a request that
+    // misses in get() can patch the result by filtering only the output that the damage reaches.
+    virtual bool getDamaged(const SkImageFilterCacheKey& key, const SkIRect& srcBounds,
+                            skif::FilterResult* result, SkIRect* damage) const = 0;
+
+    struct Stats {
+        int fLookups = 0;          // Requests looked up with get()
+        int fHits = 0;             // ... found with the same key
+        int fOverlappingHits = 0;  // ... covered by a result for another region or translation
+        int fPartialHits = 0;      // ... covered except for an edge strip, which was recomputed
+        int fDamagedHits = 0;      // ... patched from the result for a damaged source
+    };
+    virtual Stats stats() const = 0;
+
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
@@ -40,6 +40,7 @@
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 namespace skif {
@@ -176,6 +177,10 @@ std::optional<LayerSpace<SkMatrix>> periodic_axis_transform(
     }
 }
 
+// See SetRasterExecutor().
+std::atomic<SkExecutor*> gRasterExecutor{nullptr};
+std::atomic<size_t> gRasterInFlightByteLimit{0};
+
 class RasterBackend : public Backend {
 public:
 
@@ -210,6 +215,13 @@ public:
     }
 #endif
 
+    SkExecutor* executor() const override {
+        return gRasterExecutor.load(std::memory_order_relaxed);
+    }
+    size_t inFlightByteLimit() const override {
+        return gRasterInFlightByteLimit.load(std::memory_order_relaxed);
+    }
+
 };
 
 } // anonymous namespace
@@ -225,6 +237,11 @@ Backend::Backend(sk_sp<SkImageFilterCache> cache,
 
 Backend::~Backend() = default;
 
+void SetRasterExecutor(SkExecutor* executor, size_t inFlightByteLimit) {
+    gRasterInFlightByteLimit.store(inFlightByteLimit, std::memory_order_relaxed);
+    gRasterExecutor.store(executor, std::memory_order_relaxed);
+}
+
 sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType) {
     // TODO (skbug:14286): Remove this forcing to 8888. Many legacy image filters only support
     // N32 on CPU, but once they are implemented in terms of draws and SkSL they will support
@@ -637,6 +654,54 @@ std::pair<sk_sp<SkSpecialImage>, LayerSpace<SkIPoint>>FilterResult::imageAndOffs
     return {resolved.fImage, resolved.layerBounds().topLeft()};
 }
 
+std::optional<std::pair<SkBitmap, LayerSpace<SkIPoint>>> FilterResult::asN32Bitmap(
+        const Context& ctx) const {
+    if (!fImage || fImage->isGaneshBacked() || fImage->isGraphiteBacked()) {
+        return std::nullopt;
+    }
+
+    auto [image, origin] = this->imageAndOffset(ctx);
+    SkBitmap bitmap;
+    if (image && (!SkSpecialImages::AsBitmap(image.get(), &bitmap) ||
+                  (bitmap.colorType() != kRGBA_8888_SkColorType &&
+                   bitmap.colorType() != kBGRA_8888_SkColorType) ||
+                  bitmap.alphaType() != kPremul_SkAlphaType)) {
+        return std::nullopt;
+    }
+    return std::make_pair(std::move(bitmap), origin);
+}
+
+bool FilterResult::AllocRaster(const Context& ctx, SkColorType colorType,
+                               const LayerSpace<SkIRect>& dstBounds, SkBitmap* dst) {
+    return dst->tryAllocPixels(SkImageInfo::Make(SkISize(dstBounds.size()), colorType,
+                                                 kPremul_SkAlphaType, ctx.refColorSpace()));
+}
+
+FilterResult FilterResult::WrapRaster(const Context& ctx, SkBitmap* dst,
+                                      const LayerSpace<SkIRect>& dstBounds) {
+    dst->setImmutable();
+    return FilterResult(SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst->dimensions()), *dst,
+                                                        ctx.backend()->surfaceProps()),
+                        dstBounds.topLeft());
+}
+
+LayerSpace<SkIRect> FilterResult::mapImageRect(const SkIRect& imageRect) const {
+    if (!fImage || imageRect.isEmpty()) {
+        return LayerSpace<SkIRect>::Empty();
+    }
+    if (fTileMode != SkTileMode::kDecal) {
+        return fLayerBounds;
+    }
+    LayerSpace<SkIRect> mapped = fTransform.mapRect(LayerSpace<SkIRect>(imageRect));
+    if (!is_nearly_integer_translation(fTransform)) {
+        mapped.outset(LayerSpace<SkISize>({1, 1}));
+    }
+    if (!mapped.intersect(fLayerBounds)) {
+        return LayerSpace<SkIRect>::Empty();
+    }
+    return mapped;
+}
+
 FilterResult FilterResult::insetForSaveLayer() const {
     if (!fImage) {
         return {};
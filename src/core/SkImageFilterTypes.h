@@ -8,8 +8,10 @@
 #ifndef SkImageFilterTypes_DEFINED
 #define SkImageFilterTypes_DEFINED
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
@@ -33,16 +35,15 @@
 #include <utility>
 
 class FilterResultTestAccess;  // for testing
-class SkBitmap;
 class SkBlender;
 class SkBlurEngine;
 class SkDevice;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageFilterCache;
 class SkPicture;
 class SkShader;
-enum SkColorType : int;
 
 // The skif (SKI[mage]F[ilter]) namespace contains types that are used for filter implementations.
 // The defined types come in two groups: users of internal Skia types, and templates to help with
@@ -746,6 +747,11 @@ public:
 
     const SkColorFilter* colorFilter() const { return fColorFilter.get(); }
 
+    // Get the layer-space pixels that read 'imageRect', in the pixel coordinates of image(). This
+    // includes the neighbors that sampling blends in when the transform isn't an integer
+    // translation, and all of the layer bounds when the image is tiled.
+    LayerSpace<SkIRect> mapImageRect(const SkIRect& imageRect) const;
+
     // Produce a new FilterResult that has been cropped to 'crop', taking into account the context's
     // desired output. When possible, the returned FilterResult will reuse the underlying image and
     // adjust its metadata. This will depend on the current transform and tile mode as well as how
@@ -783,6 +789,30 @@ public:
     // away entirely.
     std::pair<sk_sp<SkSpecialImage>, LayerSpace<SkIPoint>> imageAndOffset(const Context& ctx) const;
 
+    // For filters that compute their output on the CPU: resolves this FilterResult over the
+    // Context's desired output (like imageAndOffset()) and returns its pixels as an N32 premul
+    // bitmap with its layer-space origin. The bitmap is null if the resolved image is fully
+    // transparent. Returns nullopt if the image is GPU-backed or not N32 premul, in which case the
+    // filter should fall back to evaluating a shader with a Builder.
+    std::optional<std::pair<SkBitmap, LayerSpace<SkIPoint>>> asN32Bitmap(const Context& ctx) const;
+
+    // Allocates premul pixels of 'colorType' covering 'dstBounds', lets 'fillFn' write every pixel
+    // and returns them as a FilterResult positioned at 'dstBounds'. 'fillFn' should be an
+    // invokable type with the signature (const SkPixmap&)->void. Returns nullopt if the pixels
+    // could not be allocated.
+    template <typename FillFn>
+    static std::optional<FilterResult> MakeFromRaster(const Context& ctx,
+                                                      SkColorType colorType,
+                                                      const LayerSpace<SkIRect>& dstBounds,
+                                                      FillFn fillFn) {
+        SkBitmap dst;
+        if (!AllocRaster(ctx, colorType, dstBounds, &dst)) {
+            return std::nullopt;
+        }
+        fillFn(dst.pixmap());
+        return WrapRaster(ctx, &dst, dstBounds);
+    }
+
      // Draw this FilterResult into 'target' by applying the remaining layer-to-device transform of
      // 'mapping', using the provided 'blender' to composite the effective image on top of 'target'.
      // If 'blender' is null, it's equivalent to kSrcOver blending.
@@ -841,6 +871,12 @@ private:
     // is true.
     FilterResult resolve(const Context& ctx, LayerSpace<SkIRect> dstBounds,
                          bool preserveDstBounds=false) const;
+    // The non-template halves of MakeFromRaster(): allocate the destination pixels in the
+    // Context's color space, and wrap the filled, now immutable, pixels as a FilterResult.
+    static bool AllocRaster(const Context& ctx, SkColorType colorType,
+                            const LayerSpace<SkIRect>& dstBounds, SkBitmap* dst);
+    static FilterResult WrapRaster(const Context& ctx, SkBitmap* dst,
+                                   const LayerSpace<SkIRect>& dstBounds);
     // Returns a decal-tiled subset view of this FilterResult, requiring that this has an integer
     // translation equivalent to 'knownOrigin'. If 'clampSrcIfDisjoint' is true and the image bounds
     // do not overlap with dstBounds, the closest edge/corner pixels of the image will be extracted,
@@ -1112,6 +1148,12 @@ public:
 
     SkImageFilterCache* cache() const { return fCache.get(); }
 
+    // Independent inputs of a filter may be evaluated concurrently on this executor, as long as
+    // the images they are expected to need at once fit in the in-flight byte limit. Backends whose
+    // devices may only be used from one thread return nullptr.
+    virtual SkExecutor* executor() const { return nullptr; }
+    virtual size_t inFlightByteLimit() const { return 0; }
+
 protected:
     Backend(sk_sp<SkImageFilterCache> cache,
             const SkSurfaceProps& surfaceProps,
@@ -1125,6 +1167,9 @@ private:
 
 sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType);
 
+// Set the executor and in-flight byte limit of raster backends; see Backend::executor().
+void SetRasterExecutor(SkExecutor* executor, size_t inFlightByteLimit);
+
 // Stats for a single image filter evaluation
 struct Stats {
     int fNumVisitedImageFilters = 0; // size of the filter dag
@@ -1133,6 +1178,14 @@ struct Stats {
     int fNumShaderClampedDraws = 0; // shader-emulated clamp is fairly cheap but HW tiling is best
     int fNumShaderBasedTilingDraws = 0; // shader-emulated decal, mirror, repeat are expensive
 
+    void add(const Stats& other) {
+        fNumVisitedImageFilters += other.fNumVisitedImageFilters;
+        fNumCacheHits += other.fNumCacheHits;
+        fNumOffscreenSurfaces += other.fNumOffscreenSurfaces;
+        fNumShaderClampedDraws += other.fNumShaderClampedDraws;
+        fNumShaderBasedTilingDraws += other.fNumShaderBasedTilingDraws;
+    }
+
     void dumpStats() const;   // log to std out
     void reportStats() const; // trace event counters
 };
@@ -1215,7 +1268,20 @@ public:
     }
 
 
+    // Create a new context that matches this context, but records its stats in 'stats', so that
+    // it can be used on another thread. They are added back with addStats() once it is done.
+    Context withNewStats(Stats* stats) const {
+        Context c = *this;
+        c.fStats = stats;
+        return c;
+    }
+
     // Stats tracking
+    void addStats(const Stats& stats) const {
+        if (fStats) {
+            fStats->add(stats);
+        }
+    }
     void markVisitedImageFilter() const {
         if (fStats) {
             fStats->fNumVisitedImageFilters++;
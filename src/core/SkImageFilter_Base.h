@@ -189,6 +189,10 @@ protected:
             int index,
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const;
+    std::optional<skif::LayerSpace<SkIRect>> getChildDamagedLayerBounds(
+            int index,
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const;
 
     // Helper function for recursing through the filter DAG. It automatically evaluates the input
     // image filter at 'index' using the given context. If the input image filter is null, it
@@ -199,6 +203,10 @@ protected:
     // `withNewDesiredOutput`.
     skif::FilterResult getChildOutput(int index, const skif::Context& ctx) const;
 
+    // Evaluates every input with the same context, as getChildOutput() would, into outputs. When
+    // the backend has an executor, independent input filters are evaluated on it concurrently.
+    void getChildOutputs(const skif::Context& ctx, SkSpan<skif::FilterResult> outputs) const;
+
 private:
     friend class SkImageFilter;
     // For PurgeCache()
@@ -299,6 +307,21 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const = 0;
 
+    /**
+     *  Calculates the region of this filter node's output that can change when the source image
+     *  changes only within 'damage', e.g. when an animated source is drawn again. Unlike the
+     *  output bounds, this has to account for every output pixel that reads the damaged pixels,
+     *  whether or not they are transparent. Like onGetOutputLayerBounds(), this is responsible for
+     *  recursing to its children.
+     *
+     *  If any of the output can change, subclasses should return LayerSpace<SkIRect>::Unbounded(),
+     *  which children's damage bounds can also be. The default implementation returns Unbounded()
+     *  unless the node doesn't use the source at all, in which case nothing changes.
+     */
+    virtual std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const;
+
     skia_private::AutoSTArray<2, sk_sp<SkImageFilter>> fInputs;
 
     bool fUsesSrcInput;
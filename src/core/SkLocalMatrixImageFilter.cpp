@@ -78,6 +78,12 @@ std::optional<skif::LayerSpace<SkIRect>> SkLocalMatrixImageFilter::onGetOutputLa
     return this->getChildOutputLayerBounds(0, this->localMapping(mapping), contentBounds);
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkLocalMatrixImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    return this->getChildDamagedLayerBounds(0, this->localMapping(mapping), damage);
+}
+
 SkRect SkLocalMatrixImageFilter::computeFastBounds(const SkRect& bounds) const {
     // In onGet[Input|Output]LayerBounds, there is a Mapping that can be adjusted by the
     // local matrix, so their layer-space parameters do not need to be modified. Since
@@ -57,6 +57,10 @@ private:
             const skif::Mapping&,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping&,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     skif::Mapping localMapping(const skif::Mapping&) const;
 
     // NOTE: This is not a ParameterSpace<SkMatrix> like that of SkMatrixTransformImageFilter.
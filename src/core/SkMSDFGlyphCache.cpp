@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkMSDFGlyphCache.h"
+
+#include "include/core/SkColorType.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkFontTypes.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkScalar.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkMultiDistanceFieldGen.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
+
+#include <utility>
+
+SkMSDFGlyphCache::SkMSDFGlyphCache(int maxGlyphCount) : fFields(maxGlyphCount) {}
+
+SkMatrix SkMSDFGlyphCache::FieldToDevice(const SkFont& font, SkPoint origin) {
+    const float scale = font.getSize() / kFieldSize;
+    return SkMatrix::Translate(origin.fX, origin.fY) *
+           SkMatrix::MakeAll(font.getScaleX(), font.getSkewX(), 0,
+                             0,                 1,               0,
+                             0,                 0,               1) *
+           SkMatrix::Scale(scale, scale);
+}
+
+std::shared_ptr<const SkMSDFGlyphCache::Field> SkMSDFGlyphCache::findOrCreateField(
+        const SkFont& font, SkGlyphID glyph) {
+    const uint64_t key = (static_cast<uint64_t>(font.getTypeface()->uniqueID()) << 32) | glyph;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (std::shared_ptr<const Field>* field = fFields.find(key)) {
+            return *field;
+        }
+    }
+
+    // Generate outside the lock; a racing thread generates the same field.
+    SkFont fieldFont(font.refTypeface(), kFieldSize);
+    fieldFont.setHinting(SkFontHinting::kNone);
+    SkPath path;
+    std::shared_ptr<Field> field;
+    if (fieldFont.getPath(glyph, &path) && !path.getBounds().isEmpty()) {
+        field = std::make_shared<Field>();
+        field->fOutlineBounds = path.getBounds();
+        const int pad = SkScalarCeilToInt(kFieldRange);
+        field->fBounds = field->fOutlineBounds.roundOut().makeOutset(pad, pad);
+        field->fPixels.resize(field->fBounds.width() * field->fBounds.height() * 4);
+        if (!SkGenerateMultiDistanceField(field->fPixels.data(), field->fBounds.width() * 4,
+                                          path, field->fBounds, kFieldRange)) {
+            field = nullptr;
+        }
+    }
+
+    SkAutoMutexExclusive lock(fMutex);
+    return *fFields.insert_or_update(key, std::move(field));
+}
+
+SkIRect SkMSDFGlyphCache::glyphBounds(const SkFont& font, SkGlyphID glyph, SkPoint origin) {
+    std::shared_ptr<const Field> field = this->findOrCreateField(font, glyph);
+    if (!field) {
+        return SkIRect::MakeEmpty();
+    }
+    // Coverage ramps over the pixel either side of the outline.
+    return FieldToDevice(font, origin).mapRect(field->fOutlineBounds).roundOut().makeOutset(1, 1);
+}
+
+bool SkMSDFGlyphCache::drawGlyph(const SkFont& font, SkGlyphID glyph, SkPoint origin,
+                                 const SkPixmap& dst, SkIPoint dstOrigin) {
+    SkASSERT(dst.colorType() == kAlpha_8_SkColorType);
+    std::shared_ptr<const Field> field = this->findOrCreateField(font, glyph);
+    if (!field || dst.width() <= 0 || dst.height() <= 0) {
+        return false;
+    }
+
+    // Pipeline coordinates are dst pixels; field pixel centers are at +0.5, as bilerp expects.
+    SkMatrix dstToField;
+    if (!FieldToDevice(font, origin).invert(&dstToField)) {
+        return false;
+    }
+    dstToField.postTranslate(-field->fBounds.fLeft, -field->fBounds.fTop);
+    dstToField.preTranslate(dstOrigin.fX, dstOrigin.fY);
+
+    SkRasterPipeline_GatherCtx gather;
+    gather.pixels = field->fPixels.data();
+    gather.stride = field->fBounds.width();
+    gather.width  = field->fBounds.width();
+    gather.height = field->fBounds.height();
+    // Coverage goes from 0 to 1 over one device pixel across the outline.
+    SkRasterPipeline_MSDFCtx msdf = {2 * kFieldRange * font.getSize() / kFieldSize};
+    SkRasterPipeline_MemoryCtx store = {dst.writable_addr(), SkToInt(dst.rowBytesAsPixels())};
+
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipelineOp::seed_shader);
+    p.appendMatrix(&alloc, dstToField);
+    p.append(SkRasterPipelineOp::bilerp_clamp_8888, &gather);
+    p.append(SkRasterPipelineOp::msdf_coverage, &msdf);
+    p.appendStore(kAlpha_8_SkColorType, &store);
+    p.run(0, 0, dst.width(), dst.height());
+    return true;
+}
+
+size_t SkMSDFGlyphCache::bytesUsed() {
+    SkAutoMutexExclusive lock(fMutex);
+    size_t bytes = 0;
+    fFields.foreach([&](uint64_t*, std::shared_ptr<const Field>* field) {
+        bytes += *field ? (*field)->fPixels.size() : 0;
+    });
+    return bytes;
+}
+
+int SkMSDFGlyphCache::count() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fFields.count();
+}
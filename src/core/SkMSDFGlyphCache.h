@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMSDFGlyphCache_DEFINED
+#define SkMSDFGlyphCache_DEFINED
+
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkLRUCache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SkFont;
+class SkMatrix;
+class SkPixmap;
+
+// A cache of multi-channel distance field glyphs (see SkMultiDistanceFieldGen.h). Each glyph is
+// generated once, from its path at kFieldSize pixels per em, and rendered from that field at any
+// size by the msdf_coverage raster pipeline stage. Unlike a strike, one entry serves every size,
+// so large or zooming text doesn't rasterize and cache each glyph again for each size.
+class SkMSDFGlyphCache {
+public:
+    // Glyphs are generated with this many pixels per em...
+    static constexpr float kFieldSize = 32;
+    // ... and distances up to this many of those pixels from the outline.
+    static constexpr float kFieldRange = 4;
+
+    explicit SkMSDFGlyphCache(int maxGlyphCount = 1024);
+
+    // The device pixels covered by glyph of font drawn at origin, or empty if it has no outline.
+    // Only the font's size, scale and skew are used; the glyph is unhinted.
+    SkIRect glyphBounds(const SkFont&, SkGlyphID, SkPoint origin);
+
+    // Render the coverage of glyph of font drawn at origin into dst, an A8 pixmap whose top left
+    // pixel is at device position dstOrigin. Returns false if the glyph has no outline.
+    bool drawGlyph(const SkFont&, SkGlyphID, SkPoint origin, const SkPixmap& dst,
+                   SkIPoint dstOrigin);
+
+    // The bytes of pixels held by the cached fields.
+    size_t bytesUsed();
+    int count() const;
+
+private:
+    struct Field {
+        SkRect  fOutlineBounds;  // In pixels at kFieldSize, relative to the glyph origin.
+        SkIRect fBounds;         // The area covered by fPixels, in the same units.
+        std::vector<uint8_t> fPixels;  // RGBA 8888, fBounds.width() * 4 bytes per row.
+    };
+
+    // Returns the glyph's field, generating it on first use; nullptr if it has no outline.
+    std::shared_ptr<const Field> findOrCreateField(const SkFont&, SkGlyphID);
+    // Maps pixels at kFieldSize, relative to the glyph origin, to the device for glyph of font
+    // drawn at origin.
+    static SkMatrix FieldToDevice(const SkFont&, SkPoint origin);
+
+    mutable SkMutex fMutex;
+    SkLRUCache<uint64_t, std::shared_ptr<const Field>> fFields SK_GUARDED_BY(fMutex);
+};
+
+#endif  // SkMSDFGlyphCache_DEFINED
@@ -0,0 +1,308 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkMultiDistanceFieldGen.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace skia_private;
+
+namespace {
+
+// The channels an edge contributes to.
+enum EdgeColor : uint8_t {
+    kRed   = 1,
+    kGreen = 2,
+    kBlue  = 4,
+    kYellow  = kRed | kGreen,
+    kMagenta = kRed | kBlue,
+    kCyan    = kGreen | kBlue,
+    kWhite   = kRed | kGreen | kBlue,
+};
+
+// Curves are flattened into segments about this long, in path units. Glyphs are generated at a
+// few dozen pixels per em, so the polyline stays well within a hundredth of a pixel of the curve.
+constexpr float kSegmentLength = 1.0f;
+constexpr int kMaxSegments = 64;
+
+// Edges meeting at an angle sharper than about 3 radians of turn are treated as a corner.
+constexpr float kCornerSin = 0.14112f;  // sin(3)
+
+// One verb of the outline, a line or a flattened curve, and the channels it contributes to.
+struct Edge {
+    TArray<SkPoint> fPoints;
+    uint8_t fColor = kWhite;
+
+    SkVector startDirection() const { return fPoints[1] - fPoints[0]; }
+    SkVector endDirection() const { return fPoints.back() - fPoints[fPoints.size() - 2]; }
+};
+using Contour = TArray<Edge>;
+
+int segment_count(const SkPoint pts[], int count) {
+    float length = 0;
+    for (int i = 1; i < count; ++i) {
+        length += SkPoint::Distance(pts[i - 1], pts[i]);
+    }
+    return SkTPin(SkScalarCeilToInt(length / kSegmentLength), 1, kMaxSegments);
+}
+
+template <typename Eval>
+void add_edge(Contour* contour, const SkPoint& start, int segments, Eval&& eval) {
+    Edge edge;
+    edge.fPoints.push_back(start);
+    for (int i = 1; i <= segments; ++i) {
+        SkPoint p = eval(static_cast<float>(i) / segments);
+        if (p != edge.fPoints.back()) {
+            edge.fPoints.push_back(p);
+        }
+    }
+    if (edge.fPoints.size() >= 2) {
+        contour->push_back(std::move(edge));
+    }
+}
+
+TArray<Contour> make_contours(const SkPath& path) {
+    TArray<Contour> contours;
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    for (SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+        if (verb == SkPath::kMove_Verb) {
+            contours.push_back();
+            continue;
+        }
+        if (contours.empty()) {
+            continue;
+        }
+        Contour* contour = &contours.back();
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                add_edge(contour, pts[0], 1, [&](float) { return pts[1]; });
+                break;
+            case SkPath::kQuad_Verb:
+                add_edge(contour, pts[0], segment_count(pts, 3), [&](float t) {
+                    return SkEvalQuadAt(pts, t);
+                });
+                break;
+            case SkPath::kConic_Verb: {
+                SkConic conic(pts, iter.conicWeight());
+                add_edge(contour, pts[0], segment_count(pts, 3), [&](float t) {
+                    return conic.evalAt(t);
+                });
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                add_edge(contour, pts[0], segment_count(pts, 4), [&](float t) {
+                    SkPoint p;
+                    SkEvalCubicAt(pts, t, &p, nullptr, nullptr);
+                    return p;
+                });
+                break;
+            default:
+                break;
+        }
+    }
+    TArray<Contour> nonEmpty;
+    for (Contour& contour : contours) {
+        if (!contour.empty()) {
+            nonEmpty.push_back(std::move(contour));
+        }
+    }
+    return nonEmpty;
+}
+
+bool is_corner(SkVector in, SkVector out) {
+    if (!in.normalize() || !out.normalize()) {
+        return false;
+    }
+    return SkPoint::DotProduct(in, out) <= 0 ||
+           std::abs(SkPoint::CrossProduct(in, out)) > kCornerSin;
+}
+
+uint8_t switch_color(uint8_t color, uint8_t banned) {
+    static constexpr uint8_t kColors[] = {kCyan, kMagenta, kYellow};
+    int start = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (kColors[i] == color) {
+            start = i + 1;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        uint8_t candidate = kColors[(start + i) % 3];
+        if (candidate != color && candidate != banned) {
+            return candidate;
+        }
+    }
+    SkUNREACHABLE;
+}
+
+// Colors the edges so the two edges at every corner share exactly one channel. Smooth contours
+// stay white; their single-channel distance is already exact.
+void color_edges(Contour* contour) {
+    const int n = contour->size();
+    STArray<16, int> corners;
+    for (int i = 0; i < n; ++i) {
+        if (is_corner((*contour)[(i + n - 1) % n].endDirection(),
+                      (*contour)[i].startDirection())) {
+            corners.push_back(i);
+        }
+    }
+    if (corners.empty()) {
+        return;
+    }
+    if (corners.size() == 1) {
+        // A teardrop: split the contour into thirds starting at its one corner.
+        if (n < 3) {
+            return;
+        }
+        static constexpr uint8_t kThirds[] = {kMagenta, kWhite, kYellow};
+        for (int i = 0; i < n; ++i) {
+            (*contour)[(corners[0] + i) % n].fColor = kThirds[3 * i / n];
+        }
+        return;
+    }
+
+    const uint8_t initial = kCyan;
+    uint8_t color = initial;
+    int spline = 0;
+    for (int i = 0; i < n; ++i) {
+        const int index = (corners[0] + i) % n;
+        if (spline + 1 < corners.size() && corners[spline + 1] == index) {
+            ++spline;
+            // The last spline meets the first at corners[0], so it may not reuse its color.
+            color = switch_color(color, spline == corners.size() - 1 ? initial : 0);
+        }
+        (*contour)[index].fColor = color;
+    }
+}
+
+// The closest segment to a point found so far.
+struct Nearest {
+    float       fDistance = SK_FloatInfinity;
+    float       fOrthogonality = 0;
+    const Edge* fEdge = nullptr;
+    int         fSegment = 0;
+    float       fT = 0;  // Unclamped parameter of the closest point on the segment's line.
+
+    void update(float distance, float orthogonality, const Edge* edge, int segment, float t) {
+        // Segments meeting at a vertex are equally close; the one the point is more squarely
+        // in front of decides the sign.
+        constexpr float kTolerance = 1e-5f;
+        if (distance < fDistance - kTolerance ||
+            (distance < fDistance + kTolerance && orthogonality > fOrthogonality)) {
+            fDistance = distance;
+            fOrthogonality = orthogonality;
+            fEdge = edge;
+            fSegment = segment;
+            fT = t;
+        }
+    }
+
+    // The distance, signed by which side of the segment p is on. Beyond the ends of an edge
+    // this is the distance to the edge's extension (the pseudo-distance), which is what keeps
+    // the channels straight up to a corner.
+    float signedDistance(SkPoint p) const {
+        if (!fEdge) {
+            return -SK_FloatInfinity;
+        }
+        const SkPoint a = fEdge->fPoints[fSegment];
+        const SkVector ab = fEdge->fPoints[fSegment + 1] - a;
+        const float cross = SkPoint::CrossProduct(ab, p - a);
+        const float sign = cross < 0 ? -1.0f : 1.0f;
+        const bool beyondStart = fSegment == 0 && fT < 0;
+        const bool beyondEnd = fSegment == fEdge->fPoints.size() - 2 && fT > 1;
+        if (beyondStart || beyondEnd) {
+            return cross / ab.length();
+        }
+        return sign * fDistance;
+    }
+};
+
+float median(float a, float b, float c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+}  // namespace
+
+bool SkGenerateMultiDistanceField(uint8_t* dst, size_t rowBytes, const SkPath& path,
+                                  const SkIRect& bounds, float range) {
+    if (!dst || bounds.isEmpty() || !(range > 0)) {
+        return false;
+    }
+
+    TArray<Contour> contours = make_contours(path);
+    for (Contour& contour : contours) {
+        color_edges(&contour);
+    }
+
+    const float scale = 1.0f / (2 * range);
+    auto encode = [scale](float d) {
+        return SkToU8(sk_float_round2int(SkTPin(0.5f + d * scale, 0.0f, 1.0f) * 255));
+    };
+
+    for (int y = 0; y < bounds.height(); ++y) {
+        uint8_t* row = dst + y * rowBytes;
+        for (int x = 0; x < bounds.width(); ++x) {
+            const SkPoint p = {bounds.fLeft + x + 0.5f, bounds.fTop + y + 0.5f};
+
+            Nearest channels[3], nearest;
+            for (const Contour& contour : contours) {
+                for (const Edge& edge : contour) {
+                    for (int s = 0; s + 1 < edge.fPoints.size(); ++s) {
+                        const SkPoint a = edge.fPoints[s];
+                        const SkVector ab = edge.fPoints[s + 1] - a;
+                        const SkVector ap = p - a;
+                        const float t = SkPoint::DotProduct(ap, ab) / SkPoint::DotProduct(ab, ab);
+                        const SkVector qp = ap - ab * SkTPin(t, 0.0f, 1.0f);
+                        const float distance = qp.length();
+                        const float orthogonality = distance > 0
+                                ? std::abs(SkPoint::CrossProduct(ab, qp)) / (ab.length() * distance)
+                                : 1.0f;
+                        nearest.update(distance, orthogonality, &edge, s, t);
+                        for (int c = 0; c < 3; ++c) {
+                            if (edge.fColor & (1 << c)) {
+                                channels[c].update(distance, orthogonality, &edge, s, t);
+                            }
+                        }
+                    }
+                }
+            }
+
+            float d[3];
+            for (int c = 0; c < 3; ++c) {
+                d[c] = channels[c].signedDistance(p);
+            }
+            // The sides of the edges only give the right sign if the contours wind consistently;
+            // the fill decides.
+            const bool inside = path.contains(p.fX, p.fY);
+            const float m = median(d[0], d[1], d[2]);
+            if (m != 0 && (m > 0) != inside) {
+                for (float& channel : d) {
+                    channel = -channel;
+                }
+            }
+            const float trueDistance = nearest.fDistance;
+
+            uint8_t* pixel = row + 4 * x;
+            pixel[0] = encode(d[0]);
+            pixel[1] = encode(d[1]);
+            pixel[2] = encode(d[2]);
+            pixel[3] = encode(inside ? trueDistance : -trueDistance);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkMultiDistanceFieldGen_DEFINED
+#define SkMultiDistanceFieldGen_DEFINED
+
+#include "include/core/SkTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class SkPath;
+struct SkIRect;
+
+// A multi-channel signed distance field (MSDF) stores three distance fields, each measured from
+// a different subset of the outline's edges. Two edges meeting at a corner never share all three
+// channels, so the median of the channels keeps corners sharp when the field is magnified, where
+// a single-channel field rounds them off.
+//
+// The field is RGBA 8888: red, green and blue hold the channel distances and alpha the true
+// distance to the outline. A distance d, positive inside, is stored as 0.5 + d / (2 * range),
+// clamped to [0, 1].
+
+/** Generate the multi-channel distance field of path.
+
+ *  @param dst       The field; bounds.width() x bounds.height() RGBA 8888 pixels.
+ *  @param rowBytes  Size of each row of dst, in bytes.
+ *  @param path      The outline, in the same coordinates as bounds.
+ *  @param bounds    The area covered by dst. Pixel (x, y) of dst is the distance at
+ *                   (bounds.fLeft + x + 0.5, bounds.fTop + y + 0.5).
+ *  @param range     The largest distance represented, in the units of path.
+ */
+bool SkGenerateMultiDistanceField(uint8_t* dst, size_t rowBytes, const SkPath& path,
+                                  const SkIRect& bounds, float range);
+
+#endif
@@ -153,15 +153,21 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const void* data, size_t size,
     if (!data) {
         return nullptr;
     }
+    // Nothing keeps this memory alive, so it can't be shared.
+    SkDeserialProcs copyingProcs;
+    if (procs) {
+        copyingProcs = *procs;
+    }
+    copyingProcs.fShareSourceData = false;
     SkMemoryStream stream(data, size);
-    return MakeFromStreamPriv(&stream, procs, nullptr, kNestedSKPLimit);
+    return MakeFromStreamPriv(&stream, &copyingProcs, nullptr, kNestedSKPLimit);
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialProcs* procs) {
     if (!data) {
         return nullptr;
     }
-    SkMemoryStream stream(data->data(), data->size());
+    SkMemoryStream stream(sk_ref_sp(const_cast<SkData*>(data)));
     return MakeFromStreamPriv(&stream, procs, nullptr, kNestedSKPLimit);
 }
 
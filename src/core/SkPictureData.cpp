@@ -13,6 +13,7 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTemplates.h"
@@ -303,6 +304,27 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// If procs allow sharing and stream reads from an SkData, returns that data, and sets offset to
+// where the stream's next size bytes start in it.
+static sk_sp<SkData> shareable_stream_data(SkStream* stream, size_t size,
+                                           const SkDeserialProcs& procs, size_t* offset) {
+    if (!procs.fShareSourceData || !stream->hasPosition()) {
+        return nullptr;
+    }
+    sk_sp<SkData> data = stream->getData();
+    const size_t position = stream->getPosition();
+    if (!data || position > data->size() || size > data->size() - position) {
+        return nullptr;
+    }
+    *offset = position;
+    return data;
+}
+
+// SkReadBuffer needs its memory 4-byte aligned, which a tag's data may not be in the stream.
+static bool is_aligned(const SkData* data, size_t offset) {
+    return SkIsAlign4(reinterpret_cast<uintptr_t>(data->bytes() + offset));
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -310,13 +332,20 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
                                    SkTypefacePlayback* topLevelTFPlayback,
                                    int recursionLimit) {
     switch (tag) {
-        case SK_PICT_READER_TAG:
+        case SK_PICT_READER_TAG: {
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            size_t offset;
+            sk_sp<SkData> source = shareable_stream_data(stream, size, procs, &offset);
+            if (source && is_aligned(source.get(), offset)) {
+                fOpData = SkData::MakeSubset(source.get(), offset, size);
+                stream->skip(size);
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
-            break;
+        } break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
             if (StreamRemainingLengthIsBelow(stream, size)) {
@@ -381,13 +410,27 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             if (StreamRemainingLengthIsBelow(stream, size)) {
                 return false;
             }
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            size_t offset;
+            sk_sp<SkData> source = shareable_stream_data(stream, size, procs, &offset);
+            SkAutoMalloc storage;
+            const void* bytes;
+            if (source && is_aligned(source.get(), offset)) {
+                bytes = source->bytes() + offset;
+                stream->skip(size);
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setVersion(fInfo.getVersion());
+            if (source) {
+                // Even when the buffer is a copy, its images can share the source's bytes.
+                buffer.setSourceData(std::move(source), offset);
+            }
 
             if (!fFactoryPlayback) {
                 return false;
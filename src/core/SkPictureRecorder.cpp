@@ -73,7 +73,9 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     }
 
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord.get());
+    AutoTArray<SkRect> bounds;
+    AutoTMalloc<SkBBoxHierarchy::Metadata> meta;
+    SkRecordOptimize(fRecord.get(), fCullRect, fBBH ? &bounds : nullptr, fBBH ? &meta : nullptr);
 
     SkDrawableList* drawableList = fRecorder->getDrawableList();
     std::unique_ptr<SkBigPicture::SnapshotArray> pictList{
@@ -81,10 +83,6 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture() {
     };
 
     if (fBBH) {
-        AutoTArray<SkRect> bounds(fRecord->count());
-        AutoTMalloc<SkBBoxHierarchy::Metadata> meta(fRecord->count());
-        SkRecordFillBounds(fCullRect, *fRecord, bounds.data(), meta);
-
         fBBH->insert(bounds.data(), meta, fRecord->count());
 
         // Now that we've calculated content bounds, we can update fCullRect, often trimming it.
@@ -133,12 +131,11 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable() {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
-    SkRecordOptimize(fRecord.get());
+    AutoTArray<SkRect> bounds;
+    AutoTMalloc<SkBBoxHierarchy::Metadata> meta;
+    SkRecordOptimize(fRecord.get(), fCullRect, fBBH ? &bounds : nullptr, fBBH ? &meta : nullptr);
 
     if (fBBH) {
-        AutoTArray<SkRect> bounds(fRecord->count());
-        AutoTMalloc<SkBBoxHierarchy::Metadata> meta(fRecord->count());
-        SkRecordFillBounds(fCullRect, *fRecord, bounds.data(), meta);
         fBBH->insert(bounds.data(), meta, fRecord->count());
     }
 
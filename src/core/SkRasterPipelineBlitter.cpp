@@ -146,8 +146,9 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
     bool is_opaque    = shader->isOpaque() && dstPaintColor.fA == 1.0f;
     bool is_constant  = shader->isConstant();
 
-    if (shader->appendRootStages({&shaderPipeline, alloc, dstCT, dstCS, dstPaintColor, props},
-                                 ctm)) {
+    if (shader->appendRootStages(
+                {&shaderPipeline, alloc, dstCT, dstCS, dstPaintColor, props, dst.dimensions()},
+                ctm)) {
         if (dstPaintColor.fA != 1.0f) {
             shaderPipeline.append(SkRasterPipelineOp::scale_1_float,
                                   alloc->make<float>(dstPaintColor.fA));
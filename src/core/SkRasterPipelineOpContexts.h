@@ -118,6 +118,11 @@ struct SkRasterPipeline_PerlinNoiseCtx {
     int numOctaves;
     const uint8_t* latticeSelector;  // [256 values]
     const uint16_t* noiseData;       // [4 channels][256 elements][vector of 2]
+    // If set, this stage's own output over the pixel centers of the whole stitched tiles in
+    // [cacheLeft, cacheLeft+cacheWidth) x [cacheTop, cacheTop+cacheHeight), as RGBA F32; it is
+    // read back instead of evaluated wherever all lanes fall inside it.
+    const float* cache = nullptr;
+    int cacheLeft = 0, cacheTop = 0, cacheWidth = 0, cacheHeight = 0;
 };
 
 // State used by mipmap_linear_*
@@ -198,6 +203,10 @@ struct SkRasterPipeline_EmbossCtx {
                                add;
 };
 
+struct SkRasterPipeline_MSDFCtx {
+    float distanceScale;  // Destination pixels per unit of encoded distance.
+};
+
 struct SkRasterPipeline_TablesCtx {
     const uint8_t *r, *g, *b, *a;
 };
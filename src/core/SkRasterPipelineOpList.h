@@ -185,6 +185,7 @@
     M(css_hcl_to_lab)                                                          \
     M(css_hsl_to_srgb) M(css_hwb_to_srgb)                                      \
     M(gauss_a_to_rgba)                                                         \
+    M(msdf_coverage)                                                           \
     M(mirror_x)   M(repeat_x)                                                  \
     M(mirror_y)   M(repeat_y)                                                  \
     M(negate_x)                                                                \
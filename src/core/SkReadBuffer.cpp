@@ -58,6 +58,14 @@ void SkReadBuffer::setMemory(const void* data, size_t size) {
     }
 }
 
+void SkReadBuffer::setSourceData(sk_sp<SkData> data, size_t offset) {
+    SkASSERT(data && offset <= data->size() && this->size() <= data->size() - offset);
+    if (data && offset <= data->size() && this->size() <= data->size() - offset) {
+        fSourceData = std::move(data);
+        fSourceOffset = offset;
+    }
+}
+
 void SkReadBuffer::setInvalid() {
     if (!fError) {
         // When an error is found, send the read cursor to the end of the stream
@@ -327,6 +335,21 @@ sk_sp<SkData> SkReadBuffer::readByteArrayAsData() {
     return SkData::MakeFromMalloc(buffer.release(), numBytes);
 }
 
+sk_sp<SkData> SkReadBuffer::readEncodedData() {
+    if (!fSourceData) {
+        return this->readByteArrayAsData();
+    }
+    size_t numBytes;
+    const char* bytes = static_cast<const char*>(this->skipByteArray(&numBytes));
+    if (!bytes) {
+        return nullptr;
+    }
+    sk_sp<SkData> data =
+            SkData::MakeSubset(fSourceData.get(), fSourceOffset + (bytes - fBase), numBytes);
+    this->validate(data != nullptr);
+    return data;
+}
+
 uint32_t SkReadBuffer::getArrayCount() {
     const size_t inc = sizeof(uint32_t);
     if (!this->validate(IsPtrAlign4(fCurr) && this->isAvailable(inc))) {
@@ -417,7 +440,7 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     }
     sk_sp<SkImage> image;
     {
-        sk_sp<SkData> data = this->readByteArrayAsData();
+        sk_sp<SkData> data = this->readEncodedData();
         if (!data) {
             this->validate(false);
             return nullptr;
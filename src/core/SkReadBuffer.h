@@ -10,6 +10,7 @@
 
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkPaint.h"
@@ -37,7 +38,6 @@
 #include <cstdint>
 
 class SkBlender;
-class SkData;
 class SkImage;
 class SkM44;
 class SkMaskFilter;
@@ -58,6 +58,12 @@ public:
 
     void setMemory(const void*, size_t);
 
+    /**
+     *  The buffer's memory holds data's bytes starting at offset, either in place or as a copy.
+     *  Encoded images read from the buffer then share data instead of copying their bytes.
+     */
+    void setSourceData(sk_sp<SkData> data, size_t offset);
+
     /**
      *  Returns true IFF the version is older than the specified version.
      */
@@ -228,6 +234,10 @@ public:
 private:
     const char* readString(size_t* length);
 
+    // Like readByteArrayAsData, but shares fSourceData when there is one. The bytes may not
+    // be 4-byte aligned, so this is only for data that's never read back as an SkReadBuffer.
+    sk_sp<SkData> readEncodedData();
+
     void setInvalid();
     bool readArray(void* value, size_t size, size_t elementSize);
     bool isAvailable(size_t size) const { return size <= this->available(); }
@@ -250,6 +260,9 @@ private:
 
     SkDeserialProcs fProcs;
 
+    sk_sp<SkData> fSourceData;
+    size_t        fSourceOffset = 0;
+
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
     }
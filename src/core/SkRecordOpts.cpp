@@ -7,21 +7,34 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/core/SkBBHFactory.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
+#include "include/core/SkShader.h"
 #include "include/private/base/SkMath.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/core/SkRRectPriv.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
+#include "src/core/SkRectPriv.h"
 
 #include <cstdint>
 #include <optional>
 
 using namespace SkRecords;
+using namespace skia_private;
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
 //   - a Match typedef
@@ -266,7 +279,327 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-void SkRecordOptimize(SkRecord* record) {
+// Draws that don't anti-alias cover exactly the pixels whose centers their geometry contains,
+// under any matrix the picture is played back with. So when an opaque non-AA draw's geometry
+// contains an earlier non-AA draw's bounds, it paints over every pixel the earlier one touched.
+// Anti-aliased draws, text, masks, and image filters can touch pixels whose centers lie outside
+// their bounds, and there's no margin that works at every playback scale, so they're never hidden.
+static bool is_center_sampled(const SkPaint* paint) {
+    if (!paint) {
+        return true;
+    }
+    const bool hairline = paint->getStyle() != SkPaint::kFill_Style &&
+                          paint->getStrokeWidth() == 0;
+    return !paint->isAntiAlias() && !paint->getMaskFilter() && !paint->getImageFilter() &&
+           !hairline;
+}
+
+// Whether every pixel a center-sampled draw with this paint touches ends up opaque, given that
+// its source color is opaque before the paint's alpha and color filter are applied.
+static bool paints_opaque(const SkPaint* paint) {
+    if (!paint) {
+        return true;
+    }
+    const auto bm = paint->asBlendMode();
+    return is_center_sampled(paint) &&
+           0xFF == paint->getAlpha() &&
+           (bm == SkBlendMode::kSrcOver || bm == SkBlendMode::kSrc) &&
+           (!paint->getColorFilter() || paint->getColorFilter()->isAlphaUnchanged());
+}
+
+static bool fills_opaque(const SkPaint& paint) {
+    return paints_opaque(&paint) &&
+           paint.getStyle() == SkPaint::kFill_Style &&
+           !paint.getPathEffect() &&
+           (!paint.getShader() || paint.getShader()->isOpaque());
+}
+
+// Walks the record front to back, noting for each op the identity space pixels it's sure to
+// paint opaquely, whether it may be hidden by later draws, and how it scopes the occlusion of
+// the ops before it.
+class OcclusionInfo {
+public:
+    enum Flags : uint8_t {
+        kHideable       = 1 << 0,
+        kBeginsLayer    = 1 << 1,  // SaveLayer
+        kEndsLayer      = 1 << 2,  // The Restore of a SaveLayer.
+        kFilteredLayer  = 1 << 3,  // The layer's contents are filtered before they're drawn.
+        kReadsPrevious  = 1 << 4,  // Earlier draws can show up anywhere after this op.
+    };
+
+    struct Op {
+        SkIRect fCovers = SkIRect::MakeEmpty();
+        uint8_t fFlags = 0;
+    };
+
+    explicit OcclusionInfo(Op ops[]) : fOps(ops) {}
+
+    void setCurrentOp(int currentOp) { fCurrentOp = currentOp; }
+
+    // SaveBehind and DrawBehind put earlier contents back on top of later ones.
+    bool drawsBehind() const { return fDrawsBehind; }
+
+    template <typename T> void operator()(const T& op) {
+        this->updateState(op);
+        this->track(op);
+    }
+
+private:
+    struct State {
+        SkMatrix ctm;
+        SkRect   clip;        // In identity space; only meaningful if clipIsRect.
+        bool     clipIsRect;  // The clip is exactly clip, without anti-aliasing.
+        bool     isLayer;
+        bool     isFilteredLayer;
+    };
+
+    Op& current() { return fOps[fCurrentOp]; }
+
+    // The identity space pixels sure to be covered by a draw filling rect with the current state.
+    SkIRect covers(const SkRect& rect) const {
+        if (!fState.ctm.rectStaysRect()) {
+            return SkIRect::MakeEmpty();
+        }
+        return this->coversClip(fState.ctm.mapRect(rect.makeSorted()));
+    }
+
+    // The same for a rect already in identity space, e.g. the clip itself for a DrawPaint.
+    SkIRect coversClip(SkRect rect) const {
+        if (!fState.clipIsRect || !rect.intersect(fState.clip)) {
+            return SkIRect::MakeEmpty();
+        }
+        SkIRect covered = rect.roundIn();
+        if (!covered.intersect(SkRectPriv::MakeILarge())) {
+            return SkIRect::MakeEmpty();
+        }
+        return covered;
+    }
+
+    void clipRect(const SkRect& rect, SkClipOp op, bool aa) {
+        if (aa || op != SkClipOp::kIntersect || !fState.ctm.rectStaysRect()) {
+            fState.clipIsRect = false;
+        } else if (!fState.clip.intersect(fState.ctm.mapRect(rect.makeSorted()))) {
+            fState.clip.setEmpty();
+        }
+    }
+
+    void pushState(bool isLayer, bool isFilteredLayer) {
+        fStack.push_back(fState);
+        fState.isLayer = isLayer;
+        fState.isFilteredLayer = isFilteredLayer;
+    }
+
+    template <typename T> void updateState(const T&) {}
+    void updateState(const Save&) { this->pushState(false, false); }
+    void updateState(const SaveLayer& op) {
+        const bool filtered = (op.paint && (op.paint->getImageFilter() ||
+                                            op.paint->getMaskFilter())) ||
+                              !op.filters.empty();
+        this->pushState(true, filtered);
+    }
+    void updateState(const SaveBehind&) {
+        fDrawsBehind = true;
+        this->pushState(false, false);
+    }
+    void updateState(const Restore& op) {
+        if (fState.isLayer) {
+            this->current().fFlags |= kEndsLayer;
+            if (fState.isFilteredLayer) {
+                this->current().fFlags |= kFilteredLayer;
+            }
+        }
+        if (!fStack.empty()) {
+            fState = fStack.back();
+            fStack.pop_back();
+        }
+        fState.ctm = op.matrix;
+    }
+
+    void updateState(const SetMatrix& op) { fState.ctm = op.matrix; }
+    void updateState(const SetM44& op)    { fState.ctm = op.matrix.asM33(); }
+    void updateState(const Concat44& op)  { fState.ctm.preConcat(op.matrix.asM33()); }
+    void updateState(const Concat& op)    { fState.ctm.preConcat(op.matrix); }
+    void updateState(const Scale& op)     { fState.ctm.preScale(op.sx, op.sy); }
+    void updateState(const Translate& op) { fState.ctm.preTranslate(op.dx, op.dy); }
+
+    void updateState(const ClipRect& op) {
+        this->clipRect(op.rect, op.opAA.op(), op.opAA.aa());
+    }
+    void updateState(const ClipRRect& op) {
+        if (op.rrect.isRect()) {
+            this->clipRect(op.rrect.rect(), op.opAA.op(), op.opAA.aa());
+        } else {
+            fState.clipIsRect = false;
+        }
+    }
+    void updateState(const ClipPath& op) {
+        SkRect rect;
+        if (!op.path.isInverseFillType() && op.path.isRect(&rect)) {
+            this->clipRect(rect, op.opAA.op(), op.opAA.aa());
+        } else {
+            fState.clipIsRect = false;
+        }
+    }
+    // Regions are replayed in device space, which isn't known here.
+    void updateState(const ClipRegion&) { fState.clipIsRect = false; }
+    void updateState(const ClipShader&) { fState.clipIsRect = false; }
+    void updateState(const ResetClip&) {
+        fState.clip = SkRectPriv::MakeLargeS32();
+        fState.clipIsRect = true;
+    }
+
+    // Most ops neither paint opaquely nor can be hidden.
+    template <typename T> void track(const T&) {}
+
+    void track(const SaveLayer& op) {
+        this->current().fFlags |= kBeginsLayer;
+        if (op.backdrop || (op.saveLayerFlags & SkCanvas::kInitWithPrevious_SaveLayerFlag)) {
+            this->current().fFlags |= kReadsPrevious;
+        }
+    }
+    // Pictures and drawables may hold backdrop layers of their own.
+    void track(const DrawPicture&)  { this->current().fFlags |= kReadsPrevious; }
+    void track(const DrawDrawable&) { this->current().fFlags |= kReadsPrevious; }
+    void track(const DrawBehind&)   { fDrawsBehind = true; }
+
+    void track(const DrawRect& op) {
+        this->hideable(&op.paint);
+        if (fills_opaque(op.paint)) {
+            this->current().fCovers = this->covers(op.rect);
+        }
+    }
+    void track(const DrawRRect& op) {
+        this->hideable(&op.paint);
+        if (fills_opaque(op.paint)) {
+            this->current().fCovers = this->covers(SkRRectPriv::InnerBounds(op.rrect));
+        }
+    }
+    void track(const DrawPaint& op) {
+        this->hideable(&op.paint);
+        if (fills_opaque(op.paint)) {
+            this->current().fCovers = this->coversClip(SkRectPriv::MakeLargeS32());
+        }
+    }
+    void track(const DrawImage& op) {
+        this->hideable(op.paint);
+        if (op.image->isOpaque() && paints_opaque(op.paint)) {
+            this->current().fCovers = this->covers(
+                    SkRect::MakeXYWH(op.left, op.top, op.image->width(), op.image->height()));
+        }
+    }
+    void track(const DrawImageRect& op) {
+        this->hideable(op.paint);
+        // Sampling outside the image would be transparent.
+        if (op.image->isOpaque() && paints_opaque(op.paint) &&
+            SkRect::Make(op.image->bounds()).contains(op.src)) {
+            this->current().fCovers = this->covers(op.dst);
+        }
+    }
+    void track(const DrawImageLattice& op) { this->hideable(op.paint); }
+    void track(const DrawDRRect& op)       { this->hideable(&op.paint); }
+    void track(const DrawOval& op)         { this->hideable(&op.paint); }
+    void track(const DrawArc& op)          { this->hideable(&op.paint); }
+    void track(const DrawPath& op)         { this->hideable(&op.paint); }
+    void track(const DrawRegion& op)       { this->hideable(&op.paint); }
+
+    void hideable(const SkPaint* paint) {
+        if (is_center_sampled(paint)) {
+            this->current().fFlags |= kHideable;
+        }
+    }
+
+    Op* fOps;
+    int fCurrentOp = 0;
+    State fState = {SkMatrix::I(), SkRectPriv::MakeLargeS32(), true, false, false};
+    TArray<State> fStack;
+    bool fDrawsBehind = false;
+};
+
+// Past this many spans, stop adding to the occluded region so each op stays cheap to test.
+static constexpr int kMaxOcclusionComplexity = 256;
+
+// As SkRecordNoopOccludedDraws(), with each op's bounds from SkRecordFillBounds() if the caller
+// already has them, or null to compute them only if any draw could be hidden.
+static int noop_occluded_draws(SkRecord* record, const SkRect& cullRect,
+                               const SkRect* precomputedBounds) {
+    const int count = record->count();
+    AutoTArray<OcclusionInfo::Op> ops(count);
+    {
+        OcclusionInfo visitor(ops.data());
+        for (int i = 0; i < count; i++) {
+            visitor.setCurrentOp(i);
+            record->visit(i, visitor);
+        }
+        if (visitor.drawsBehind()) {
+            return 0;
+        }
+    }
+
+    AutoTArray<SkRect> computedBounds;
+    const SkRect* bounds = precomputedBounds;
+    if (!bounds) {
+        computedBounds.reset(count);
+        AutoTMalloc<SkBBoxHierarchy::Metadata> meta(count);
+        SkRecordFillBounds(cullRect, *record, computedBounds.data(), meta);
+        bounds = computedBounds.data();
+    }
+
+    // Walk back to front, accumulating the pixels that later draws are sure to paint over.
+    // Inside a layer, that's what covers the layer so far; leaving it, what covered the parent.
+    SkRegion occluded;
+    TArray<SkRegion> parents;
+    int hidden = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        const OcclusionInfo::Op& op = ops[i];
+        if (op.fFlags & OcclusionInfo::kEndsLayer) {
+            parents.push_back(occluded);
+            if (op.fFlags & OcclusionInfo::kFilteredLayer) {
+                // A filter can move what's drawn in the layer out from under the occluders.
+                occluded.setEmpty();
+            }
+        }
+        if (op.fFlags & OcclusionInfo::kBeginsLayer) {
+            if (parents.empty()) {
+                occluded.setEmpty();
+            } else {
+                occluded = std::move(parents.back());
+                parents.pop_back();
+            }
+        }
+        if (op.fFlags & OcclusionInfo::kReadsPrevious) {
+            occluded.setEmpty();
+        }
+
+        if ((op.fFlags & OcclusionInfo::kHideable) &&
+            occluded.contains(bounds[i].roundOut())) {
+            record->replace<NoOp>(i);
+            hidden++;
+            continue;
+        }
+        if (!op.fCovers.isEmpty() &&
+            occluded.computeRegionComplexity() < kMaxOcclusionComplexity) {
+            occluded.op(op.fCovers, SkRegion::kUnion_Op);
+        }
+    }
+    return hidden;
+}
+
+int SkRecordNoopOccludedDraws(SkRecord* record, const SkRect& cullRect) {
+    return noop_occluded_draws(record, cullRect, nullptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+struct IsNoOp {
+    bool operator()(const NoOp&) const { return true; }
+    template <typename T> bool operator()(const T&) const { return false; }
+};
+}  // namespace
+
+void SkRecordOptimize(SkRecord* record, const SkRect& cullRect,
+                      AutoTArray<SkRect>* bounds, AutoTMalloc<SkBBoxHierarchy::Metadata>* meta) {
+    SkASSERT(!bounds == !meta);
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
     // and the bounding box hierarchy will do the work of skipping no-op
@@ -284,5 +617,29 @@ void SkRecordOptimize(SkRecord* record) {
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
 
+    if (!bounds) {
+        SkRecordNoopOccludedDraws(record, cullRect);
+        record->defrag();
+        return;
+    }
+
+    // The caller wants the bounds too, so compute them once, for the occlusion pass and for it.
     record->defrag();
+    bounds->reset(record->count());
+    meta->reset(record->count());
+    SkRecordFillBounds(cullRect, *record, bounds->data(), *meta);
+    if (noop_occluded_draws(record, cullRect, bounds->data()) > 0) {
+        // Drop the hidden draws' bounds along with them. The bounds of the layers around them
+        // may now be larger than needed, but still hold everything drawn.
+        int kept = 0;
+        for (int i = 0; i < record->count(); i++) {
+            if (!record->visit(i, IsNoOp())) {
+                (*bounds)[kept] = (*bounds)[i];
+                (*meta)[kept] = (*meta)[i];
+                kept++;
+            }
+        }
+        record->defrag();
+        SkASSERT(kept == record->count());
+    }
 }
@@ -8,10 +8,17 @@
 #ifndef SkRecordOpts_DEFINED
 #define SkRecordOpts_DEFINED
 
+#include "include/core/SkBBHFactory.h"
+#include "include/private/base/SkTemplates.h"
+
 class SkRecord;
+struct SkRect;
 
-// Run all optimizations in recommended order.
-void SkRecordOptimize(SkRecord*);
+// Run all optimizations in recommended order. If bounds and meta are given, they're filled with
+// SkRecordFillBounds() of the optimized record, sharing the bounds the optimizations need.
+void SkRecordOptimize(SkRecord*, const SkRect& cullRect,
+                      skia_private::AutoTArray<SkRect>* bounds = nullptr,
+                      skia_private::AutoTMalloc<SkBBoxHierarchy::Metadata>* meta = nullptr);
 
 // Turns logical no-op Save-[non-drawing command]*-Restore patterns into actual no-ops.
 void SkRecordNoopSaveRestores(SkRecord*);
@@ -26,4 +33,8 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// NoOps draws that later opaque draws are sure to paint over, wherever they're played back.
+// Only draws that aren't anti-aliased can be hidden. Returns how many draws were hidden.
+int SkRecordNoopOccludedDraws(SkRecord*, const SkRect& cullRect);
+
 #endif//SkRecordOpts_DEFINED
@@ -193,7 +193,8 @@ public:
                      s.fDstColorType,
                      s.fDstCS,
                      SkColors::kTransparent,
-                     s.fSurfaceProps}
+                     s.fSurfaceProps,
+                     s.fDstSize}
             , fMatrix(m)
             , fChildren(c)
             , fSampleUsages(u) {}
@@ -24,6 +24,7 @@
 #include "src/core/SkWriteBuffer.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <algorithm>
 #include <cctype>
 #include <new>
 #include <optional>
@@ -114,6 +115,24 @@ SkStrike::FlattenGlyphsByType(SkWriteBuffer& buffer,
     }
 }
 
+bool SkStrike::flattenGlyphs(SkWriteBuffer& buffer) const {
+    SkAutoMutexExclusive lock{fStrikeLock};
+    std::vector<SkGlyph> images, paths;
+    for (const SkGlyph* glyph : fGlyphForIndex) {
+        if (glyph->setImageHasBeenCalled()) {
+            images.push_back(*glyph);
+        }
+        if (glyph->setPathHasBeenCalled()) {
+            paths.push_back(*glyph);
+        }
+    }
+    if (images.empty() && paths.empty()) {
+        return false;
+    }
+    FlattenGlyphsByType(buffer, images, paths, {});
+    return true;
+}
+
 bool SkStrike::mergeFromBuffer(SkReadBuffer& buffer) {
     // Read glyphs with images for the current strike.
     const int imagesCount = buffer.readInt();
@@ -209,6 +228,50 @@ const SkDrawable* SkStrike::mergeDrawable(SkGlyph* glyph, sk_sp<SkDrawable> draw
     return glyph->drawable();
 }
 
+void SkStrike::removeGenerated(std::vector<SkPackedGlyphID>* images,
+                               std::vector<SkGlyphID>* paths) const {
+    SkAutoMutexExclusive lock{fStrikeLock};
+    auto generated = [&](SkPackedGlyphID packedID, bool image) {
+        const SkGlyphDigest* digest = fDigestForPackedGlyphID.find(packedID);
+        if (digest == nullptr) {
+            return false;
+        }
+        const SkGlyph* glyph = fGlyphForIndex[digest->index()];
+        return image ? glyph->setImageHasBeenCalled() : glyph->setPathHasBeenCalled();
+    };
+    images->erase(std::remove_if(images->begin(), images->end(),
+                                 [&](SkPackedGlyphID id) { return generated(id, true); }),
+                  images->end());
+    paths->erase(std::remove_if(paths->begin(), paths->end(),
+                                [&](SkGlyphID id) {
+                                    return generated(SkPackedGlyphID{id}, false);
+                                }),
+                 paths->end());
+}
+
+void SkStrike::mergeGenerated(SkSpan<const SkGlyph> glyphs) {
+    Monitor m{this};
+    for (const SkGlyph& from : glyphs) {
+        SkGlyph* glyph;
+        if (SkGlyphDigest* digest = fDigestForPackedGlyphID.find(from.getPackedID())) {
+            glyph = fGlyphForIndex[digest->index()];
+            // Another thread may have drawn the glyph since it was generated.
+            if (!glyph->setImageHasBeenCalled() && from.setImageHasBeenCalled() &&
+                from.image() != nullptr && glyph->setImage(&fAlloc, from.image())) {
+                fMemoryIncrease += glyph->imageSize();
+            }
+        } else {
+            glyph = fAlloc.make<SkGlyph>(from.getPackedID());
+            fMemoryIncrease += glyph->setMetricsAndImage(&fAlloc, from) + sizeof(SkGlyph);
+            (void)this->addGlyphAndDigest(glyph);
+        }
+        if (from.setPathHasBeenCalled() &&
+            glyph->setPath(&fAlloc, from.path(), from.pathIsHairline())) {
+            fMemoryIncrease += glyph->path()->approximateBytesUsed();
+        }
+    }
+}
+
 void SkStrike::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkScalar xPos,
                               SkGlyph* glyph, SkScalar* array, int* count) {
     SkAutoMutexExclusive lock{fStrikeLock};
@@ -445,12 +508,8 @@ SkSpan<const SkGlyph*> SkStrike::internalPrepare(
 
 void SkStrike::updateMemoryUsage(size_t increase) {
     if (increase > 0) {
-        // fRemoved and the cache's total memory are managed under the cache's lock. This allows
-        // them to be accessed under LRU operation.
-        SkAutoMutexExclusive lock{fStrikeCache->fLock};
-        fMemoryUsed += increase;
-        if (!fRemoved) {
-            fStrikeCache->fTotalMemoryUsed += increase;
-        }
+        // fRemoved and the cache's total memory are managed under the lock of the cache shard
+        // holding this strike. This allows them to be accessed under LRU operation.
+        fStrikeCache->internalUpdateMemoryUsage(this, increase);
     }
 }
@@ -21,6 +21,7 @@
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -62,6 +63,10 @@ public:
                                     SkSpan<SkGlyph> paths,
                                     SkSpan<SkGlyph> drawables);
 
+    // Write the glyphs with images or paths in the format read by mergeFromBuffer. Returns false,
+    // writing nothing, if there are no such glyphs.
+    bool flattenGlyphs(SkWriteBuffer& buffer) const SK_EXCLUDES(fStrikeLock);
+
     // Lookup (or create if needed) the returned glyph using toID. If that glyph is not initialized
     // with an image, then use the information in fromGlyph to initialize the width, height top,
     // left, format and image of the glyph. This is mainly used preserving the glyph if it was
@@ -77,6 +82,15 @@ public:
     const SkDrawable* mergeDrawable(
             SkGlyph* glyph, sk_sp<SkDrawable> drawable) SK_EXCLUDES(fStrikeLock);
 
+    // Remove from images and paths the glyphs this strike already has an image or path for.
+    void removeGenerated(std::vector<SkPackedGlyphID>* images,
+                         std::vector<SkGlyphID>* paths) const SK_EXCLUDES(fStrikeLock);
+
+    // Add glyphs generated by another scaler context for this strike's spec, copying their
+    // images and paths into this strike unless it already has them. This lets glyphs be
+    // generated on several threads without holding the strike's lock.
+    void mergeGenerated(SkSpan<const SkGlyph> glyphs) SK_EXCLUDES(fStrikeLock);
+
     // If the advance axis intersects the glyph's path, append the positions scaled and offset
     // to the array (if non-null), and set the count to the updated array length.
     // TODO: track memory usage.
@@ -197,12 +211,16 @@ private:
 
     SkArenaAlloc            fAlloc SK_GUARDED_BY(fStrikeLock) {kMinAllocAmount};
 
-    // The following are protected by the SkStrikeCache's mutex.
+    // The following are protected by the mutex of the SkStrikeCache shard holding this strike.
     SkStrike*                       fNext{nullptr};
     SkStrike*                       fPrev{nullptr};
     std::unique_ptr<SkStrikePinner> fPinner;
     size_t                          fMemoryUsed{sizeof(SkStrike)};
     bool                            fRemoved{false};
+
+    // Set by lookups holding the shard's mutex shared; cleared when the purge gives the strike a
+    // second chance instead of evicting it.
+    std::atomic<bool>               fRecentlyUsed{false};
 };
 
 #endif  // SkStrike_DEFINED
@@ -8,19 +8,29 @@
 #include "src/core/SkStrikeCache.h"
 
 #include "include/core/SkGraphics.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkSharedMutex.h"
 #include "src/core/SkDescriptor.h"
+#include "src/core/SkGlyphRunPainter.h"
+#include "src/core/SkScalerContext.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkStrikeStore.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/text/GlyphRun.h"
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
-class SkScalerContext;
 struct SkFontMetrics;
 
 using namespace sktext;
@@ -36,13 +46,36 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
     return cache;
 }
 
+auto SkStrikeCache::shardFor(const SkDescriptor& desc) -> Shard& {
+    return fShards[desc.getChecksum() >> (32 - kShardBits)];
+}
+
 auto SkStrikeCache::findOrCreateStrike(const SkStrikeSpec& strikeSpec) -> sk_sp<SkStrike> {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> strike = this->internalFindStrikeOrNull(strikeSpec.descriptor());
+    const SkDescriptor& desc = strikeSpec.descriptor();
+    Shard& shard = this->shardFor(desc);
+    sk_sp<SkStrike> strike;
+    {
+        SkAutoSharedMutexShared ac(shard.fLock);
+        strike = shard.find(desc);
+    }
     if (strike == nullptr) {
-        strike = this->internalCreateStrike(strikeSpec);
+        bool created = false;
+        {
+            SkAutoSharedMutexExclusive ac(shard.fLock);
+            // Another thread may have created the strike since the shared lookup.
+            strike = shard.find(desc);
+            if (strike == nullptr) {
+                strike = this->internalCreateStrike(shard, strikeSpec);
+                created = true;
+            }
+        }
+        // Populating takes the strike's lock, which reports memory use to the shard, so it can't
+        // be done while the shard is locked.
+        if (created) {
+            this->populateFromStore(strike.get());
+        }
     }
-    this->internalPurge();
+    this->purgeIfNeeded();
     return strike;
 }
 
@@ -90,34 +123,26 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
-    this->internalPurge();
+    Shard& shard = this->shardFor(desc);
+    sk_sp<SkStrike> result;
+    {
+        SkAutoSharedMutexShared ac(shard.fLock);
+        result = shard.find(desc);
+    }
+    this->purgeIfNeeded();
     return result;
 }
 
-auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<SkStrike> {
-
-    // Check head because it is likely the strike we are looking for.
-    if (fHead != nullptr && fHead->getDescriptor() == desc) { return sk_ref_sp(fHead); }
-
-    // Do the heavy search looking for the strike.
+auto SkStrikeCache::Shard::find(const SkDescriptor& desc) -> sk_sp<SkStrike> {
     sk_sp<SkStrike>* strikeHandle = fStrikeLookup.find(desc);
     if (strikeHandle == nullptr) { return nullptr; }
     SkStrike* strikePtr = strikeHandle->get();
     SkASSERT(strikePtr != nullptr);
-    if (fHead != strikePtr) {
-        // Make most recently used
-        strikePtr->fPrev->fNext = strikePtr->fNext;
-        if (strikePtr->fNext != nullptr) {
-            strikePtr->fNext->fPrev = strikePtr->fPrev;
-        } else {
-            fTail = strikePtr->fPrev;
-        }
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
-        strikePtr->fPrev = nullptr;
-        fHead = strikePtr;
+    // The LRU list can't be reordered under a shared lock, so just note the use; the next purge
+    // moves the strike to the head instead of evicting it. Only store when needed, so hot strikes
+    // used by many threads don't bounce their cache line around.
+    if (!strikePtr->fRecentlyUsed.load(std::memory_order_relaxed)) {
+        strikePtr->fRecentlyUsed.store(true, std::memory_order_relaxed);
     }
     return sk_ref_sp(strikePtr);
 }
@@ -126,57 +151,190 @@ sk_sp<SkStrike> SkStrikeCache::createStrike(
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
-    SkAutoMutexExclusive ac(fLock);
-    return this->internalCreateStrike(strikeSpec, maybeMetrics, std::move(pinner));
+    Shard& shard = this->shardFor(strikeSpec.descriptor());
+    SkAutoSharedMutexExclusive ac(shard.fLock);
+    return this->internalCreateStrike(shard, strikeSpec, maybeMetrics, std::move(pinner));
 }
 
 auto SkStrikeCache::internalCreateStrike(
+        Shard& shard,
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) -> sk_sp<SkStrike> {
     std::unique_ptr<SkScalerContext> scaler = strikeSpec.createScalerContext();
     auto strike =
         sk_make_sp<SkStrike>(this, strikeSpec, std::move(scaler), maybeMetrics, std::move(pinner));
-    this->internalAttachToHead(strike);
+    this->internalAttachToHead(shard, strike);
     return strike;
 }
 
+void SkStrikeCache::setStrikeStore(sk_sp<SkStrikeStore> store) {
+    SkAutoMutexExclusive ac(fStoreLock);
+    fStrikeStore = std::move(store);
+}
+
+void SkStrikeCache::populateFromStore(SkStrike* strike) {
+    sk_sp<SkStrikeStore> store;
+    {
+        SkAutoMutexExclusive ac(fStoreLock);
+        store = fStrikeStore;
+    }
+    if (store) {
+        store->populate(strike);
+    }
+}
+
+void SkStrikeCache::Prewarm(SkSpan<const PrewarmRequest> requests, SkExecutor* executor) {
+    // Gather the requests for each strike.
+    skia_private::THashMap<SkStrike*, int> indexForStrike;
+    std::vector<PrewarmRequest> pending;
+    for (const PrewarmRequest& request : requests) {
+        if (!request.fStrike) {
+            continue;
+        }
+        int* index = indexForStrike.find(request.fStrike.get());
+        if (index == nullptr) {
+            index = indexForStrike.set(request.fStrike.get(), SkToInt(pending.size()));
+            pending.push_back({request.fStrike, {}, {}});
+        }
+        PrewarmRequest& merged = pending[*index];
+        merged.fImages.insert(merged.fImages.end(),
+                              request.fImages.begin(), request.fImages.end());
+        merged.fPaths.insert(merged.fPaths.end(), request.fPaths.begin(), request.fPaths.end());
+    }
+
+    for (PrewarmRequest& request : pending) {
+        std::vector<SkPackedGlyphID>& images = request.fImages;
+        std::vector<SkGlyphID>& paths = request.fPaths;
+        std::sort(images.begin(), images.end());
+        images.erase(std::unique(images.begin(), images.end()), images.end());
+        std::sort(paths.begin(), paths.end());
+        paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+        request.fStrike->removeGenerated(&images, &paths);
+    }
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [](const PrewarmRequest& request) {
+                                     return request.fImages.empty() && request.fPaths.empty();
+                                 }),
+                  pending.end());
+
+    // Each strike's missing glyphs are split into chunks, so that even the glyphs of a single
+    // strike are generated concurrently.
+    struct Chunk {
+        const PrewarmRequest* fRequest;
+        SkSpan<const SkPackedGlyphID> fImages;
+        SkSpan<const SkGlyphID> fPaths;
+    };
+    static constexpr size_t kGlyphsPerChunk = 32;
+    std::vector<Chunk> chunks;
+    for (const PrewarmRequest& request : pending) {
+        const SkSpan<const SkPackedGlyphID> images{request.fImages};
+        for (size_t i = 0; i < images.size(); i += kGlyphsPerChunk) {
+            chunks.push_back({&request,
+                              images.subspan(i, std::min(kGlyphsPerChunk, images.size() - i)),
+                              {}});
+        }
+        const SkSpan<const SkGlyphID> paths{request.fPaths};
+        for (size_t i = 0; i < paths.size(); i += kGlyphsPerChunk) {
+            chunks.push_back({&request,
+                              {},
+                              paths.subspan(i, std::min(kGlyphsPerChunk, paths.size() - i))});
+        }
+    }
+
+    // A scaler context is not thread safe, so each chunk is generated with a context of its own,
+    // then handed to the strike to copy in under the strike's lock.
+    auto generate = [&chunks](int index) {
+        const Chunk& chunk = chunks[index];
+        SkStrike* strike = chunk.fRequest->fStrike.get();
+        std::unique_ptr<SkScalerContext> context = strike->strikeSpec().createScalerContext();
+        SkArenaAlloc alloc{4096};
+        std::vector<SkGlyph> glyphs;
+        glyphs.reserve(chunk.fImages.size() + chunk.fPaths.size());
+        for (SkPackedGlyphID packedID : chunk.fImages) {
+            SkGlyph& glyph = glyphs.emplace_back(context->makeGlyph(packedID, &alloc));
+            glyph.setImage(&alloc, context.get());
+        }
+        for (SkGlyphID glyphID : chunk.fPaths) {
+            SkGlyph& glyph =
+                    glyphs.emplace_back(context->makeGlyph(SkPackedGlyphID{glyphID}, &alloc));
+            glyph.setPath(&alloc, context.get());
+        }
+        strike->mergeGenerated(glyphs);
+    };
+
+    if (executor != nullptr && chunks.size() > 1) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.batch(SkToInt(chunks.size()), generate);
+        taskGroup.wait();
+    } else {
+        for (int i = 0; i < SkToInt(chunks.size()); ++i) {
+            generate(i);
+        }
+    }
+}
+
+void SkStrikeCache::PrewarmTextBlobs(SkSpan<const sk_sp<SkTextBlob>> blobs,
+                                     const SkPaint& paint,
+                                     const SkMatrix& matrix,
+                                     const SkImageInfo& dstInfo,
+                                     const SkSurfaceProps& props,
+                                     SkExecutor* executor) {
+    // The painter picks the strikes and sub-pixel positions its draws will use.
+    SkGlyphRunListPainterCPU painter(props, dstInfo.colorType(), dstInfo.colorSpace());
+    sktext::GlyphRunBuilder builder;
+    std::vector<PrewarmRequest> requests;
+    for (const sk_sp<SkTextBlob>& blob : blobs) {
+        if (blob) {
+            painter.collectPrewarmRequests(
+                    builder.blobToGlyphRunList(*blob, {0, 0}), paint, matrix, &requests);
+        }
+    }
+    Prewarm(requests, executor);
+}
+
 void SkStrikeCache::purgePinned(size_t minBytesNeeded) {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoMutexExclusive ac(fPurgeLock);
     this->internalPurge(minBytesNeeded, /* checkPinners= */ true);
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoMutexExclusive ac(fPurgeLock);
     this->internalPurge(fTotalMemoryUsed, /* checkPinners= */ true);
 }
 
+void SkStrikeCache::purgeIfNeeded() {
+    if (fTotalMemoryUsed.load(std::memory_order_relaxed) <=
+                fCacheSizeLimit.load(std::memory_order_relaxed) &&
+        fCacheCount.load(std::memory_order_relaxed) <=
+                fCacheCountLimit.load(std::memory_order_relaxed)) {
+        return;
+    }
+    SkAutoMutexExclusive ac(fPurgeLock);
+    this->internalPurge();
+}
+
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoMutexExclusive ac(fLock);
     return fTotalMemoryUsed;
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoMutexExclusive ac(fLock);
     return fCacheCount;
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoMutexExclusive ac(fLock);
     return fCacheCountLimit;
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoMutexExclusive ac(fPurgeLock);
 
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
     this->internalPurge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoMutexExclusive ac(fLock);
     return fCacheSizeLimit;
 }
 
@@ -185,21 +343,22 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexExclusive ac(fLock);
+    SkAutoMutexExclusive ac(fPurgeLock);
 
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
+    int prevCount = fCacheCountLimit.exchange(newCount);
     this->internalPurge();
     return prevCount;
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoMutexExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoSharedMutexShared ac(shard.fLock);
 
-    this->validate();
+        shard.validate();
 
-    for (SkStrike* strike = fHead; strike != nullptr; strike = strike->fNext) {
-        visitor(*strike);
+        for (SkStrike* strike = shard.fHead; strike != nullptr; strike = strike->fNext) {
+            visitor(*strike);
+        }
     }
 }
 
@@ -209,24 +368,26 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
     checkPinners = true;
 #endif
 
-    if (fPinnerCount == fCacheCount && !checkPinners)
+    const size_t totalMemoryUsed = fTotalMemoryUsed;
+    const int32_t cacheCount = fCacheCount;
+    if (fPinnerCount == cacheCount && !checkPinners)
         return 0;
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > fCacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - fCacheSizeLimit;
     }
     bytesNeeded = std::max(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = std::max(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = std::max(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > fCacheCountLimit) {
+        countNeeded = cacheCount - fCacheCountLimit;
         // no small purges!
-        countNeeded = std::max(countNeeded, fCacheCount >> 2);
+        countNeeded = std::max(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -236,24 +397,65 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
 
     size_t  bytesFreed = 0;
     int     countFreed = 0;
-
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    SkStrike* strike = fTail;
-    while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        SkStrike* prev = strike->fPrev;
-
-        // Only delete if the strike is not pinned.
-        if (strike->fPinner == nullptr || (checkPinners && strike->fPinner->canDelete())) {
-            bytesFreed += strike->fMemoryUsed;
-            countFreed += 1;
-            this->internalRemoveStrike(strike);
+    auto needMore = [&] { return bytesFreed < bytesNeeded || countFreed < countNeeded; };
+
+    // Take a share of the need from each shard in turn, so no shard is emptied while the others
+    // keep stale strikes. Each shard's list is in LRU order, with unimportant entries at the tail.
+    // In the first round, strikes used since the last purge get a second chance and move to the
+    // head; later rounds take whatever is needed.
+    const size_t bytesShare = (bytesNeeded + kShardCount - 1) / kShardCount;
+    const int countShare = (countNeeded + kShardCount - 1) / kShardCount;
+    for (int round = 0; needMore(); ++round) {
+        const int countFreedBefore = countFreed;
+        for (int i = 0; i < kShardCount && needMore(); ++i) {
+            Shard& shard = fShards[fNextPurgeShard];
+            fNextPurgeShard = (fNextPurgeShard + 1) % kShardCount;
+
+            SkAutoSharedMutexExclusive ac(shard.fLock);
+            size_t shardBytesFreed = 0;
+            int    shardCountFreed = 0;
+            SkStrike* const oldHead = shard.fHead;
+            SkStrike* strike = shard.fTail;
+            while (strike != nullptr && needMore() &&
+                   (shardBytesFreed < bytesShare || shardCountFreed < countShare)) {
+                SkStrike* prev = strike->fPrev;
+                if (round == 0 &&
+                    strike->fRecentlyUsed.exchange(false, std::memory_order_relaxed)) {
+                    if (strike != shard.fHead) {
+                        strike->fPrev->fNext = strike->fNext;
+                        if (strike->fNext != nullptr) {
+                            strike->fNext->fPrev = strike->fPrev;
+                        } else {
+                            shard.fTail = strike->fPrev;
+                        }
+                        shard.fHead->fPrev = strike;
+                        strike->fNext = shard.fHead;
+                        strike->fPrev = nullptr;
+                        shard.fHead = strike;
+                    }
+                } else if (strike->fPinner == nullptr ||
+                           (checkPinners && strike->fPinner->canDelete())) {
+                    // Only delete if the strike is not pinned.
+                    shardBytesFreed += strike->fMemoryUsed;
+                    shardCountFreed += 1;
+                    this->internalRemoveStrike(shard, strike);
+                }
+                if (strike == oldHead) {
+                    break;
+                }
+                strike = prev;
+            }
+            bytesFreed += shardBytesFreed;
+            countFreed += shardCountFreed;
+
+            shard.validate();
+        }
+        // The first round may only have handed out second chances.
+        if (round > 0 && countFreed == countFreedBefore) {
+            break;
         }
-        strike = prev;
     }
 
-    this->validate();
-
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
         SkDebugf("purging %dK from font cache [%d entries]\n",
@@ -264,30 +466,34 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(sk_sp<SkStrike> strike) {
-    SkASSERT(fStrikeLookup.find(strike->getDescriptor()) == nullptr);
+void SkStrikeCache::internalAttachToHead(Shard& shard, sk_sp<SkStrike> strike) {
+    SkASSERT(shard.fStrikeLookup.find(strike->getDescriptor()) == nullptr);
     SkStrike* strikePtr = strike.get();
-    fStrikeLookup.set(std::move(strike));
+    shard.fStrikeLookup.set(std::move(strike));
     SkASSERT(nullptr == strikePtr->fPrev && nullptr == strikePtr->fNext);
 
+    shard.fCacheCount += 1;
+    shard.fMemoryUsed += strikePtr->fMemoryUsed;
     fCacheCount += 1;
     fPinnerCount += strikePtr->fPinner != nullptr ? 1 : 0;
     fTotalMemoryUsed += strikePtr->fMemoryUsed;
 
-    if (fHead != nullptr) {
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
+    if (shard.fHead != nullptr) {
+        shard.fHead->fPrev = strikePtr;
+        strikePtr->fNext = shard.fHead;
     }
 
-    if (fTail == nullptr) {
-        fTail = strikePtr;
+    if (shard.fTail == nullptr) {
+        shard.fTail = strikePtr;
     }
 
-    fHead = strikePtr; // Transfer ownership of strike to the cache list.
+    shard.fHead = strikePtr; // Transfer ownership of strike to the cache list.
 }
 
-void SkStrikeCache::internalRemoveStrike(SkStrike* strike) {
-    SkASSERT(fCacheCount > 0);
+void SkStrikeCache::internalRemoveStrike(Shard& shard, SkStrike* strike) {
+    SkASSERT(shard.fCacheCount > 0);
+    shard.fCacheCount -= 1;
+    shard.fMemoryUsed -= strike->fMemoryUsed;
     fCacheCount -= 1;
     fPinnerCount -= strike->fPinner != nullptr ? 1 : 0;
     fTotalMemoryUsed -= strike->fMemoryUsed;
@@ -295,20 +501,30 @@ void SkStrikeCache::internalRemoveStrike(SkStrike* strike) {
     if (strike->fPrev) {
         strike->fPrev->fNext = strike->fNext;
     } else {
-        fHead = strike->fNext;
+        shard.fHead = strike->fNext;
     }
     if (strike->fNext) {
         strike->fNext->fPrev = strike->fPrev;
     } else {
-        fTail = strike->fPrev;
+        shard.fTail = strike->fPrev;
     }
 
     strike->fPrev = strike->fNext = nullptr;
     strike->fRemoved = true;
-    fStrikeLookup.remove(strike->getDescriptor());
+    shard.fStrikeLookup.remove(strike->getDescriptor());
+}
+
+void SkStrikeCache::internalUpdateMemoryUsage(SkStrike* strike, size_t increase) {
+    Shard& shard = this->shardFor(strike->getDescriptor());
+    SkAutoSharedMutexExclusive ac(shard.fLock);
+    strike->fMemoryUsed += increase;
+    if (!strike->fRemoved) {
+        shard.fMemoryUsed += increase;
+        fTotalMemoryUsed += increase;
+    }
 }
 
-void SkStrikeCache::validate() const {
+void SkStrikeCache::Shard::validate() const {
 #ifdef SK_DEBUG
     size_t computedBytes = 0;
     int computedCount = 0;
@@ -325,9 +541,9 @@ void SkStrikeCache::validate() const {
         SkDebugf("fCacheCount: %d, computedCount: %d", fCacheCount, computedCount);
         SK_ABORT("fCacheCount != computedCount");
     }
-    if (fTotalMemoryUsed != computedBytes) {
-        SkDebugf("fTotalMemoryUsed: %zu, computedBytes: %zu", fTotalMemoryUsed, computedBytes);
-        SK_ABORT("fTotalMemoryUsed == computedBytes");
+    if (fMemoryUsed != computedBytes) {
+        SkDebugf("fMemoryUsed: %zu, computedBytes: %zu", fMemoryUsed, computedBytes);
+        SK_ABORT("fMemoryUsed == computedBytes");
     }
 #endif
 }
@@ -9,22 +9,34 @@
 #define SkStrikeCache_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/private/base/SkLoadUserConfig.h" // IWYU pragma: keep
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkSharedMutex.h"
+#include "src/core/SkGlyph.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 class SkDescriptor;
+class SkExecutor;
+class SkMatrix;
+class SkPaint;
 class SkStrikeSpec;
+class SkStrikeStore;
+class SkSurfaceProps;
+class SkTextBlob;
 class SkTraceMemoryDump;
 struct SkFontMetrics;
+struct SkImageInfo;
 
 //  SK_DEFAULT_FONT_CACHE_COUNT_LIMIT and SK_DEFAULT_FONT_CACHE_LIMIT can be set using -D on your
 //  compiler commandline, or by using the defines in SkUserConfig.h
@@ -38,23 +50,26 @@ struct SkFontMetrics;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// The cache is split into shards by descriptor hash, so that threads drawing with different
+// strikes rarely touch the same lock. A lookup that hits only takes its shard's lock shared. Each
+// shard keeps its own LRU list, but the byte and count budgets are enforced over the whole cache.
 class SkStrikeCache final : public sktext::StrikeForGPUCacheInterface {
 public:
     SkStrikeCache() = default;
 
     static SkStrikeCache* GlobalStrikeCache();
 
-    sk_sp<SkStrike> findStrike(const SkDescriptor& desc) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findStrike(const SkDescriptor& desc) SK_EXCLUDES(fPurgeLock);
 
     sk_sp<SkStrike> createStrike(
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_EXCLUDES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr) SK_EXCLUDES(fPurgeLock);
 
-    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec) SK_EXCLUDES(fPurgeLock);
 
     sk_sp<sktext::StrikeForGPU> findOrCreateScopedStrike(
-            const SkStrikeSpec& strikeSpec) override SK_EXCLUDES(fLock);
+            const SkStrikeSpec& strikeSpec) override SK_EXCLUDES(fPurgeLock);
 
     static void PurgeAll();
     static void Dump();
@@ -63,55 +78,112 @@ public:
     // SkTraceMemoryDump interface.
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
-    void purgeAll() SK_EXCLUDES(fLock); // does not change budget
-    void purgePinned(size_t minBytesNeeded = 0) SK_EXCLUDES(fLock);
+    void purgeAll() SK_EXCLUDES(fPurgeLock); // does not change budget
+    void purgePinned(size_t minBytesNeeded = 0) SK_EXCLUDES(fPurgeLock);
 
-    int getCacheCountLimit() const SK_EXCLUDES(fLock);
-    int setCacheCountLimit(int limit) SK_EXCLUDES(fLock);
-    int getCacheCountUsed() const SK_EXCLUDES(fLock);
+    int getCacheCountLimit() const;
+    int setCacheCountLimit(int limit) SK_EXCLUDES(fPurgeLock);
+    int getCacheCountUsed() const;
 
-    size_t getCacheSizeLimit() const SK_EXCLUDES(fLock);
-    size_t setCacheSizeLimit(size_t limit) SK_EXCLUDES(fLock);
-    size_t getTotalMemoryUsed() const SK_EXCLUDES(fLock);
+    size_t getCacheSizeLimit() const;
+    size_t setCacheSizeLimit(size_t limit) SK_EXCLUDES(fPurgeLock);
+    size_t getTotalMemoryUsed() const;
+
+    // Strikes created from now on are populated with the glyphs the store has for them.
+    void setStrikeStore(sk_sp<SkStrikeStore> store) SK_EXCLUDES(fStoreLock);
+
+    // The glyphs drawing will need from one strike: images by packed ID, paths by glyph ID.
+    struct PrewarmRequest {
+        sk_sp<SkStrike> fStrike;
+        std::vector<SkPackedGlyphID> fImages;
+        std::vector<SkGlyphID> fPaths;
+    };
+
+    // Generate the requested images and paths that the strikes don't have yet, so the draws
+    // that use them find them cached. Each strike's glyphs are split into chunks, each generated
+    // by a task on executor with its own scaler context and merged into the strike when the task
+    // ends. Returns when all are done. With no executor, everything runs on the calling thread.
+    static void Prewarm(SkSpan<const PrewarmRequest> requests, SkExecutor* executor);
+
+    // Prewarm the glyphs that drawing each of blobs at the origin, with paint through matrix, to
+    // a raster surface described by dstInfo and props would need.
+    static void PrewarmTextBlobs(SkSpan<const sk_sp<SkTextBlob>> blobs,
+                                 const SkPaint& paint,
+                                 const SkMatrix& matrix,
+                                 const SkImageInfo& dstInfo,
+                                 const SkSurfaceProps& props,
+                                 SkExecutor* executor);
 
 private:
-    friend class SkStrike;  // for SkStrike::updateDelta
+    friend class SkStrike;  // for SkStrike::updateMemoryUsage
+    friend class SkStrikeStore;  // for forEachStrike
     static constexpr char kGlyphCacheDumpName[] = "skia/sk_glyph_cache";
-    sk_sp<SkStrike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
+    // Shards are picked by the top bits of the descriptor checksum, leaving the low bits, which
+    // the shards' hash tables use, evenly spread.
+    static constexpr int kShardBits = 3;
+    static constexpr int kShardCount = 1 << kShardBits;
+
+    struct StrikeTraits {
+        static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike);
+        static uint32_t Hash(const SkDescriptor& descriptor);
+    };
+
+    struct Shard {
+        mutable SkSharedMutex fLock;
+        SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
+        SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
+        skia_private::THashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup
+                SK_GUARDED_BY(fLock);
+        size_t  fMemoryUsed SK_GUARDED_BY(fLock) {0};
+        int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
+
+        sk_sp<SkStrike> find(const SkDescriptor& desc) SK_REQUIRES_SHARED(fLock);
+        // A simple accounting of what each glyph cache reports and the shard total.
+        void validate() const SK_REQUIRES_SHARED(fLock);
+    };
+
+    Shard& shardFor(const SkDescriptor& desc);
+
     sk_sp<SkStrike> internalCreateStrike(
+            Shard& shard,
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(shard.fLock);
+
+    // The following methods can only be called when the shard's mutex is already held.
+    void internalRemoveStrike(Shard& shard, SkStrike* strike) SK_REQUIRES(shard.fLock);
+    void internalAttachToHead(Shard& shard, sk_sp<SkStrike> strike) SK_REQUIRES(shard.fLock);
+    void internalUpdateMemoryUsage(SkStrike* strike, size_t increase);
 
-    // The following methods can only be called when mutex is already held.
-    void internalRemoveStrike(SkStrike* strike) SK_REQUIRES(fLock);
-    void internalAttachToHead(sk_sp<SkStrike> strike) SK_REQUIRES(fLock);
+    void populateFromStore(SkStrike* strike) SK_EXCLUDES(fStoreLock);
+
+    // Purges only if the cache is over budget. Cheap to call after every lookup.
+    void purgeIfNeeded() SK_EXCLUDES(fPurgeLock);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0, bool checkPinners = false) SK_REQUIRES(fLock);
+    size_t internalPurge(size_t minBytesNeeded = 0, bool checkPinners = false)
+            SK_REQUIRES(fPurgeLock);
 
-    // A simple accounting of what each glyph cache reports and the strike cache total.
-    void validate() const SK_REQUIRES(fLock);
+    void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
 
-    void forEachStrike(std::function<void(const SkStrike&)> visitor) const SK_EXCLUDES(fLock);
+    Shard fShards[kShardCount];
 
-    mutable SkMutex fLock;
-    SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
-    SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
-    struct StrikeTraits {
-        static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike);
-        static uint32_t Hash(const SkDescriptor& descriptor);
-    };
-    skia_private::THashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup
-            SK_GUARDED_BY(fLock);
-
-    size_t  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    size_t  fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
-    int32_t fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
-    int32_t fPinnerCount SK_GUARDED_BY(fLock) {0};
+    // Serializes purging and budget changes. Taken before any shard lock.
+    SkMutex fPurgeLock;
+    int     fNextPurgeShard SK_GUARDED_BY(fPurgeLock) {0};
+
+    // Totals over all shards, updated while holding the lock of the shard that changed.
+    std::atomic<size_t>  fTotalMemoryUsed{0};
+    std::atomic<int32_t> fCacheCount{0};
+    std::atomic<int32_t> fPinnerCount{0};
+
+    std::atomic<size_t>  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t> fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+
+    SkMutex fStoreLock;
+    sk_sp<SkStrikeStore> fStrikeStore SK_GUARDED_BY(fStoreLock);
 };
 
 #endif  // SkStrikeCache_DEFINED
@@ -0,0 +1,214 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkStrikeStore.h"
+
+#include "include/core/SkFontArguments.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/base/SkAlign.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkDescriptor.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkScalerContext.h"
+#include "src/core/SkStrike.h"
+#include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/core/SkWriteBuffer.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace skia_private;
+
+namespace {
+// The file starts with a header of four uint32_t: magic, version, size of SkScalerContextRec and
+// entry count. Each entry is a uint32_t key size and glyphs size, then the key and the glyphs as
+// written by SkStrike::flattenGlyphs, each padded to a multiple of four bytes.
+constexpr uint32_t kMagic = SkSetFourByteTag('s', 'k', 's', 's');
+// Bump when the serialization of SkScalerContextRec or SkGlyph changes.
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 4 * sizeof(uint32_t);
+
+bool write_u32(SkWStream* stream, uint32_t value) {
+    return stream->write(&value, sizeof(value));
+}
+
+bool write_padded(SkWStream* stream, const SkData& data) {
+    static constexpr char kZeros[4] = {0, 0, 0, 0};
+    return stream->write(data.data(), data.size()) &&
+           stream->write(kZeros, SkAlign4(data.size()) - data.size());
+}
+}  // namespace
+
+sk_sp<SkStrikeStore> SkStrikeStore::MakeFromData(sk_sp<SkData> data) {
+    if (!data || data->size() < kHeaderSize) {
+        return nullptr;
+    }
+    const uint8_t* bytes = data->bytes();
+    const size_t size = data->size();
+    uint32_t header[4];
+    memcpy(header, bytes, sizeof(header));
+    if (header[0] != kMagic || header[1] != kVersion || header[2] != sizeof(SkScalerContextRec)) {
+        return nullptr;
+    }
+
+    sk_sp<SkStrikeStore> store{new SkStrikeStore(data)};
+    size_t offset = kHeaderSize;
+    for (uint32_t i = 0; i < header[3]; ++i) {
+        uint32_t sizes[2];
+        if (size - offset < sizeof(sizes)) {
+            return nullptr;
+        }
+        memcpy(sizes, bytes + offset, sizeof(sizes));
+        offset += sizeof(sizes);
+        const size_t keySize = sizes[0], glyphsSize = sizes[1];
+        if (keySize < sizeof(uint64_t) || size - offset < SkAlign4(keySize) ||
+            size - offset - SkAlign4(keySize) < SkAlign4(glyphsSize)) {
+            return nullptr;
+        }
+        Entry entry{bytes + offset, keySize, bytes + offset + SkAlign4(keySize), glyphsSize};
+        offset += SkAlign4(keySize) + SkAlign4(glyphsSize);
+
+        const uint64_t hash = SkChecksum::Hash64(entry.fKey, entry.fKeySize);
+        if (!store->fEntries.find(hash)) {
+            store->fEntries.set(hash, entry);
+        }
+    }
+    return store;
+}
+
+bool SkStrikeStore::Write(SkStrikeCache* cache, SkWStream* stream) {
+    struct Record {
+        sk_sp<SkData> fKey;
+        sk_sp<SkData> fGlyphs;
+    };
+    std::vector<Record> records;
+    THashMap<SkTypefaceID, std::optional<uint64_t>> fontHashes;
+    cache->forEachStrike([&](const SkStrike& strike) {
+        const SkTypeface& typeface = strike.strikeSpec().typeface();
+        std::optional<uint64_t>* fontHash = fontHashes.find(typeface.uniqueID());
+        if (!fontHash) {
+            fontHash = fontHashes.set(typeface.uniqueID(), HashFont(typeface));
+        }
+        if (!fontHash->has_value()) {
+            return;
+        }
+        sk_sp<SkData> key = MakeKey(strike.strikeSpec(), **fontHash);
+        if (!key) {
+            return;
+        }
+        SkBinaryWriteBuffer buffer({});
+        if (!strike.flattenGlyphs(buffer)) {
+            return;
+        }
+        records.push_back({std::move(key), buffer.snapshotAsData()});
+    });
+
+    if (!write_u32(stream, kMagic) ||
+        !write_u32(stream, kVersion) ||
+        !write_u32(stream, sizeof(SkScalerContextRec)) ||
+        !write_u32(stream, SkToU32(records.size()))) {
+        return false;
+    }
+    for (const Record& record : records) {
+        if (!write_u32(stream, SkToU32(record.fKey->size())) ||
+            !write_u32(stream, SkToU32(record.fGlyphs->size())) ||
+            !write_padded(stream, *record.fKey) ||
+            !write_padded(stream, *record.fGlyphs)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkStrikeStore::populate(SkStrike* strike) const {
+    if (fEntries.count() == 0) {
+        return false;
+    }
+    std::optional<uint64_t> fontHash = this->cachedFontHash(strike->strikeSpec().typeface());
+    if (!fontHash) {
+        return false;
+    }
+    sk_sp<SkData> key = MakeKey(strike->strikeSpec(), *fontHash);
+    if (!key) {
+        return false;
+    }
+    const Entry* entry = fEntries.find(SkChecksum::Hash64(key->data(), key->size()));
+    if (!entry || entry->fKeySize != key->size() ||
+        0 != memcmp(entry->fKey, key->data(), key->size())) {
+        return false;
+    }
+    SkReadBuffer buffer(entry->fGlyphs, entry->fGlyphsSize);
+    return strike->mergeFromBuffer(buffer);
+}
+
+sk_sp<SkData> SkStrikeStore::MakeKey(const SkStrikeSpec& strikeSpec, uint64_t fontHash) {
+    const SkDescriptor& desc = strikeSpec.descriptor();
+    // Effects are flattened objects whose bytes may differ between processes; don't store them.
+    if (desc.getCount() != 1) {
+        return nullptr;
+    }
+    uint32_t recSize;
+    const void* recData = desc.findEntry(kRec_SkDescriptorTag, &recSize);
+    if (!recData || recSize != sizeof(SkScalerContextRec)) {
+        return nullptr;
+    }
+    SkScalerContextRec rec = *static_cast<const SkScalerContextRec*>(recData);
+    rec.fTypefaceID = 0;  // Only meaningful in this process; the font hash replaces it.
+
+    sk_sp<SkData> key = SkData::MakeUninitialized(sizeof(fontHash) + sizeof(rec));
+    memcpy(key->writable_data(), &fontHash, sizeof(fontHash));
+    memcpy(SkTAddOffset<void>(key->writable_data(), sizeof(fontHash)), &rec, sizeof(rec));
+    return key;
+}
+
+std::optional<uint64_t> SkStrikeStore::HashFont(const SkTypeface& typeface) {
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> stream = typeface.openStream(&ttcIndex);
+    if (!stream) {
+        return std::nullopt;
+    }
+    sk_sp<SkData> fontData;
+    if (const void* base = stream->getMemoryBase()) {
+        fontData = SkData::MakeWithoutCopy(base, stream->getLength());
+    } else {
+        fontData = SkData::MakeFromStream(stream.get(), stream->getLength());
+    }
+    if (!fontData) {
+        return std::nullopt;
+    }
+    uint64_t hash = SkChecksum::Hash64(fontData->data(), fontData->size(), SkToU64(ttcIndex));
+
+    // The same file may be instantiated at different variation positions.
+    const int axisCount = typeface.getVariationDesignPosition(nullptr, 0);
+    if (axisCount > 0) {
+        AutoTMalloc<SkFontArguments::VariationPosition::Coordinate> coords(axisCount);
+        if (typeface.getVariationDesignPosition(coords.get(), axisCount) == axisCount) {
+            hash = SkChecksum::Hash64(coords.get(), axisCount * sizeof(coords[0]), hash);
+        }
+    }
+    return hash;
+}
+
+std::optional<uint64_t> SkStrikeStore::cachedFontHash(const SkTypeface& typeface) const {
+    {
+        SkAutoMutexExclusive lock(fFontHashLock);
+        if (std::optional<uint64_t>* hash = fFontHashes.find(typeface.uniqueID())) {
+            return *hash;
+        }
+    }
+    // Hash without holding the lock; racing threads compute the same value.
+    std::optional<uint64_t> hash = HashFont(typeface);
+    SkAutoMutexExclusive lock(fFontHashLock);
+    fFontHashes.set(typeface.uniqueID(), hash);
+    return hash;
+}
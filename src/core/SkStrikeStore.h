@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrikeStore_DEFINED
+#define SkStrikeStore_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkTHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+class SkStrike;
+class SkStrikeCache;
+class SkStrikeSpec;
+class SkTypeface;
+class SkWStream;
+
+// A persistent store of rasterized glyphs, so a new process can skip rasterizing the glyphs an
+// earlier process already drew. Strikes are keyed by their SkScalerContextRec, with the typeface
+// ID replaced by a hash of the font file's contents, so keys are stable across processes.
+//
+// The store reads straight out of its SkData, which is usually a memory mapped file. Opening a
+// store only indexes it; a strike's glyphs are read when the strike is first created.
+class SkStrikeStore final : public SkRefCnt {
+public:
+    // Returns nullptr if data is not a valid store written by this version of Skia.
+    static sk_sp<SkStrikeStore> MakeFromData(sk_sp<SkData> data);
+
+    // Write the metrics, images and paths of the glyphs in cache's strikes to stream. Strikes
+    // with effects (path effects, mask filters) or without a font file are skipped.
+    static bool Write(SkStrikeCache* cache, SkWStream* stream);
+
+    // Add the glyphs stored for strike, if any. Returns true if any were added.
+    bool populate(SkStrike* strike) const;
+
+    int count() const { return fEntries.count(); }
+
+private:
+    struct Entry {
+        const void* fKey;
+        size_t      fKeySize;
+        const void* fGlyphs;
+        size_t      fGlyphsSize;
+    };
+
+    explicit SkStrikeStore(sk_sp<SkData> data) : fData(std::move(data)) {}
+
+    // The key bytes for a strike, or nullptr if it can not be stored. The first 8 bytes are the
+    // font hash.
+    static sk_sp<SkData> MakeKey(const SkStrikeSpec&, uint64_t fontHash);
+    static std::optional<uint64_t> HashFont(const SkTypeface&);
+    std::optional<uint64_t> cachedFontHash(const SkTypeface&) const SK_EXCLUDES(fFontHashLock);
+
+    const sk_sp<SkData> fData;
+    // Keyed by the 64 bit hash of the key bytes.
+    skia_private::THashMap<uint64_t, Entry> fEntries;
+
+    mutable SkMutex fFontHashLock;
+    mutable skia_private::THashMap<uint32_t, std::optional<uint64_t>> fFontHashes
+            SK_GUARDED_BY(fFontHashLock);
+};
+
+#endif  // SkStrikeStore_DEFINED
@@ -376,11 +376,8 @@ public:
         switch (encoding) {
             case SkTextEncoding::kUTF8: {
                 uni = fStorage.reset(byteLength);
-                const char* ptr = (const char*)text;
-                const char* end = ptr + byteLength;
-                for (int i = 0; ptr < end; ++i) {
-                    fStorage[i] = SkUTF::NextUTF8(&ptr, end);
-                }
+                SkUTF::UTF8ToUTF32(fStorage.get(), SkToInt(byteLength), (const char*)text,
+                                   byteLength);
             } break;
             case SkTextEncoding::kUTF16: {
                 uni = fStorage.reset(byteLength);
@@ -7,14 +7,26 @@
 
 #include "src/effects/colorfilters/SkComposeColorFilter.h"
 
+#include "include/core/SkColorTable.h"
 #include "include/core/SkRefCnt.h"
+#include "include/effects/SkColorMatrix.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkEffectPriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
+#include "src/effects/colorfilters/SkMatrixColorFilter.h"
+#include "src/effects/colorfilters/SkTableColorFilter.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <utility>
-struct SkStageRec;
+
+using namespace skia_private;
 
 SkComposeColorFilter::SkComposeColorFilter(sk_sp<SkColorFilter> outer, sk_sp<SkColorFilter> inner)
         : fOuter(as_CFB_sp(std::move(outer))), fInner(as_CFB_sp(std::move(inner))) {
@@ -26,12 +38,155 @@ bool SkComposeColorFilter::onIsAlphaUnchanged() const {
     return fOuter->isAlphaUnchanged() && fInner->isAlphaUnchanged();
 }
 
+// Collects the filters of nested compositions, innermost (applied first) first.
+static void collect_chain(const SkColorFilterBase* filter,
+                          TArray<const SkColorFilterBase*>* chain) {
+    if (filter->type() == SkColorFilterBase::Type::kCompose) {
+        auto compose = static_cast<const SkComposeColorFilter*>(filter);
+        collect_chain(compose->inner().get(), chain);
+        collect_chain(compose->outer().get(), chain);
+    } else {
+        chain->push_back(filter);
+    }
+}
+
+static const SkMatrixColorFilter* as_rgba_matrix(const SkColorFilterBase* filter) {
+    if (filter->type() != SkColorFilterBase::Type::kMatrix) {
+        return nullptr;
+    }
+    auto matrix = static_cast<const SkMatrixColorFilter*>(filter);
+    return matrix->domain() == SkMatrixColorFilter::Domain::kRGBA ? matrix : nullptr;
+}
+
+// Folds outer into m, a matrix that is applied first and then clamped as clamp says, if one matrix
+// gives the same premul colors as running both. That requires the clamp, and the premul and
+// unpremul between them, to leave every channel outer reads alone.
+static bool fold_matrix(float m[20], SkColorFilters::Clamp* clamp,
+                        const SkMatrixColorFilter& outer) {
+    const float* o = outer.matrix();
+    auto reads = [o](int c) {
+        return o[c] != 0 || o[5 + c] != 0 || o[10 + c] != 0 || o[15 + c] != 0;
+    };
+    // A row that ignores its input can be clamped once, here.
+    auto is_constant = [m](int row) {
+        return m[5 * row] == 0 && m[5 * row + 1] == 0 && m[5 * row + 2] == 0 && m[5 * row + 3] == 0;
+    };
+    const bool readsRGB = reads(0) || reads(1) || reads(2);
+
+    float inner[20];
+    memcpy(inner, m, sizeof(inner));
+    for (int c = 0; c < 3; ++c) {
+        if (*clamp == SkColorFilters::Clamp::kYes) {
+            if (is_constant(c)) {
+                inner[5 * c + 4] = SkTPin(inner[5 * c + 4], 0.0f, 1.0f);
+            } else if (reads(c)) {
+                return false;
+            }
+        }
+    }
+    // Alpha is always clamped, which changes nothing if it is a scale and bias of the incoming
+    // alpha that stays in [0,1].
+    const float alphaScale = m[18], alphaBias = m[19];
+    const bool alphaInRange = m[15] == 0 && m[16] == 0 && m[17] == 0 &&
+                              alphaBias >= 0 && alphaBias <= 1 &&
+                              alphaBias + alphaScale >= 0 && alphaBias + alphaScale <= 1;
+    if (is_constant(3)) {
+        inner[19] = SkTPin(inner[19], 0.0f, 1.0f);
+    } else if (!alphaInRange && reads(3)) {
+        return false;
+    }
+    // Where the alpha in between is zero, premul zeroes the color that outer would read. That is
+    // only invisible if outer's alpha is zero there too.
+    const bool alphaNeverZero = (is_constant(3) && inner[19] > 0) ||
+                                (alphaInRange && alphaBias > 0 && alphaBias + alphaScale > 0);
+    const bool outerAlphaScalesAlpha = o[15] == 0 && o[16] == 0 && o[17] == 0 && o[19] == 0;
+    if (readsRGB && !alphaNeverZero && !outerAlphaScalesAlpha) {
+        return false;
+    }
+
+    SkColorMatrix folded;
+    folded.setRowMajor(inner);
+    SkColorMatrix outerMatrix;
+    outerMatrix.setRowMajor(o);
+    folded.postConcat(outerMatrix);
+    folded.getRowMajor(m);
+    *clamp = outer.clamp();
+    return true;
+}
+
+// Folds outer into tables, which are applied first, if one lookup gives the same premul colors as
+// two. Where the alpha in between is zero, premul zeroes the colors outer looks up, so outer's
+// alpha must be zero there too.
+static bool fold_tables(uint8_t tables[4 * 256], const SkColorTable& outer) {
+    const bool innerHasZeroAlpha = std::find(tables, tables + 256, 0) != tables + 256;
+    if (innerHasZeroAlpha && outer.alphaTable()[0] != 0) {
+        return false;
+    }
+    const uint8_t* outerTables[4] = {outer.alphaTable(), outer.redTable(), outer.greenTable(),
+                                     outer.blueTable()};
+    for (int c = 0; c < 4; ++c) {
+        for (int i = 0; i < 256; ++i) {
+            tables[256 * c + i] = outerTables[c][tables[256 * c + i]];
+        }
+    }
+    return true;
+}
+
 bool SkComposeColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
-    bool innerIsOpaque = shaderIsOpaque;
-    if (!fInner->isAlphaUnchanged()) {
-        innerIsOpaque = false;
+    // Chains of matrices or of tables, as SVG and Skottie build them, are folded into one matrix
+    // or one table, saving a pass over the colors and the premul and unpremul around each one.
+    STArray<4, const SkColorFilterBase*> chain;
+    collect_chain(this, &chain);
+
+    bool isOpaque = shaderIsOpaque;
+    for (int i = 0; i < chain.size();) {
+        const SkColorFilterBase* filter = chain[i];
+        int next = i + 1;
+        if (const SkMatrixColorFilter* matrix = as_rgba_matrix(filter)) {
+            float folded[20];
+            memcpy(folded, matrix->matrix(), sizeof(folded));
+            SkColorFilters::Clamp clamp = matrix->clamp();
+            const SkMatrixColorFilter* outer;
+            while (next < chain.size() && (outer = as_rgba_matrix(chain[next])) &&
+                   fold_matrix(folded, &clamp, *outer)) {
+                ++next;
+            }
+            if (next > i + 1) {
+                float* storage = rec.fAlloc->makeArray<float>(20);
+                memcpy(storage, folded, sizeof(folded));
+                SkMatrixColorFilter::AppendMatrixStages(rec, isOpaque, storage,
+                                                        SkMatrixColorFilter::Domain::kRGBA, clamp);
+            }
+        } else if (filter->type() == SkColorFilterBase::Type::kTable) {
+            uint8_t folded[4 * 256];
+            const SkColorTable* table = static_cast<const SkTableColorFilter*>(filter)->table();
+            memcpy(folded + 0 * 256, table->alphaTable(), 256);
+            memcpy(folded + 1 * 256, table->redTable(), 256);
+            memcpy(folded + 2 * 256, table->greenTable(), 256);
+            memcpy(folded + 3 * 256, table->blueTable(), 256);
+            while (next < chain.size() && chain[next]->type() == SkColorFilterBase::Type::kTable &&
+                   fold_tables(folded,
+                               *static_cast<const SkTableColorFilter*>(chain[next])->table())) {
+                ++next;
+            }
+            if (next > i + 1) {
+                uint8_t* storage = rec.fAlloc->makeArrayDefault<uint8_t>(sizeof(folded));
+                memcpy(storage, folded, sizeof(folded));
+                SkTableColorFilter::AppendTableStages(rec, isOpaque, storage + 0 * 256,
+                                                      storage + 1 * 256, storage + 2 * 256,
+                                                      storage + 3 * 256);
+            }
+        }
+        if (next == i + 1 && !filter->appendStages(rec, isOpaque)) {
+            return false;
+        }
+        for (; i < next; ++i) {
+            if (!chain[i]->isAlphaUnchanged()) {
+                isOpaque = false;
+            }
+        }
     }
-    return fInner->appendStages(rec, shaderIsOpaque) && fOuter->appendStages(rec, innerIsOpaque);
+    return true;
 }
 
 void SkComposeColorFilter::flatten(SkWriteBuffer& buffer) const {
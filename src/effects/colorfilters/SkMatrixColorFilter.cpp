@@ -68,9 +68,14 @@ bool SkMatrixColorFilter::onAsAColorMatrix(float matrix[20]) const {
 }
 
 bool SkMatrixColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
-    const bool willStayOpaque = shaderIsOpaque && fAlphaIsUnchanged,
-               hsla = fDomain == Domain::kHSLA,
-               clamp = fClamp == Clamp::kYes;
+    AppendMatrixStages(rec, shaderIsOpaque, fMatrix, fDomain, fClamp);
+    return true;
+}
+
+void SkMatrixColorFilter::AppendMatrixStages(const SkStageRec& rec, bool shaderIsOpaque,
+                                             const float matrix[20], Domain domain, Clamp clamp) {
+    const bool willStayOpaque = shaderIsOpaque && is_alpha_unchanged(matrix),
+               hsla = domain == Domain::kHSLA;
 
     SkRasterPipeline* p = rec.fPipeline;
     if (!shaderIsOpaque) {
@@ -80,12 +85,12 @@ bool SkMatrixColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaqu
         p->append(SkRasterPipelineOp::rgb_to_hsl);
     }
     if (true) {
-        p->append(SkRasterPipelineOp::matrix_4x5, fMatrix);
+        p->append(SkRasterPipelineOp::matrix_4x5, matrix);
     }
     if (hsla) {
         p->append(SkRasterPipelineOp::hsl_to_rgb);
     }
-    if (clamp) {
+    if (clamp == Clamp::kYes) {
         p->append(SkRasterPipelineOp::clamp_01);
     } else {
         // We still need to clamp alpha, regardless
@@ -94,7 +99,6 @@ bool SkMatrixColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaqu
     if (!willStayOpaque) {
         p->append(SkRasterPipelineOp::premul);
     }
-    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
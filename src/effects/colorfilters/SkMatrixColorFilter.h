@@ -27,6 +27,10 @@ public:
 
     bool appendStages(const SkStageRec& rec, bool shaderIsOpaque) const override;
 
+    // Appends the stages of a matrix filter; matrix must outlive the pipeline.
+    static void AppendMatrixStages(const SkStageRec& rec, bool shaderIsOpaque,
+                                   const float matrix[20], Domain, Clamp);
+
     bool onIsAlphaUnchanged() const override { return fAlphaIsUnchanged; }
 
     SkColorFilterBase::Type type() const override { return SkColorFilterBase::Type::kMatrix; }
@@ -23,23 +23,30 @@
 #include <utility>
 
 bool SkTableColorFilter::appendStages(const SkStageRec& rec, bool shaderIsOpaque) const {
+    AppendTableStages(rec, shaderIsOpaque, fTable->alphaTable(), fTable->redTable(),
+                      fTable->greenTable(), fTable->blueTable());
+    return true;
+}
+
+void SkTableColorFilter::AppendTableStages(const SkStageRec& rec, bool shaderIsOpaque,
+                                           const uint8_t* tableA, const uint8_t* tableR,
+                                           const uint8_t* tableG, const uint8_t* tableB) {
     SkRasterPipeline* p = rec.fPipeline;
     if (!shaderIsOpaque) {
         p->append(SkRasterPipelineOp::unpremul);
     }
 
     SkRasterPipeline_TablesCtx* tables = rec.fAlloc->make<SkRasterPipeline_TablesCtx>();
-    tables->a = fTable->alphaTable();
-    tables->r = fTable->redTable();
-    tables->g = fTable->greenTable();
-    tables->b = fTable->blueTable();
+    tables->a = tableA;
+    tables->r = tableR;
+    tables->g = tableG;
+    tables->b = tableB;
     p->append(SkRasterPipelineOp::byte_tables, tables);
 
     bool definitelyOpaque = shaderIsOpaque && tables->a[0xff] == 0xff;
     if (!definitelyOpaque) {
         p->append(SkRasterPipelineOp::premul);
     }
-    return true;
 }
 
 void SkTableColorFilter::flatten(SkWriteBuffer& buffer) const {
@@ -14,6 +14,8 @@
 #include "include/private/base/SkDebug.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
+#include <cstdint>
+
 class SkBitmap;
 class SkReadBuffer;
 class SkWriteBuffer;
@@ -29,9 +31,15 @@ public:
 
     bool appendStages(const SkStageRec& rec, bool shaderIsOpaque) const override;
 
+    // Appends the stages of a table filter; the tables must outlive the pipeline.
+    static void AppendTableStages(const SkStageRec& rec, bool shaderIsOpaque,
+                                  const uint8_t* tableA, const uint8_t* tableR,
+                                  const uint8_t* tableG, const uint8_t* tableB);
+
     void flatten(SkWriteBuffer& buffer) const override;
 
     const SkBitmap& bitmap() const { return fTable->bitmap(); }
+    const SkColorTable* table() const { return fTable.get(); }
 
 private:
     friend void ::SkRegisterTableColorFilterFlattenable();
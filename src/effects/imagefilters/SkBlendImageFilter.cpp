@@ -86,6 +86,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     sk_sp<SkShader> makeBlendShader(sk_sp<SkShader> bg, sk_sp<SkShader> fg) const;
 
     sk_sp<SkBlender> fBlender;
@@ -308,9 +312,11 @@ skif::FilterResult SkBlendImageFilter::onFilterImage(const skif::Context& ctx) c
     }
 
     skif::Context inputCtx = ctx.withNewDesiredOutput(*requiredInput);
+    skif::FilterResult childOutputs[2];
+    this->getChildOutputs(inputCtx, childOutputs);
     skif::FilterResult::Builder builder{ctx};
-    builder.add(this->getChildOutput(kBackground, inputCtx));
-    builder.add(this->getChildOutput(kForeground, inputCtx));
+    builder.add(childOutputs[kBackground]);
+    builder.add(childOutputs[kForeground]);
     return builder.eval(
             [&](SkSpan<sk_sp<SkShader>> inputs) -> sk_sp<SkShader> {
                 return this->makeBlendShader(inputs[kBackground], inputs[kForeground]);
@@ -427,6 +433,20 @@ std::optional<skif::LayerSpace<SkIRect>> SkBlendImageFilter::onGetOutputLayerBou
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkBlendImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Every blender combines the foreground and background pixel by pixel, so only the union of
+    // their damage changes.
+    auto foregroundDamage = this->getChildDamagedLayerBounds(kForeground, mapping, damage);
+    auto backgroundDamage = this->getChildDamagedLayerBounds(kBackground, mapping, damage);
+    if (!foregroundDamage || !backgroundDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    backgroundDamage->join(*foregroundDamage);
+    return backgroundDamage;
+}
+
 SkRect SkBlendImageFilter::computeFastBounds(const SkRect& bounds) const {
     // TODO: This is a prime example of why computeFastBounds() and onGetOutputLayerBounds() should
     // be combined into the same function.
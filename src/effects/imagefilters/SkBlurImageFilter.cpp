@@ -62,6 +62,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     skif::LayerSpace<SkSize> mapSigma(const skif::Mapping& mapping, bool useBlurEngine) const;
 
     skif::LayerSpace<SkIRect> kernelBounds(const skif::Mapping& mapping,
@@ -276,6 +280,20 @@ std::optional<skif::LayerSpace<SkIRect>> SkBlurImageFilter::onGetOutputLayerBoun
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkBlurImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    if (fLegacyTileMode != SkTileMode::kDecal) {
+        // Legacy tiling samples the child output's edges from anywhere in the output.
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    auto childDamage = this->getChildDamagedLayerBounds(0, mapping, damage);
+    if (!childDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    return this->kernelBounds(mapping, *childDamage, /*useBlurEngine=*/true);
+}
+
 SkRect SkBlurImageFilter::computeFastBounds(const SkRect& src) const {
     SkRect bounds = this->getInput(0) ? this->getInput(0)->computeFastBounds(src) : src;
     bounds.outset(SkSize(fSigma).width() * 3, SkSize(fSigma).height() * 3);
@@ -50,6 +50,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     MatrixCapability onGetCTMCapability() const override { return MatrixCapability::kComplex; }
 
     bool onAffectsTransparentBlack() const override {
@@ -138,6 +142,14 @@ std::optional<skif::LayerSpace<SkIRect>> SkColorFilterImageFilter::onGetOutputLa
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkColorFilterImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Color filters map each pixel on its own, so even those that affect transparent black only
+    // change where their input did.
+    return this->getChildDamagedLayerBounds(0, mapping, damage);
+}
+
 SkRect SkColorFilterImageFilter::computeFastBounds(const SkRect& bounds) const {
     // See comment in onGetOutputLayerBounds().
     if (as_CFB(fColorFilter)->affectsTransparentBlack()) {
@@ -59,6 +59,10 @@ private:
     std::optional<skif::LayerSpace<SkIRect>> onGetOutputLayerBounds(
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
+
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
 };
 
 } // end namespace
@@ -139,6 +143,17 @@ std::optional<skif::LayerSpace<SkIRect>> SkComposeImageFilter::onGetOutputLayerB
     return this->getChildOutputLayerBounds(kOuter, mapping, innerBounds);
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkComposeImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // The inner filter's damaged output is the damaged input of the outer filter.
+    auto innerDamage = this->getChildDamagedLayerBounds(kInner, mapping, damage);
+    if (!innerDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    return this->getChildDamagedLayerBounds(kOuter, mapping, *innerDamage);
+}
+
 SkRect SkComposeImageFilter::computeFastBounds(const SkRect& src) const {
     return this->getInput(kOuter)->computeFastBounds(
             this->getInput(kInner)->computeFastBounds(src));
@@ -65,6 +65,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     // The crop rect is specified in floating point to allow cropping to partial local pixels,
     // that could become whole pixels in the layer-space image if the canvas is scaled.
     // For now it's always rounded to integer pixels as if it were non-AA.
@@ -213,6 +217,24 @@ std::optional<skif::LayerSpace<SkIRect>> SkCropImageFilter::onGetOutputLayerBoun
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkCropImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    auto childDamage = this->getChildDamagedLayerBounds(0, mapping, damage);
+    if (!childDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    skif::LayerSpace<SkIRect> crop = this->cropRect(mapping);
+    if (!crop.intersect(*childDamage)) {
+        // Nothing within the crop rect changed, so neither does any tile of it.
+        return skif::LayerSpace<SkIRect>::Empty();
+    } else if (fTileMode != SkTileMode::kDecal) {
+        // Any other tile mode repeats the damaged pixels across the output.
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    return crop;
+}
+
 SkRect SkCropImageFilter::computeFastBounds(const SkRect& bounds) const {
     // TODO(michaelludwig) - This is conceptually very similar to calling onGetOutputLayerBounds()
     // with an identity skif::Mapping (hence why fCropRect can be used directly), but it also does
@@ -7,11 +7,16 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
@@ -20,13 +25,18 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <cstdint>
 #include <optional>
 #include <utility>
 
@@ -69,6 +79,21 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
+    // Displaces a raster color output directly by a raster displacement map, rather than
+    // evaluating the shader. Returns nullopt when either isn't a raster N32 image.
+    std::optional<skif::FilterResult> filterRaster(
+            const skif::Context& ctx,
+            const skif::Context& displacementCtx,
+            const skif::FilterResult& displacementOutput,
+            const skif::FilterResult& colorOutput,
+            const skif::LayerSpace<SkIRect>& requiredColorInput,
+            const skif::LayerSpace<SkIRect>& outputBounds,
+            const skif::LayerSpace<skif::Vector>& scale) const;
+
     skif::LayerSpace<SkIRect> outsetByMaxDisplacement(const skif::Mapping& mapping,
                                                       skif::LayerSpace<SkIRect> bounds) const {
         // For max displacement, we treat 'scale' as a size instead of a vector. The vector offset
@@ -137,6 +162,73 @@ sk_sp<SkShader> make_displacement_shader(
     return builder.makeShader();
 }
 
+// The byte holding 'channel' in an N32 pixel of 'colorType'.
+int channel_byte(SkColorChannel channel, SkColorType colorType) {
+    const bool bgra = colorType == kBGRA_8888_SkColorType;
+    switch (channel) {
+        case SkColorChannel::kR: return bgra ? 2 : 0;
+        case SkColorChannel::kG: return 1;
+        case SkColorChannel::kB: return bgra ? 0 : 2;
+        case SkColorChannel::kA: return 3;
+    }
+    SkUNREACHABLE;
+}
+
+// The raster backend unpacks the selected channels of a row of the displacement map, computes the
+// sample coordinates 8 pixels at a time, and then gathers the color pixels, treating coordinates
+// outside of the color image as transparent, like the shader's decal sampling.
+//
+// 'displ' and 'color' have their top-left at 'displOrigin' and 'colorOrigin' in layer space, and
+// 'dst' covers 'dstBounds'. 'xByte' and 'yByte' select bytes of the displacement pixels.
+void displace_raster(const SkPixmap& displ, SkIPoint displOrigin,
+                     const SkPixmap& color, SkIPoint colorOrigin,
+                     const SkIRect& dstBounds, SkVector scale, int xByte, int yByte,
+                     const SkPixmap& dst) {
+    using float8 = skvx::float8;
+    using int8 = skvx::int8;
+
+    const int width = dstBounds.width();
+    const int alignedWidth = SkAlign8(width);
+    skia_private::AutoTMalloc<float> selectX(alignedWidth), selectY(alignedWidth);
+    // Unpremultiplied, as the shader does; for color channels that is just the byte over alpha.
+    auto unpremul = [](const uint8_t* pixel, int byte) {
+        const uint8_t a = pixel[3];
+        return byte == 3 ? a * (1 / 255.f) : (a ? pixel[byte] / static_cast<float>(a) : 0.f);
+    };
+
+    const float8 laneOffsets = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f};
+    for (int j = 0; j < dstBounds.height(); ++j) {
+        const int displY = dstBounds.fTop + j - displOrigin.fY;
+        for (int i = 0; i < alignedWidth; ++i) {
+            const int displX = dstBounds.fLeft + i - displOrigin.fX;
+            if (i < width && displX >= 0 && displX < displ.width() &&
+                displY >= 0 && displY < displ.height()) {
+                const auto* pixel = static_cast<const uint8_t*>(displ.addr(displX, displY));
+                selectX[i] = unpremul(pixel, xByte);
+                selectY[i] = unpremul(pixel, yByte);
+            } else {
+                selectX[i] = selectY[i] = 0.f;
+            }
+        }
+
+        const float centerY = dstBounds.fTop + j + 0.5f;
+        uint32_t* dstRow = dst.writable_addr32(0, j);
+        for (int i = 0; i < width; i += 8) {
+            const float8 sampleX = ((dstBounds.fLeft + i) + laneOffsets) +
+                                   scale.fX * (float8::Load(selectX.get() + i) - 0.5f);
+            const float8 sampleY = centerY + scale.fY * (float8::Load(selectY.get() + i) - 0.5f);
+            const int8 colorX = skvx::cast<int>(skvx::floor(sampleX)) - colorOrigin.fX;
+            const int8 colorY = skvx::cast<int>(skvx::floor(sampleY)) - colorOrigin.fY;
+            for (int lane = 0; lane < 8 && i + lane < width; ++lane) {
+                const int x = colorX[lane];
+                const int y = colorY[lane];
+                const bool inside = x >= 0 && x < color.width() && y >= 0 && y < color.height();
+                dstRow[i + lane] = inside ? *color.addr32(x, y) : 0;
+            }
+        }
+    }
+}
+
 }  // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -222,9 +314,9 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
     //   With a more complex DAG attached to this input, it's not clear that working in ANY specific
     //   color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     //   ideal, but it's at least consistent and predictable.
-    skif::FilterResult displacementOutput =
-            this->getChildOutput(kDisplacement, ctx.withNewDesiredOutput(outputBounds)
-                                                   .withNewColorSpace(/*cs=*/nullptr));
+    const skif::Context displacementCtx = ctx.withNewDesiredOutput(outputBounds)
+                                             .withNewColorSpace(/*cs=*/nullptr);
+    skif::FilterResult displacementOutput = this->getChildOutput(kDisplacement, displacementCtx);
 
     // NOTE: The scale is a "vector" not a "size" since we want to preserve negations on the final
     // displacement vector.
@@ -241,6 +333,12 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
 
     // If we made it this far, then we actually have per-pixel displacement affecting the color
     // image. We need to evaluate each pixel within 'outputBounds'.
+    if (std::optional<skif::FilterResult> result =
+                this->filterRaster(ctx, displacementCtx, displacementOutput, colorOutput,
+                                   requiredColorInput, outputBounds, scale)) {
+        return *result;
+    }
+
     using ShaderFlags = skif::FilterResult::ShaderFlags;
 
     skif::FilterResult::Builder builder{ctx};
@@ -256,6 +354,35 @@ skif::FilterResult SkDisplacementMapImageFilter::onFilterImage(const skif::Conte
             }, outputBounds);
 }
 
+std::optional<skif::FilterResult> SkDisplacementMapImageFilter::filterRaster(
+        const skif::Context& ctx,
+        const skif::Context& displacementCtx,
+        const skif::FilterResult& displacementOutput,
+        const skif::FilterResult& colorOutput,
+        const skif::LayerSpace<SkIRect>& requiredColorInput,
+        const skif::LayerSpace<SkIRect>& outputBounds,
+        const skif::LayerSpace<skif::Vector>& scale) const {
+    auto displ = displacementOutput.asN32Bitmap(displacementCtx);
+    auto color = colorOutput.asN32Bitmap(ctx.withNewDesiredOutput(requiredColorInput));
+    if (!displ || !color || displ->first.isNull() || color->first.isNull()) {
+        return std::nullopt;
+    }
+    const SkBitmap& displBitmap = displ->first;
+    const skif::LayerSpace<SkIPoint>& displOrigin = displ->second;
+    const SkBitmap& colorBitmap = color->first;
+    const skif::LayerSpace<SkIPoint>& colorOrigin = color->second;
+
+    return skif::FilterResult::MakeFromRaster(
+            ctx, colorBitmap.colorType(), outputBounds, [&](const SkPixmap& dst) {
+                displace_raster(displBitmap.pixmap(), SkIPoint(displOrigin),
+                                colorBitmap.pixmap(), SkIPoint(colorOrigin),
+                                SkIRect(outputBounds), SkVector{scale.x(), scale.y()},
+                                channel_byte(fXChannel, displBitmap.colorType()),
+                                channel_byte(fYChannel, displBitmap.colorType()),
+                                dst);
+            });
+}
+
 skif::LayerSpace<SkIRect> SkDisplacementMapImageFilter::onGetInputLayerBounds(
         const skif::Mapping& mapping,
         const skif::LayerSpace<SkIRect>& desiredOutput,
@@ -283,6 +410,21 @@ std::optional<skif::LayerSpace<SkIRect>> SkDisplacementMapImageFilter::onGetOutp
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkDisplacementMapImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Damaged color pixels can be displaced up to the max displacement, while a damaged
+    // displacement pixel only changes the output pixel where it is.
+    auto colorDamage = this->getChildDamagedLayerBounds(kColor, mapping, damage);
+    auto displacementDamage = this->getChildDamagedLayerBounds(kDisplacement, mapping, damage);
+    if (!colorDamage || !displacementDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    skif::LayerSpace<SkIRect> outputDamage = this->outsetByMaxDisplacement(mapping, *colorDamage);
+    outputDamage.join(*displacementDamage);
+    return outputDamage;
+}
+
 SkRect SkDisplacementMapImageFilter::computeFastBounds(const SkRect& src) const {
     SkRect colorBounds = this->getInput(kColor) ? this->getInput(kColor)->computeFastBounds(src)
                                                 : src;
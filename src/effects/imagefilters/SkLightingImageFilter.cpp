@@ -7,10 +7,15 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
 #include "include/core/SkRect.h"
@@ -19,16 +24,23 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <cmath>
 #include <optional>
 #include <utility>
 
@@ -156,6 +168,20 @@ struct Material {
     }
 };
 
+// A light and material mapped to layer space, for evaluating the lighting equation on the CPU.
+struct LayerLight {
+    Light::Type fLightType;
+    SkV3 fColor;       // Already scaled by the material's k
+    SkV3 fLocation;    // Spot and point lights only
+    SkV3 fDirection;   // Normalized; spot and distant lights only
+    float fFalloffExponent;
+    float fCosCutoffAngle;
+
+    Material::Type fMaterialType;
+    float fSurfaceDepth;
+    float fShininess;
+};
+
 class SkLightingImageFilter final : public SkImageFilter_Base {
 public:
     SkLightingImageFilter(const Light& light, const Material& material, sk_sp<SkImageFilter> input)
@@ -188,6 +214,15 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    // Computes the normals and the lighting equation directly over a raster child output, rather
+    // than evaluating the shaders. Returns nullopt when the child output isn't a raster N32 image.
+    std::optional<skif::FilterResult> filterRaster(
+            const skif::Context& ctx,
+            const skif::FilterResult& childOutput,
+            const skif::LayerSpace<SkIRect>& requiredInput,
+            const skif::LayerSpace<SkIRect>& clampRect,
+            const LayerLight& light) const;
+
     skif::LayerSpace<SkIRect> requiredInput(const skif::LayerSpace<SkIRect>& desiredOutput) const {
         // We request 1px of padding so that the visible normal map can do a regular Sobel kernel
         // eval. The Sobel kernel is always applied in layer pixels
@@ -276,6 +311,136 @@ sk_sp<SkShader> make_lighting_shader(sk_sp<SkShader> normalMap,
     return builder.makeShader();
 }
 
+// The raster backend evaluates the normal and lighting shaders in two passes over each row. The
+// first computes the Sobel normals from the alpha of three rows into a normal map of the row, so
+// each alpha is read once per row instead of 9 times per pixel. The second evaluates the lighting
+// equation for 8 pixels at a time.
+using float8 = skvx::float8;
+
+SK_ALWAYS_INLINE float8 pow8(const float8& x, float y) {
+    // Matches pow() for the non-negative bases the shader expects; negative ones are clamped.
+    return skvx::map([y](float b) { return std::pow(std::max(b, 0.f), y); }, x);
+}
+
+SK_ALWAYS_INLINE void normalize(float8* x, float8* y, float8* z) {
+    const float8 invLength = 1.f / skvx::sqrt(*x * *x + *y * *y + *z * *z);
+    *x *= invLength;
+    *y *= invLength;
+    *z *= invLength;
+}
+
+// 'src' is the child output with its top-left at 'srcOrigin' in layer space; pixels outside of it
+// are transparent. Its alpha is sampled with coordinates clamped to 'clampRect', and 'dst' covers
+// 'dstBounds'.
+void light_raster(const SkPixmap& src, SkIPoint srcOrigin, const SkIRect& clampRect,
+                  const SkIRect& dstBounds, const LayerLight& light, const SkPixmap& dst) {
+    const int width = dstBounds.width();
+    const int height = dstBounds.height();
+    const int alignedWidth = SkAlign8(width);
+
+    // The alpha of every pixel the Sobel kernel reads, one pixel beyond 'dstBounds' on each side.
+    const int alphaStride = alignedWidth + 2;
+    skia_private::AutoTMalloc<float> alpha(SkToSizeT(alphaStride) * (height + 2));
+    for (int j = 0; j < height + 2; ++j) {
+        const int y = SkTPin(dstBounds.fTop - 1 + j, clampRect.fTop, clampRect.fBottom - 1) -
+                      srcOrigin.fY;
+        float* alphaRow = alpha.get() + SkToSizeT(j) * alphaStride;
+        for (int i = 0; i < alphaStride; ++i) {
+            const int x = SkTPin(dstBounds.fLeft - 1 + i, clampRect.fLeft, clampRect.fRight - 1) -
+                          srcOrigin.fX;
+            const bool inside = x >= 0 && x < src.width() && y >= 0 && y < src.height();
+            // Alpha is the last byte of both RGBA and BGRA.
+            alphaRow[i] = inside ? (*src.addr32(x, y) >> 24) * (1 / 255.f) : 0.f;
+        }
+    }
+
+    skia_private::AutoTMalloc<float> normalX(alignedWidth), normalY(alignedWidth),
+                                     normalZ(alignedWidth), centerAlpha(alignedWidth);
+    const float negDepth = -light.fSurfaceDepth;
+    const float8 laneOffsets = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f};
+    for (int j = 0; j < height; ++j) {
+        const float* r0 = alpha.get() + SkToSizeT(j) * alphaStride;
+        const float* r1 = r0 + alphaStride;
+        const float* r2 = r1 + alphaStride;
+        for (int i = 0; i < alignedWidth; i += 8) {
+            // Columns i, i + 1 and i + 2 of the alpha are x - 1, x and x + 1.
+            const float8 left = float8::Load(r0 + i) + 2.f * float8::Load(r1 + i) +
+                                float8::Load(r2 + i);
+            const float8 right = float8::Load(r0 + i + 2) + 2.f * float8::Load(r1 + i + 2) +
+                                 float8::Load(r2 + i + 2);
+            const float8 top = float8::Load(r0 + i) + 2.f * float8::Load(r0 + i + 1) +
+                               float8::Load(r0 + i + 2);
+            const float8 bottom = float8::Load(r2 + i) + 2.f * float8::Load(r2 + i + 1) +
+                                  float8::Load(r2 + i + 2);
+            float8 nx = negDepth * 0.25f * (right - left);
+            float8 ny = negDepth * 0.25f * (bottom - top);
+            float8 nz = 1.f;
+            normalize(&nx, &ny, &nz);
+            nx.store(normalX.get() + i);
+            ny.store(normalY.get() + i);
+            nz.store(normalZ.get() + i);
+            float8::Load(r1 + i + 1).store(centerAlpha.get() + i);
+        }
+
+        const float8 surfaceY = dstBounds.fTop + j + 0.5f;
+        uint32_t* dstRow = dst.writable_addr32(0, j);
+        for (int i = 0; i < width; i += 8) {
+            const float8 nx = float8::Load(normalX.get() + i);
+            const float8 ny = float8::Load(normalY.get() + i);
+            const float8 nz = float8::Load(normalZ.get() + i);
+
+            float8 sx, sy, sz;
+            if (light.fLightType == Light::Type::kDistant) {
+                sx = light.fDirection.x;
+                sy = light.fDirection.y;
+                sz = light.fDirection.z;
+            } else {
+                const float8 surfaceX = (dstBounds.fLeft + i) + laneOffsets;
+                const float8 surfaceZ = light.fSurfaceDepth * float8::Load(centerAlpha.get() + i);
+                sx = light.fLocation.x - surfaceX;
+                sy = light.fLocation.y - surfaceY;
+                sz = light.fLocation.z - surfaceZ;
+                normalize(&sx, &sy, &sz);
+            }
+
+            float8 scale = 1.f;
+            if (light.fLightType == Light::Type::kSpot) {
+                constexpr float kConeAAThreshold = 0.016f;
+                constexpr float kConeScale = 1.f / kConeAAThreshold;
+                const float cutoff = light.fCosCutoffAngle;
+                const float8 cosAngle = -(sx * light.fDirection.x + sy * light.fDirection.y +
+                                          sz * light.fDirection.z);
+                scale = pow8(cosAngle, light.fFalloffExponent);
+                scale = skvx::if_then_else(cosAngle < cutoff + kConeAAThreshold,
+                                           scale * (cosAngle - cutoff) * kConeScale, scale);
+                scale = skvx::if_then_else(cosAngle < cutoff, float8(0.f), scale);
+            }
+
+            float8 coeff;
+            if (light.fMaterialType == Material::Type::kDiffuse) {
+                coeff = nx * sx + ny * sy + nz * sz;
+            } else {
+                float8 hx = sx, hy = sy, hz = sz + 1.f;
+                normalize(&hx, &hy, &hz);
+                coeff = pow8(nx * hx + ny * hy + nz * hz, light.fShininess);
+            }
+            coeff *= scale;
+            const float8 r = skvx::pin(coeff * light.fColor.x, float8(0.f), float8(1.f));
+            const float8 g = skvx::pin(coeff * light.fColor.y, float8(0.f), float8(1.f));
+            const float8 b = skvx::pin(coeff * light.fColor.z, float8(0.f), float8(1.f));
+            const float8 a = light.fMaterialType == Material::Type::kDiffuse
+                                     ? float8(1.f)
+                                     : max(max(r, g), b);
+
+            const skvx::int8 r8 = skvx::lrint(r * 255.f), g8 = skvx::lrint(g * 255.f),
+                             b8 = skvx::lrint(b * 255.f), a8 = skvx::lrint(a * 255.f);
+            for (int lane = 0; lane < 8 && i + lane < width; ++lane) {
+                dstRow[i + lane] = SkPackARGB32(a8[lane], r8[lane], g8[lane], b8[lane]);
+            }
+        }
+    }
+}
+
 sk_sp<SkImageFilter> make_lighting(const Light& light,
                                    const Material& material,
                                    sk_sp<SkImageFilter> input,
@@ -551,6 +716,26 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
                 edgeClamp(inputRect.bottom(), requiredInput.bottom(), clampTo.bottom())});
     }
 
+    SkV3 dir{lightDirXY.x(), lightDirXY.y(), lightDirZ.val()};
+    const float dirLength = dir.length();
+    const float colorScale = fMaterial.fK / 255.f;
+    const LayerLight layerLight{fLight.fType,
+                                SkV3{SkColorGetR(fLight.fLightColor) * colorScale,
+                                     SkColorGetG(fLight.fLightColor) * colorScale,
+                                     SkColorGetB(fLight.fLightColor) * colorScale},
+                                SkV3{lightLocationXY.x(), lightLocationXY.y(),
+                                     lightLocationZ.val()},
+                                dirLength ? dir * (1.f / dirLength) : SkV3{0.f, 0.f, 0.f},
+                                fLight.fFalloffExponent,
+                                fLight.fCosCutoffAngle,
+                                fMaterial.fType,
+                                surfaceDepth.val(),
+                                fMaterial.fShininess};
+    if (std::optional<skif::FilterResult> result =
+                this->filterRaster(ctx, childOutput, requiredInput, clampRect, layerLight)) {
+        return *result;
+    }
+
     skif::FilterResult::Builder builder{ctx};
     builder.add(childOutput, /*sampleBounds=*/clampRect, ShaderFlags::kSampledRepeatedly);
     return builder.eval([&](SkSpan<sk_sp<SkShader>> input) {
@@ -579,6 +764,27 @@ skif::FilterResult SkLightingImageFilter::onFilterImage(const skif::Context& ctx
     });
 }
 
+std::optional<skif::FilterResult> SkLightingImageFilter::filterRaster(
+        const skif::Context& ctx,
+        const skif::FilterResult& childOutput,
+        const skif::LayerSpace<SkIRect>& requiredInput,
+        const skif::LayerSpace<SkIRect>& clampRect,
+        const LayerLight& light) const {
+    auto src = childOutput.asN32Bitmap(ctx.withNewDesiredOutput(requiredInput));
+    if (!src) {
+        return std::nullopt;
+    }
+    const SkBitmap& srcBitmap = src->first;
+    const skif::LayerSpace<SkIPoint>& srcOrigin = src->second;
+
+    return skif::FilterResult::MakeFromRaster(
+            ctx, kN32_SkColorType, ctx.desiredOutput(), [&](const SkPixmap& dst) {
+                light_raster(srcBitmap.pixmap(),
+                             srcBitmap.isNull() ? SkIPoint{0, 0} : SkIPoint(srcOrigin),
+                             SkIRect(clampRect), SkIRect(ctx.desiredOutput()), light, dst);
+            });
+}
+
 skif::LayerSpace<SkIRect> SkLightingImageFilter::onGetInputLayerBounds(
         const skif::Mapping& mapping,
         const skif::LayerSpace<SkIRect>& desiredOutput,
@@ -15,6 +15,7 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -31,14 +32,18 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <optional>
@@ -58,6 +63,9 @@ static_assert(kMaxUniformKernelSize % 4 == 0, "Must be a multiple of 4");
 SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
                               float* innerGain, float* innerBias);
 
+bool factor_separable_kernel(const SkISize& kernelSize, const float* kernel,
+                             TArray<float>* column, TArray<float>* row);
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -78,6 +86,7 @@ public:
 
         // Does nothing for small kernels, otherwise encodes kernel into an A8 image.
         fKernelBitmap = create_kernel_bitmap(kernelSize, kernel, &fInnerGain, &fInnerBias);
+        fSeparable = factor_separable_kernel(kernelSize, kernel, &fKernelColumn, &fKernelRow);
     }
 
     SkRect computeFastBounds(const SkRect& bounds) const override;
@@ -116,6 +125,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     // Helper functions to adjust 'bounds' by the kernel size and offset, either for what would be
     // sampled when covering 'bounds', or what could produce values when applied to 'bounds'.
     skif::LayerSpace<SkIRect> boundsSampledByKernel(const skif::LayerSpace<SkIRect>& bounds) const;
@@ -123,6 +136,13 @@ private:
 
     sk_sp<SkShader> createShader(const skif::Context& ctx, sk_sp<SkShader> input) const;
 
+    // Convolves a raster child output directly, rather than evaluating the shader. Returns
+    // nullopt when the child output isn't a raster N32 image.
+    std::optional<skif::FilterResult> filterRaster(
+            const skif::Context& ctx,
+            const skif::FilterResult& childOutput,
+            const skif::LayerSpace<SkIRect>& outputBounds) const;
+
     // Original kernel data, preserved for serialization even if it was encoded into fKernelBitmap
     TArray<float> fKernel;
 
@@ -141,6 +161,12 @@ private:
     SkBitmap fKernelBitmap;
     float fInnerBias;
     float fInnerGain;
+
+    // When fKernel is the outer product of fKernelColumn and fKernelRow, the raster backend
+    // convolves with the two of them in turn. Also derived, so not serialized.
+    bool fSeparable;
+    TArray<float> fKernelColumn;
+    TArray<float> fKernelRow;
 };
 
 // LayerSpace doesn't have a clean type to represent 4 separate edge deltas, but the result
@@ -152,6 +178,164 @@ skif::LayerSpace<SkIRect> adjust(const skif::LayerSpace<SkIRect>& rect,
     return skif::LayerSpace<SkIRect>(adjusted);
 }
 
+// A kernel is separable when its second singular value is zero, i.e. it has rank 1. Rather than
+// computing the SVD, the row and column through its largest coefficient give the only possible
+// factors, which are then checked against every coefficient.
+bool factor_separable_kernel(const SkISize& kernelSize, const float* kernel,
+                             TArray<float>* column, TArray<float>* row) {
+    const int w = kernelSize.width();
+    const int h = kernelSize.height();
+    int pivot = 0;
+    for (int i = 1; i < w * h; ++i) {
+        if (std::abs(kernel[i]) > std::abs(kernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const float maxCoeff = std::abs(kernel[pivot]);
+    if (w == 1 || h == 1 || maxCoeff == 0.f || !SkIsFinite(maxCoeff)) {
+        // A single row or column gains nothing from a second pass.
+        return false;
+    }
+
+    const int pivotX = pivot % w;
+    const int pivotY = pivot / w;
+    row->reset(w);
+    column->reset(h);
+    for (int x = 0; x < w; ++x) {
+        (*row)[x] = kernel[pivotY * w + x];
+    }
+    for (int y = 0; y < h; ++y) {
+        (*column)[y] = kernel[y * w + pivotX] / kernel[pivot];
+    }
+
+    const float tolerance = 1e-5f * maxCoeff;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (std::abs(kernel[y * w + x] - (*column)[y] * (*row)[x]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Loads row 'y' of 'src' from 'left' to 'left + count' as unit floats, where 'src' holds premul
+// N32 pixels and is transparent outside of its bounds. RGB is unpremultiplied when 'unpremul'.
+void load_row(const SkPixmap& src, int left, int y, int count, bool unpremul,
+              skvx::float4* dst) {
+    if (y < 0 || y >= src.height()) {
+        std::fill_n(dst, count, skvx::float4(0.f));
+        return;
+    }
+    const uint32_t* row = src.addr32(0, y);
+    for (int i = 0; i < count; ++i) {
+        const int x = left + i;
+        if (x < 0 || x >= src.width()) {
+            dst[i] = 0.f;
+            continue;
+        }
+        // Alpha is the last byte of both RGBA and BGRA, and the other channels are treated alike.
+        skvx::float4 c = skvx::cast<float>(skvx::byte4::Load(row + x)) * (1 / 255.f);
+        if (unpremul) {
+            const float a = c[3];
+            c = a > 0 ? skvx::float4(c[0] / a, c[1] / a, c[2] / a, a) : skvx::float4(0.f);
+        }
+        dst[i] = c;
+    }
+}
+
+// Loads rows of the input into a ring of 'kernelHeight' rows, so each row is loaded (and, for a
+// separable kernel, convolved horizontally) once however many output rows it contributes to.
+// Each output row then accumulates the rows of the ring with the kernel's coefficients.
+//
+// 'src' is the input with its top-left at 'srcOffset' relative to 'dst', which covers the output.
+void convolve_raster(const SkPixmap& src, SkIPoint srcOffset, const SkPixmap& dst,
+                     const SkISize& kernelSize, const float* kernel,
+                     const float* column, const float* row, SkIPoint kernelOffset,
+                     float gain, float bias, bool convolveAlpha) {
+    using float4 = skvx::float4;
+
+    const int kw = kernelSize.width();
+    const int kh = kernelSize.height();
+    const int dstW = dst.width();
+    const int srcW = dstW + kw - 1;
+    const bool separable = row && column;
+    // The input row and column sampled by the kernel's top-left coefficient for dst (0,0).
+    const int left = -kernelOffset.fX - srcOffset.fX;
+    const int top = -kernelOffset.fY - srcOffset.fY;
+
+    // Rows in the ring are srcW wide, or dstW once convolved horizontally.
+    const int ringW = separable ? dstW : srcW;
+    AutoTArray<float4> ring(SkToSizeT(kh) * ringW);
+    AutoTArray<float4> scratch(separable ? srcW : 0);
+    AutoTArray<float4> acc(dstW);
+
+    auto loadRingRow = [&](int n) {
+        float4* ringRow = ring.get() + SkToSizeT(n % kh) * ringW;
+        if (!separable) {
+            load_row(src, left, top + n, srcW, !convolveAlpha, ringRow);
+            return;
+        }
+        load_row(src, left, top + n, srcW, !convolveAlpha, scratch.get());
+        for (int x = 0; x < dstW; ++x) {
+            float4 sum = 0.f;
+            for (int j = 0; j < kw; ++j) {
+                sum += row[j] * scratch[x + j];
+            }
+            ringRow[x] = sum;
+        }
+    };
+
+    for (int n = 0; n < kh - 1; ++n) {
+        loadRingRow(n);
+    }
+    for (int y = 0; y < dst.height(); ++y) {
+        loadRingRow(y + kh - 1);
+
+        std::fill_n(acc.get(), dstW, float4(0.f));
+        for (int i = 0; i < kh; ++i) {
+            const float4* ringRow = ring.get() + SkToSizeT((y + i) % kh) * ringW;
+            if (separable) {
+                const float k = column[i];
+                for (int x = 0; x < dstW; ++x) {
+                    acc[x] += k * ringRow[x];
+                }
+                continue;
+            }
+            for (int j = 0; j < kw; ++j) {
+                const float k = kernel[i * kw + j];
+                if (k == 0.f) {
+                    continue;
+                }
+                const float4* shifted = ringRow + j;
+                for (int x = 0; x < dstW; ++x) {
+                    acc[x] += k * shifted[x];
+                }
+            }
+        }
+
+        // Matches the footer of the matrix convolution shader.
+        const int srcY = y - srcOffset.fY;
+        uint32_t* dstRow = dst.writable_addr32(0, y);
+        for (int x = 0; x < dstW; ++x) {
+            float4 color = acc[x] * gain + bias;
+            if (!convolveAlpha) {
+                const int srcX = x - srcOffset.fX;
+                const float origAlpha =
+                        (srcX >= 0 && srcX < src.width() && srcY >= 0 && srcY < src.height())
+                                ? (*src.addr32(srcX, srcY) >> 24) * (1 / 255.f)
+                                : 0.f;
+                color = color * origAlpha;
+                color[3] = origAlpha;
+            } else {
+                color[3] = std::clamp(color[3], 0.f, 1.f);
+            }
+            color = skvx::pin(color, float4(0.f), float4(color[3]));
+            skvx::cast<uint8_t>(skvx::lrint(color * 255.f)).store(dstRow + x);
+        }
+    }
+}
+
 std::pair<int, SkKnownRuntimeEffects::StableKey> quantize_by_kernel_size(int kernelSize) {
     if (kernelSize < kMaxUniformKernelSize) {
         return { kMaxUniformKernelSize, SkKnownRuntimeEffects::StableKey::kMatrixConvUniforms };
@@ -388,6 +572,32 @@ sk_sp<SkShader> SkMatrixConvolutionImageFilter::createShader(const skif::Context
     return builder.makeShader();
 }
 
+std::optional<skif::FilterResult> SkMatrixConvolutionImageFilter::filterRaster(
+        const skif::Context& ctx,
+        const skif::FilterResult& childOutput,
+        const skif::LayerSpace<SkIRect>& outputBounds) const {
+    auto src = childOutput.asN32Bitmap(
+            ctx.withNewDesiredOutput(this->boundsSampledByKernel(outputBounds)));
+    if (!src) {
+        return std::nullopt;
+    }
+    const SkBitmap& srcBitmap = src->first;
+    const skif::LayerSpace<SkIPoint>& srcOrigin = src->second;
+
+    const SkIPoint srcOffset = srcBitmap.isNull()
+            ? SkIPoint{0, 0} : SkIPoint(srcOrigin) - SkIPoint(outputBounds.topLeft());
+    return skif::FilterResult::MakeFromRaster(
+            ctx, srcBitmap.isNull() ? kN32_SkColorType : srcBitmap.colorType(), outputBounds,
+            [&](const SkPixmap& dst) {
+                convolve_raster(srcBitmap.pixmap(), srcOffset, dst,
+                                SkISize(fKernelSize), fKernel.data(),
+                                fSeparable ? fKernelColumn.data() : nullptr,
+                                fSeparable ? fKernelRow.data() : nullptr,
+                                SkIPoint::Make(fKernelOffset.x(), fKernelOffset.y()),
+                                fGain, fBias / 255.f, fConvolveAlpha);
+            });
+}
+
 skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         const skif::Context& context) const {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
@@ -409,6 +619,11 @@ skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         }
     }
 
+    if (std::optional<skif::FilterResult> result =
+                this->filterRaster(context, childOutput, outputBounds)) {
+        return *result;
+    }
+
     skif::FilterResult::Builder builder{context};
     builder.add(childOutput,
                 this->boundsSampledByKernel(outputBounds),
@@ -449,6 +664,17 @@ std::optional<skif::LayerSpace<SkIRect>> SkMatrixConvolutionImageFilter::onGetOu
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkMatrixConvolutionImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Unlike the output bounds, the bias doesn't matter since it is the same before and after.
+    auto childDamage = this->getChildDamagedLayerBounds(0, mapping, damage);
+    if (!childDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    return this->boundsAffectedByKernel(*childDamage);
+}
+
 SkRect SkMatrixConvolutionImageFilter::computeFastBounds(const SkRect& bounds) const {
     // See onAffectsTransparentBlack(), but without knowing the local-to-device transform, we don't
     // know how many pixels will be sampled by the kernel. Return unbounded to match the
@@ -65,6 +65,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     skif::LayerSpace<SkIRect> requiredInput(const skif::Mapping& mapping,
                                             const skif::LayerSpace<SkIRect>& desiredOutput) const;
 
@@ -193,3 +197,16 @@ std::optional<skif::LayerSpace<SkIRect>> SkMatrixTransformImageFilter::onGetOutp
         return skif::LayerSpace<SkIRect>::Unbounded();
     }
 }
+
+std::optional<skif::LayerSpace<SkIRect>> SkMatrixTransformImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    auto childDamage = this->getChildDamagedLayerBounds(0, mapping, damage);
+    if (!childDamage) {
+        return skif::LayerSpace<SkIRect>::Unbounded();
+    }
+    // Filtered sampling can blend the damaged pixels into their transformed neighbors.
+    skif::LayerSpace<SkIRect> transformed = mapping.paramToLayer(fTransform).mapRect(*childDamage);
+    transformed.outset(skif::LayerSpace<SkISize>({1, 1}));
+    return transformed;
+}
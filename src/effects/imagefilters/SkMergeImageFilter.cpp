@@ -11,7 +11,9 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTemplates.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -48,6 +50,10 @@ private:
     std::optional<skif::LayerSpace<SkIRect>> onGetOutputLayerBounds(
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
+
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
 };
 
 } // end namespace
@@ -83,9 +89,11 @@ sk_sp<SkFlattenable> SkMergeImageFilter::CreateProc(SkReadBuffer& buffer) {
 
 skif::FilterResult SkMergeImageFilter::onFilterImage(const skif::Context& ctx) const {
     const int inputCount = this->countInputs();
+    skia_private::AutoSTArray<4, skif::FilterResult> childOutputs(inputCount);
+    this->getChildOutputs(ctx, SkSpan(childOutputs.data(), inputCount));
     skif::FilterResult::Builder builder{ctx};
     for (int i = 0; i < inputCount; ++i) {
-        builder.add(this->getChildOutput(i, ctx));
+        builder.add(childOutputs[i]);
     }
     return builder.merge();
 }
@@ -128,6 +136,22 @@ std::optional<skif::LayerSpace<SkIRect>> SkMergeImageFilter::onGetOutputLayerBou
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkMergeImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Each output pixel is src-over of the children's pixels, so only the union of their damage
+    // changes.
+    skif::LayerSpace<SkIRect> outputDamage = skif::LayerSpace<SkIRect>::Empty();
+    for (int i = 0; i < this->countInputs(); ++i) {
+        auto childDamage = this->getChildDamagedLayerBounds(i, mapping, damage);
+        if (!childDamage) {
+            return skif::LayerSpace<SkIRect>::Unbounded();
+        }
+        outputDamage.join(*childDamage);
+    }
+    return outputDamage;
+}
+
 SkRect SkMergeImageFilter::computeFastBounds(const SkRect& rect) const {
     // The base computeFastBounds() implementation is the union of all fast bounds from children,
     // or 'rect' if there are none. For merge, zero children means zero output so only call the
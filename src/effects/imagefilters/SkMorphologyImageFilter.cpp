@@ -7,9 +7,14 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
@@ -18,14 +23,18 @@
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -67,6 +76,10 @@ private:
             const skif::Mapping& mapping,
             std::optional<skif::LayerSpace<SkIRect>> contentBounds) const override;
 
+    std::optional<skif::LayerSpace<SkIRect>> onGetDamagedLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& damage) const override;
+
     skif::LayerSpace<SkISize> radii(const skif::Mapping& mapping) const {
         skif::LayerSpace<SkISize> radii = mapping.paramToLayer(fRadii).round();
         SkASSERT(radii.width() >= 0 && radii.height() >= 0);
@@ -168,10 +181,150 @@ sk_sp<SkShader> make_sparse_morphology(sk_sp<SkShader> input,
     return builder.makeShader();
 }
 
+// The raster backend computes each pass directly with the van Herk/Gil-Werman algorithm. The
+// samples along the axis are split into blocks as long as the window of 2*radius+1 samples, so any
+// window spans the end of one block and the start of the next. Running extrema from the start of
+// each block (g) and from its end (h) then give any window's extremum with one more operation, for
+// three per pixel whatever the radius. Each operation covers the 4 channels of a pixel at once, and
+// the Y pass applies them to the rows of a strip of columns.
+template <MorphType kType, int N>
+SK_ALWAYS_INLINE skvx::Vec<N, uint8_t> extremum(const skvx::Vec<N, uint8_t>& a,
+                                                const skvx::Vec<N, uint8_t>& b) {
+    return kType == MorphType::kDilate ? max(a, b) : min(a, b);
+}
+
+template <MorphType kType>
+SK_ALWAYS_INLINE uint32_t extremum(uint32_t a, uint32_t b) {
+    uint32_t result;
+    extremum<kType>(skvx::byte4::Load(&a), skvx::byte4::Load(&b)).store(&result);
+    return result;
+}
+
+// dst[i] = extremum(a[i], b[i]) for 'count' pixels.
+template <MorphType kType>
+void extremum_span(uint32_t* dst, const uint32_t* a, const uint32_t* b, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        extremum<kType>(skvx::Vec<16, uint8_t>::Load(a + i),
+                        skvx::Vec<16, uint8_t>::Load(b + i)).store(dst + i);
+    }
+    for (; i < count; ++i) {
+        dst[i] = extremum<kType>(a[i], b[i]);
+    }
+}
+
+// Copies 'count' pixels of row 'y' of 'src', starting at column 'left', into 'dst'. Pixels outside
+// of 'src' are transparent black.
+void load_row(const SkPixmap& src, int left, int y, int count, uint32_t* dst) {
+    if (y < 0 || y >= src.height() || left >= src.width() || left + count <= 0) {
+        std::fill_n(dst, count, 0);
+        return;
+    }
+    const int start = std::max(left, 0);
+    const int end = std::min(left + count, src.width());
+    std::fill_n(dst, start - left, 0);
+    memcpy(dst + (start - left), src.addr32(start, y), (end - start) * sizeof(uint32_t));
+    std::fill_n(dst + (end - left), left + count - end, 0);
+}
+
+// 'src' is the input with its top-left at 'srcOffset' relative to 'dst', which covers the output.
+template <MorphType kType>
+void morph_x(const SkPixmap& src, SkIPoint srcOffset, const SkPixmap& dst, int radius) {
+    const int window = 2 * radius + 1;
+    const int width = dst.width();
+    const int n = width + 2 * radius;
+    // h starts out holding the samples themselves.
+    skia_private::AutoTMalloc<uint32_t> g(n), h(n);
+    for (int y = 0; y < dst.height(); ++y) {
+        load_row(src, -radius - srcOffset.fX, y - srcOffset.fY, n, h.get());
+        for (int k = 0; k < n; ++k) {
+            g[k] = k % window == 0 ? h[k] : extremum<kType>(g[k - 1], h[k]);
+        }
+        for (int k = n - 2; k >= 0; --k) {
+            if (k % window != window - 1) {
+                h[k] = extremum<kType>(h[k + 1], h[k]);
+            }
+        }
+        uint32_t* dstRow = dst.writable_addr32(0, y);
+        for (int x = 0; x < width; ++x) {
+            dstRow[x] = extremum<kType>(h[x], g[x + window - 1]);
+        }
+    }
+}
+
+// The Y pass works on strips of this many columns, so its scratch rows stay in cache and its
+// memory is bounded by the output's height rather than its area.
+static constexpr int kMorphYStripWidth = 64;
+
+template <MorphType kType>
+void morph_y(const SkPixmap& src, SkIPoint srcOffset, const SkPixmap& dst, int radius) {
+    const int window = 2 * radius + 1;
+    const int n = dst.height() + 2 * radius;
+    const int stripWidth = std::min(dst.width(), kMorphYStripWidth);
+    // The same as morph_x, with each sample a row of the strip.
+    skia_private::AutoTMalloc<uint32_t> g(SkToSizeT(n) * stripWidth),
+                                        h(SkToSizeT(n) * stripWidth);
+    auto gRow = [&](int k) { return g.get() + SkToSizeT(k) * stripWidth; };
+    auto hRow = [&](int k) { return h.get() + SkToSizeT(k) * stripWidth; };
+    for (int x = 0; x < dst.width(); x += stripWidth) {
+        const int width = std::min(stripWidth, dst.width() - x);
+        for (int k = 0; k < n; ++k) {
+            load_row(src, x - srcOffset.fX, k - radius - srcOffset.fY, width, hRow(k));
+            if (k % window == 0) {
+                memcpy(gRow(k), hRow(k), width * sizeof(uint32_t));
+            } else {
+                extremum_span<kType>(gRow(k), gRow(k - 1), hRow(k), width);
+            }
+        }
+        for (int k = n - 2; k >= 0; --k) {
+            if (k % window != window - 1) {
+                extremum_span<kType>(hRow(k), hRow(k + 1), hRow(k), width);
+            }
+        }
+        for (int y = 0; y < dst.height(); ++y) {
+            extremum_span<kType>(dst.writable_addr32(x, y), hRow(y), gRow(y + window - 1), width);
+        }
+    }
+}
+
+std::optional<skif::FilterResult> morphology_pass_raster(const skif::Context& ctx,
+                                                         const skif::FilterResult& input,
+                                                         MorphType type, MorphDirection dir,
+                                                         int radius) {
+    skif::LayerSpace<SkIRect> sampleBounds = ctx.desiredOutput();
+    sampleBounds.outset(skif::LayerSpace<SkISize>({dir == MorphDirection::kX ? radius : 0,
+                                                   dir == MorphDirection::kY ? radius : 0}));
+    auto src = input.asN32Bitmap(ctx.withNewDesiredOutput(sampleBounds));
+    if (!src) {
+        return std::nullopt;
+    }
+    const SkBitmap& srcBitmap = src->first;
+    const skif::LayerSpace<SkIPoint>& srcOrigin = src->second;
+    if (srcBitmap.isNull()) {
+        return skif::FilterResult{};
+    }
+
+    const SkIPoint srcOffset = SkIPoint(srcOrigin) - SkIPoint(ctx.desiredOutput().topLeft());
+    auto morph = dir == MorphDirection::kX
+            ? (type == MorphType::kDilate ? morph_x<MorphType::kDilate> : morph_x<MorphType::kErode>)
+            : (type == MorphType::kDilate ? morph_y<MorphType::kDilate> : morph_y<MorphType::kErode>);
+    return skif::FilterResult::MakeFromRaster(
+            ctx, srcBitmap.colorType(), ctx.desiredOutput(), [&](const SkPixmap& dst) {
+                morph(srcBitmap.pixmap(), srcOffset, dst, radius);
+            });
+}
+
 skif::FilterResult morphology_pass(const skif::Context& ctx, const skif::FilterResult& input,
                                    MorphType type, MorphDirection dir, int radius) {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
 
+    if (radius > 0) {
+        if (std::optional<skif::FilterResult> result =
+                    morphology_pass_raster(ctx, input, type, dir, radius)) {
+            return *result;
+        }
+    }
+
     auto axisDelta = [dir](int step) {
         return skif::LayerSpace<SkISize>({
                 dir == MorphDirection::kX ? step : 0,
@@ -312,6 +465,18 @@ std::optional<skif::LayerSpace<SkIRect>> SkMorphologyImageFilter::onGetOutputLay
     }
 }
 
+std::optional<skif::LayerSpace<SkIRect>> SkMorphologyImageFilter::onGetDamagedLayerBounds(
+        const skif::Mapping& mapping,
+        const skif::LayerSpace<SkIRect>& damage) const {
+    // Both dilation and erosion read every pixel within the radii, so the damage grows by them
+    // either way.
+    auto childDamage = this->getChildDamagedLayerBounds(0, mapping, damage);
+    if (childDamage) {
+        childDamage->outset(this->radii(mapping));
+    }
+    return childDamage;
+}
+
 SkRect SkMorphologyImageFilter::computeFastBounds(const SkRect& src) const {
     // See kernelOutputBounds() for rationale
     SkRect bounds = this->getInput(0) ? this->getInput(0)->computeFastBounds(src) : src;
@@ -20,6 +20,7 @@
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTemplates.h"
 #include "src/base/SkSpinlock.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -240,12 +241,14 @@ skif::FilterResult SkRuntimeImageFilter::onFilterImage(const skif::Context& ctx)
 
     skif::Context inputCtx = ctx.withNewDesiredOutput(
             this->applyMaxSampleRadius(ctx.mapping(), ctx.desiredOutput()));
+    skia_private::AutoSTArray<4, skif::FilterResult> childOutputs(inputCount);
+    this->getChildOutputs(inputCtx, SkSpan(childOutputs.data(), inputCount));
     skif::FilterResult::Builder builder{ctx};
     for (int i = 0; i < inputCount; ++i) {
         // Record the input context's desired output as the sample bounds for the child shaders
         // since the runtime shader can go up to max sample radius away from its desired output
         // (which is the default sample bounds if we didn't override it here).
-        builder.add(this->getChildOutput(i, inputCtx),
+        builder.add(childOutputs[i],
                     inputCtx.desiredOutput(),
                     ShaderFlags::kNonTrivialSampling);
     }
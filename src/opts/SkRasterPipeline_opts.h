@@ -3723,6 +3723,22 @@ SI F compute_perlin_vector(U32 sample, F x, F y) {
 }
 
 STAGE(perlin_noise, SkRasterPipeline_PerlinNoiseCtx* ctx) {
+    if (ctx->cache) {
+        // These points were already evaluated when the cache was filled, so the result is the same.
+        F x = r - F_(ctx->cacheLeft),
+          y = g - F_(ctx->cacheTop);
+        I32 inside = cond_to_mask(x >= 0) & cond_to_mask(x < F_(ctx->cacheWidth)) &
+                     cond_to_mask(y >= 0) & cond_to_mask(y < F_(ctx->cacheHeight));
+        if (all(inside)) {
+            U32 ix = 4 * (trunc_(y) * ctx->cacheWidth + trunc_(x));
+            r = gather(ctx->cache, ix + 0);
+            g = gather(ctx->cache, ix + 1);
+            b = gather(ctx->cache, ix + 2);
+            a = gather(ctx->cache, ix + 3);
+            return;
+        }
+    }
+
     F noiseVecX = (r + 0.5) * ctx->baseFrequencyX;
     F noiseVecY = (g + 0.5) * ctx->baseFrequencyY;
     r = g = b = a = F0;
@@ -4963,6 +4979,14 @@ STAGE(gauss_a_to_rgba, NoCtx) {
     b = a;
 }
 
+// Turns a sampled multi-channel distance field into coverage. Each channel is a distance encoded
+// around 0.5; their median is the distance to the outline, with corners kept sharp.
+STAGE(msdf_coverage, const SkRasterPipeline_MSDFCtx* ctx) {
+    F median = max(min(r, g), min(max(r, g), b));
+    a = clamp_01_((median - 0.5f) * ctx->distanceScale + 0.5f);
+    r = g = b = a;
+}
+
 // A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
 STAGE(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     // (cx,cy) are the center of our sample.
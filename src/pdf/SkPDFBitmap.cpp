@@ -31,11 +31,13 @@
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUnion.h"
+#include "src/pdf/SkPDFUtils.h"
 
 #include <algorithm>
 #include <array>
@@ -96,6 +98,17 @@ SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig) {
 
 enum class SkPDFStreamFormat { DCT, Flate, Uncompressed };
 
+std::unique_ptr<SkPDFDict> make_png_predictor_params(int colors, int columns) {
+    auto params = SkPDFMakeDict();
+    params->insertInt("Predictor", 15);
+    params->insertInt("Colors", colors);
+    params->insertInt("BitsPerComponent", 8);
+    params->insertInt("Columns", columns);
+    return params;
+}
+
+/** If predictorColors is non-zero, the Flate-compressed samples are preceded on each row by a
+    PNG filter type byte, and predictorColors is the number of samples per pixel. */
 template <typename T>
 void emit_image_stream(SkPDFDocument* doc,
                        SkPDFIndirectReference ref,
@@ -104,7 +117,9 @@ void emit_image_stream(SkPDFDocument* doc,
                        SkPDFUnion&& colorSpace,
                        SkPDFIndirectReference sMask,
                        int length,
-                       SkPDFStreamFormat format) {
+                       SkPDFStreamFormat format,
+                       int predictorColors = 0) {
+    SkASSERT(predictorColors == 0 || format == SkPDFStreamFormat::Flate);
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
     pdfDict.insertInt("Width", size.width());
@@ -123,12 +138,22 @@ void emit_image_stream(SkPDFDocument* doc,
         case SkPDFStreamFormat::Uncompressed: break;
     }
     pdfDict.insertObject("Filter", std::move(filters));
+    if (predictorColors) {
+        auto decodeParms = SkPDFMakeArray();
+        decodeParms->appendObject(SkPDFMakeDict());
+        decodeParms->appendObject(make_png_predictor_params(predictorColors, size.width()));
+        pdfDict.insertObject("DecodeParms", std::move(decodeParms));
+    }
     #else
     switch (format) {
         case SkPDFStreamFormat::DCT: pdfDict.insertName("Filter", "DCTDecode"); break;
         case SkPDFStreamFormat::Flate: pdfDict.insertName("Filter", "FlateDecode"); break;
         case SkPDFStreamFormat::Uncompressed: break;
     }
+    if (predictorColors) {
+        pdfDict.insertObject("DecodeParms",
+                             make_png_predictor_params(predictorColors, size.width()));
+    }
     #endif
     if (format == SkPDFStreamFormat::DCT) {
         pdfDict.insertInt("ColorTransform", 0);
@@ -137,6 +162,131 @@ void emit_image_stream(SkPDFDocument* doc,
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
 
+// PNG row filter types, see https://www.w3.org/TR/png/#9Filters
+enum PngFilter : uint8_t {
+    kNone_PngFilter    = 0,
+    kSub_PngFilter     = 1,
+    kUp_PngFilter      = 2,
+    kAverage_PngFilter = 3,
+    kPaeth_PngFilter   = 4,
+};
+static constexpr int kPngFilterCount = 5;
+
+// Applies every PNG filter to the N samples of `row` starting at index i. The samples before
+// row[0] and prev[0] must be readable and zero.
+template <int N>
+SK_ALWAYS_INLINE void png_filter_samples(const uint8_t* prev, const uint8_t* row, int bpp, int i,
+                                         uint8_t* const filtered[kPngFilterCount]) {
+    using U8 = skvx::Vec<N, uint8_t>;
+    using I16 = skvx::Vec<N, int16_t>;
+    U8 x = U8::Load(row + i),
+       a = U8::Load(row + i - bpp),    // left
+       b = U8::Load(prev + i),         // up
+       c = U8::Load(prev + i - bpp);   // up-left
+    (x - a).store(filtered[kSub_PngFilter] + i);
+    (x - b).store(filtered[kUp_PngFilter] + i);
+    // floor((a + b) / 2) without overflowing 8 bits.
+    (x - ((a & b) + ((a ^ b) >> 1))).store(filtered[kAverage_PngFilter] + i);
+
+    I16 wa = skvx::cast<int16_t>(a),
+        wb = skvx::cast<int16_t>(b),
+        wc = skvx::cast<int16_t>(c);
+    I16 pa = skvx::max(wb - wc, wc - wb),
+        pb = skvx::max(wa - wc, wc - wa),
+        pc = skvx::max(wa + wb - wc - wc, wc + wc - wa - wb);
+    I16 paeth = skvx::if_then_else((pa <= pb) & (pa <= pc), wa,
+                                   skvx::if_then_else(pb <= pc, wb, wc));
+    (x - skvx::cast<uint8_t>(paeth)).store(filtered[kPaeth_PngFilter] + i);
+}
+
+// Sum of the filtered samples interpreted as signed bytes, i.e. the "minimum sum of absolute
+// differences" heuristic recommended by the PNG specification for choosing a filter.
+uint32_t png_residual_cost(const uint8_t* samples, int count) {
+    using U8 = skvx::Vec<16, uint8_t>;
+    skvx::Vec<16, uint32_t> sums(0);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        U8 v = U8::Load(samples + i);
+        sums += skvx::cast<uint32_t>(skvx::min(v, U8(0) - v));
+    }
+    uint32_t cost = 0;
+    for (int lane = 0; lane < 16; ++lane) {
+        cost += sums[lane];
+    }
+    for (; i < count; ++i) {
+        cost += std::min<uint8_t>(samples[i], 256 - samples[i]);
+    }
+    return cost;
+}
+
+/** Writes rows of 8-bit samples to an image stream. If predict is true, each row is written
+    with the PNG filter that best predicts it, which is what /Predictor 15 expects. */
+class ImageRowWriter {
+public:
+    ImageRowWriter(SkWStream* stream, int width, int bytesPerPixel, bool predict)
+            : fStream(stream)
+            , fRowBytes(width * bytesPerPixel)
+            , fBytesPerPixel(bytesPerPixel)
+            , fPredict(predict) {
+        SkASSERT(bytesPerPixel <= kRowPad);
+        // Predicting needs the previous row plus scratch space for all but the None filter.
+        size_t rowCount = fPredict ? 2 + (kPngFilterCount - 1) : 1;
+        size_t stride = kRowPad + fRowBytes;
+        fStorage.reset(new uint8_t[rowCount * stride]());
+        fRow = fStorage.get() + kRowPad;
+        if (fPredict) {
+            fPrev = fRow + stride;
+            for (int f = kSub_PngFilter; f < kPngFilterCount; ++f) {
+                fFiltered[f] = fStorage.get() + (f + 1) * stride + kRowPad;
+            }
+        }
+    }
+
+    /** Storage for the unfiltered samples of the next row. */
+    uint8_t* row() { return fRow; }
+
+    void writeRow() {
+        if (!fPredict) {
+            fStream->write(fRow, fRowBytes);
+            return;
+        }
+        int i = 0;
+        for (; i + 16 <= fRowBytes; i += 16) {
+            png_filter_samples<16>(fPrev, fRow, fBytesPerPixel, i, fFiltered);
+        }
+        for (; i < fRowBytes; ++i) {
+            png_filter_samples<1>(fPrev, fRow, fBytesPerPixel, i, fFiltered);
+        }
+        fFiltered[kNone_PngFilter] = fRow;
+
+        uint8_t best = kNone_PngFilter;
+        uint32_t bestCost = png_residual_cost(fRow, fRowBytes);
+        for (uint8_t f = kSub_PngFilter; f < kPngFilterCount && bestCost > 0; ++f) {
+            uint32_t cost = png_residual_cost(fFiltered[f], fRowBytes);
+            if (cost < bestCost) {
+                best = f;
+                bestCost = cost;
+            }
+        }
+        fStream->write(&best, 1);
+        fStream->write(fFiltered[best], fRowBytes);
+        std::swap(fRow, fPrev);
+    }
+
+private:
+    // Zeroed bytes before each row, so the left neighbors of the first pixel read as zero.
+    static constexpr int kRowPad = 16;
+
+    SkWStream* fStream;
+    int fRowBytes;
+    int fBytesPerPixel;
+    bool fPredict;
+    std::unique_ptr<uint8_t[]> fStorage;
+    uint8_t* fRow = nullptr;
+    uint8_t* fPrev = nullptr;
+    uint8_t* fFiltered[kPngFilterCount] = {};
+};
+
 void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
     SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
     SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
@@ -149,27 +299,26 @@ void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectRefe
         deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
         stream = &*deflateWStream;
     }
+    bool predict = format == SkPDFStreamFormat::Flate;
+    ImageRowWriter writer(stream, pm.width(), 1, predict);
     if (kAlpha_8_SkColorType == pm.colorType()) {
         SkASSERT(pm.rowBytes() == (size_t)pm.width());
-        stream->write(pm.addr8(), pm.width() * pm.height());
+        for (int y = 0; y < pm.height(); ++y) {
+            memcpy(writer.row(), pm.addr8(0, y), pm.width());
+            writer.writeRow();
+        }
     } else {
         SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
         SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
         SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
-        const uint32_t* ptr = pm.addr32();
-        const uint32_t* stop = ptr + pm.height() * pm.width();
-
-        uint8_t byteBuffer[4092];
-        uint8_t* bufferStop = byteBuffer + std::size(byteBuffer);
-        uint8_t* dst = byteBuffer;
-        while (ptr != stop) {
-            *dst++ = 0xFF & ((*ptr++) >> SK_BGRA_A32_SHIFT);
-            if (dst == bufferStop) {
-                stream->write(byteBuffer, sizeof(byteBuffer));
-                dst = byteBuffer;
+        for (int y = 0; y < pm.height(); ++y) {
+            const uint32_t* src = pm.addr32(0, y);
+            uint8_t* dst = writer.row();
+            for (int x = 0; x < pm.width(); ++x) {
+                *dst++ = 0xFF & (src[x] >> SK_BGRA_A32_SHIFT);
             }
+            writer.writeRow();
         }
-        stream->write(byteBuffer, dst - byteBuffer);
     }
     if (deflateWStream) {
         deflateWStream->finalize();
@@ -181,7 +330,7 @@ void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectRefe
     int length = SkToInt(buffer.bytesWritten());
     emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
                       pm.info().dimensions(), SkPDFUnion::Name("DeviceGray"),
-                      SkPDFIndirectReference(), length, format);
+                      SkPDFIndirectReference(), length, format, predict ? 1 : 0);
 }
 
 SkPDFUnion write_icc_profile(SkPDFDocument* doc, sk_sp<SkData>&& icc, int channels) {
@@ -228,29 +377,35 @@ void do_deflated_image(const SkPixmap& pm,
     }
     SkPDFUnion colorSpace = SkPDFUnion::Name("DeviceGray");
     int channels;
+    bool predict = false;
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
             channels = 1;
             fill_stream(stream, '\x00', pm.width() * pm.height());
             break;
-        case kGray_8_SkColorType:
+        case kGray_8_SkColorType: {
             channels = 1;
             SkASSERT(sMask.fValue = -1);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
-            stream->write(pm.addr8(), pm.width() * pm.height());
+            predict = format == SkPDFStreamFormat::Flate;
+            ImageRowWriter writer(stream, pm.width(), channels, predict);
+            for (int y = 0; y < pm.height(); ++y) {
+                memcpy(writer.row(), pm.addr8(0, y), pm.width());
+                writer.writeRow();
+            }
             break;
-        default:
+        }
+        default: {
             colorSpace = SkPDFUnion::Name("DeviceRGB");
             channels = 3;
             SkASSERT(pm.alphaType() == kUnpremul_SkAlphaType);
             SkASSERT(pm.colorType() == kBGRA_8888_SkColorType);
             SkASSERT(pm.rowBytes() == (size_t)pm.width() * 4);
-            uint8_t byteBuffer[3072];
-            static_assert(std::size(byteBuffer) % 3 == 0, "");
-            uint8_t* bufferStop = byteBuffer + std::size(byteBuffer);
-            uint8_t* dst = byteBuffer;
+            predict = format == SkPDFStreamFormat::Flate;
+            ImageRowWriter writer(stream, pm.width(), channels, predict);
             for (int y = 0; y < pm.height(); ++y) {
                 const SkColor* src = pm.addr32(0, y);
+                uint8_t* dst = writer.row();
                 for (int x = 0; x < pm.width(); ++x) {
                     SkColor color = *src++;
                     if (SkColorGetA(color) == SK_AlphaTRANSPARENT) {
@@ -259,13 +414,10 @@ void do_deflated_image(const SkPixmap& pm,
                     *dst++ = SkColorGetR(color);
                     *dst++ = SkColorGetG(color);
                     *dst++ = SkColorGetB(color);
-                    if (dst == bufferStop) {
-                        stream->write(byteBuffer, sizeof(byteBuffer));
-                        dst = byteBuffer;
-                    }
                 }
+                writer.writeRow();
             }
-            stream->write(byteBuffer, dst - byteBuffer);
+        }
     }
     if (deflateWStream) {
         deflateWStream->finalize();
@@ -283,7 +435,8 @@ void do_deflated_image(const SkPixmap& pm,
     #endif
     int length = SkToInt(buffer.bytesWritten());
     emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), std::move(colorSpace), sMask, length, format);
+                      pm.info().dimensions(), std::move(colorSpace), sMask, length, format,
+                      predict ? channels : 0);
     if (!isOpaque) {
         do_deflated_alpha(pm, doc, sMask);
     }
@@ -338,6 +491,92 @@ bool do_jpeg(sk_sp<SkData> data, SkColorSpace* imageColorSpace, SkPDFDocument* d
     return true;
 }
 
+uint32_t read_u32_be(const uint8_t* ptr) {
+    return (uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 | (uint32_t)ptr[2] << 8 | ptr[3];
+}
+
+/* PNG image data is a zlib stream of rows, each preceded by its filter type, which is exactly
+   what FlateDecode with /Predictor 15 reads. When the pixel format also maps directly onto a
+   PDF image (8-bit gray or RGB, not interlaced, no transparency or orientation) the IDAT
+   chunks can be copied into the PDF without decoding or recompressing them. */
+bool do_png(const SkData& data, SkColorSpace* imageColorSpace, SkPDFDocument* doc, SkISize size,
+            SkPDFIndirectReference ref) {
+    static constexpr uint8_t kPngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static constexpr size_t kChunkOverhead = 12;  // length, type, and CRC
+    const uint8_t* ptr = data.bytes();
+    const uint8_t* const end = ptr + data.size();
+    if (data.size() < sizeof(kPngSignature) ||
+        0 != memcmp(ptr, kPngSignature, sizeof(kPngSignature))) {
+        return false;
+    }
+    ptr += sizeof(kPngSignature);
+
+    int channels = 0;
+    bool sawEnd = false;
+    SkDynamicMemoryWStream idat;
+    while (!sawEnd) {
+        if ((size_t)(end - ptr) < kChunkOverhead) {
+            return false;
+        }
+        uint32_t length = read_u32_be(ptr);
+        const uint8_t* type = ptr + 4;
+        const uint8_t* chunk = ptr + 8;
+        if (length > (size_t)(end - ptr) - kChunkOverhead) {
+            return false;
+        }
+        ptr = chunk + length + 4;
+
+        if (0 == memcmp(type, "IHDR", 4)) {
+            if (length != 13 || channels != 0) {
+                return false;
+            }
+            uint8_t bitDepth = chunk[8],
+                    colorType = chunk[9],
+                    compression = chunk[10],
+                    filterMethod = chunk[11],
+                    interlace = chunk[12];
+            if (size != SkISize::Make(read_u32_be(chunk), read_u32_be(chunk + 4)) ||
+                bitDepth != 8 || compression != 0 || filterMethod != 0 || interlace != 0) {
+                return false;
+            }
+            switch (colorType) {
+                case 0: channels = 1; break;  // gray
+                case 2: channels = 3; break;  // RGB
+                default: return false;        // palette or alpha
+            }
+        } else if (channels == 0) {
+            return false;  // IHDR must come first.
+        } else if (0 == memcmp(type, "IDAT", 4)) {
+            idat.write(chunk, length);
+        } else if (0 == memcmp(type, "IEND", 4)) {
+            sawEnd = true;
+        } else if (0 == memcmp(type, "tRNS", 4) || 0 == memcmp(type, "eXIf", 4)) {
+            return false;  // Needs a soft mask or a transform.
+        }
+    }
+    if (idat.bytesWritten() == 0) {
+        return false;
+    }
+    #ifdef SK_PDF_BASE85_BINARY
+    SkPDFUtils::Base85Encode(idat.detachAsStream(), &idat);
+    #endif
+
+    SkPDFUnion colorSpace = channels == 3 ? SkPDFUnion::Name("DeviceRGB")
+                                          : SkPDFUnion::Name("DeviceGray");
+    if (imageColorSpace && channels != 1) {
+        skcms_ICCProfile imageIccProfile;
+        imageColorSpace->toProfile(&imageIccProfile);
+        sk_sp<SkData> imageIccData = SkWriteICCProfile(&imageIccProfile, "");
+        colorSpace = write_icc_profile(doc, std::move(imageIccData), channels);
+    }
+
+    int length = SkToInt(idat.bytesWritten());
+    emit_image_stream(doc, ref, [&idat](SkWStream* stream) { idat.writeToAndReset(stream); },
+                      size, std::move(colorSpace), SkPDFIndirectReference(), length,
+                      SkPDFStreamFormat::Flate, channels);
+    return true;
+}
+
 SkBitmap to_pixels(const SkImage* image) {
     SkBitmap bm;
     int w = image->width(),
@@ -363,6 +602,30 @@ SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
+/* Flate does well on screenshots, charts, and line art, which have few distinct colors, but
+   poorly on photographs, where JPEG is both much smaller and much faster. Sample a grid of
+   pixels and call the image photographic if most of the samples are distinct. */
+bool is_large_photograph(const SkPixmap& pm) {
+    static constexpr int64_t kMinPixels = 256 * 256;
+    static constexpr int kMaxSamplesPerAxis = 64;
+    if (pm.colorType() != kBGRA_8888_SkColorType ||
+        (int64_t)pm.width() * pm.height() < kMinPixels) {
+        return false;
+    }
+    int xStep = std::max(1, pm.width()  / kMaxSamplesPerAxis),
+        yStep = std::max(1, pm.height() / kMaxSamplesPerAxis);
+    int samples = 0;
+    skia_private::THashSet<uint32_t> colors;
+    for (int y = yStep / 2; y < pm.height(); y += yStep) {
+        const uint32_t* row = pm.addr32(0, y);
+        for (int x = xStep / 2; x < pm.width(); x += xStep) {
+            colors.add(row[x]);
+            ++samples;
+        }
+    }
+    return colors.count() * 2 > samples;
+}
+
 void serialize_image(const SkImage* img,
                      int encodingQuality,
                      SkPDFDocument* doc,
@@ -373,6 +636,11 @@ void serialize_image(const SkImage* img,
     SkISize dimensions = img->dimensions();
 
     if (sk_sp<SkData> data = img->refEncodedData()) {
+        if (encodingQuality > 100 && doc->metadata().fCompressionLevel !=
+                                             SkPDF::Metadata::CompressionLevel::None &&
+            do_png(*data, img->colorSpace(), doc, dimensions, ref)) {
+            return;
+        }
         if (do_jpeg(std::move(data), img->colorSpace(), doc, dimensions, ref)) {
             return;
         }
@@ -380,6 +648,11 @@ void serialize_image(const SkImage* img,
     SkBitmap bm = to_pixels(img);
     const SkPixmap& pm = bm.pixmap();
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
+    int photographicQuality = doc->metadata().fPhotographicEncodingQuality;
+    if (encodingQuality > 100 && photographicQuality <= 100 && isOpaque &&
+        is_large_photograph(pm)) {
+        encodingQuality = photographicQuality;
+    }
     if (encodingQuality <= 100 && isOpaque) {
         SkJpegEncoder::Options jOpts;
         jOpts.fQuality = encodingQuality;
@@ -26,6 +26,7 @@
 #include "include/core/SkPathEffect.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkPathUtils.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
@@ -43,6 +44,8 @@
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "include/utils/SkNoDrawCanvas.h"
+#include "include/utils/SkPaintFilterCanvas.h"
 #include "src/base/SkScopeExit.h"
 #include "src/base/SkTLazy.h"
 #include "src/base/SkUTF.h"
@@ -371,6 +374,138 @@ void SkPDFDevice::reset() {
     fActiveStackState = SkPDFGraphicStackState();
 }
 
+namespace {
+// A picture may be drawn once into a form XObject, and then referenced every time it is drawn,
+// only if it looks the same wherever it is drawn. The form is an isolated transparency group in
+// the picture's own coordinate space, so the picture must not blend with its backdrop, rasterize
+// anything at device resolution, or emit annotations, which belong to the page.
+class PictureShareabilityCanvas final : public SkPaintFilterCanvas {
+public:
+    explicit PictureShareabilityCanvas(SkCanvas* canvas) : SkPaintFilterCanvas(canvas) {}
+
+    bool isShareable() const { return fShareable; }
+
+protected:
+    bool onFilter(SkPaint& paint) const override {
+        this->check(paint);
+        return false;  // Nothing needs to actually be drawn.
+    }
+
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+        // Color filtered layers are rasterized, like image filtered ones.
+        if (rec.fBackdrop || (rec.fPaint && rec.fPaint->getColorFilter())) {
+            fShareable = false;
+        }
+        if (rec.fPaint) {
+            this->check(*rec.fPaint);
+        }
+        return this->SkPaintFilterCanvas::getSaveLayerStrategy(rec);
+    }
+
+    void onDrawPicture(const SkPicture* picture, const SkMatrix*, const SkPaint* paint) override {
+        if (paint) {
+            this->check(*paint);
+        }
+        if (fShareable) {
+            picture->playback(this);
+        }
+    }
+
+    void onDrawEdgeAAQuad(const SkRect&, const SkPoint[4], QuadAAFlags, const SkColor4f&,
+                          SkBlendMode mode) override {
+        if (mode != SkBlendMode::kSrcOver) {
+            fShareable = false;
+        }
+    }
+
+    void onDrawDrawable(SkDrawable*, const SkMatrix*) override { fShareable = false; }
+    void onDrawShadowRec(const SkPath&, const SkDrawShadowRec&) override { fShareable = false; }
+    void onDrawAnnotation(const SkRect&, const char[], SkData*) override { fShareable = false; }
+
+private:
+    void check(const SkPaint& paint) const {
+        if (!paint.isSrcOver() || paint.getImageFilter() || paint.getMaskFilter() ||
+            this->getTotalMatrix().hasPerspective()) {
+            fShareable = false;
+        }
+        // Only colors, gradients and images are written natively; any other shader, or a shader
+        // with a color filter, is rasterized at the resolution of the form.
+        if (const SkShader* shader = paint.getShader()) {
+            const SkShaderBase* base = as_SB(shader);
+            if (paint.getColorFilter() ||
+                (base->type() != SkShaderBase::ShaderType::kColor &&
+                 base->asGradient() == SkShaderBase::GradientType::kNone &&
+                 !shader->isAImage())) {
+                fShareable = false;
+            }
+        }
+    }
+
+    mutable bool fShareable = true;
+};
+
+bool is_shareable_picture(const SkPicture* picture) {
+    SkNoDrawCanvas noDraw(picture->cullRect().roundOut());
+    PictureShareabilityCanvas checker(&noDraw);
+    picture->playback(&checker);
+    return checker.isShareable();
+}
+}  // namespace
+
+void SkPDFDevice::drawPicture(SkCanvas* canvas, const SkPicture* picture) {
+    // Repeated pictures (stamps, headers, ...) are drawn once into a form XObject, which every
+    // draw then references with a single Do operator.
+    const SkRect& cull = picture->cullRect();
+    SkScalar rasterScale = fDocument->rasterScale();
+    static constexpr SkScalar kMaxFormSize = 16384;
+    if (fNodeId != 0 || this->localToDevice().hasPerspective() || cull.isEmpty() ||
+        !cull.isFinite() || std::max(cull.width(), cull.height()) * rasterScale > kMaxFormSize) {
+        this->SkClipStackDevice::drawPicture(canvas, picture);
+        return;
+    }
+
+    SkPDFIndirectReference* cached = fDocument->fPictureFormXObjects.find(picture->uniqueID());
+    SkPDFIndirectReference xObject;
+    if (cached) {
+        xObject = *cached;
+    } else {
+        if (is_shareable_picture(picture)) {
+            SkISize formSize = {SkScalarCeilToInt(cull.width() * rasterScale),
+                                SkScalarCeilToInt(cull.height() * rasterScale)};
+            auto formDevice = sk_make_sp<SkPDFDevice>(formSize, fDocument);
+            {
+                SkCanvas formCanvas(formDevice);
+                formCanvas.scale(rasterScale, rasterScale);
+                formCanvas.translate(-cull.left(), -cull.top());
+                picture->playback(&formCanvas);
+            }
+            if (!formDevice->isContentEmpty()) {
+                xObject = formDevice->makeFormXObjectFromDevice();
+            }
+        }
+        fDocument->fPictureFormXObjects.set(picture->uniqueID(), xObject);
+    }
+    if (!xObject) {
+        this->SkClipStackDevice::drawPicture(canvas, picture);
+        return;
+    }
+    if (this->hasEmptyClip()) {
+        return;
+    }
+
+    SkMatrix matrix = this->localToDevice();
+    matrix.preTranslate(cull.left(), cull.top());
+    matrix.preScale(1 / rasterScale, 1 / rasterScale);
+    ScopedContentEntry content(this, &this->cs(), matrix, SkPaint());
+    if (!content) {
+        return;
+    }
+    SkPath shape = SkPath::Rect(SkRect::MakeWH(cull.width() * rasterScale,
+                                               cull.height() * rasterScale));
+    shape.transform(matrix);
+    this->drawFormXObject(xObject, content.stream(), &shape);
+}
+
 void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* value) {
     if (!value || !fDocument->hasCurrentPage()) {
         return;
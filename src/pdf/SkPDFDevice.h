@@ -33,6 +33,7 @@ class SkMesh;
 class SkPDFDocument;
 class SkPaint;
 class SkPath;
+class SkPicture;
 class SkRRect;
 class SkSpecialImage;
 class SkSurface;
@@ -102,6 +103,7 @@ public:
     void drawMesh(const SkMesh&, sk_sp<SkBlender>, const SkPaint&) override;
 
     void drawAnnotation(const SkRect&, const char key[], SkData* value) override;
+    void drawPicture(SkCanvas*, const SkPicture*) override;
 
     void drawDevice(SkDevice*, const SkSamplingOptions&, const SkPaint&) override;
     void drawSpecial(SkSpecialImage*, const SkMatrix&, const SkSamplingOptions&,
@@ -697,6 +697,9 @@ sk_sp<SkDocument> SkPDF::MakeDocument(SkWStream* stream, const SkPDF::Metadata&
     if (meta.fEncodingQuality < 0) {
         meta.fEncodingQuality = 0;
     }
+    if (meta.fPhotographicEncodingQuality < 0) {
+        meta.fPhotographicEncodingQuality = 0;
+    }
     return stream ? sk_make_sp<SkPDFDocument>(stream, std::move(meta)) : nullptr;
 }
 
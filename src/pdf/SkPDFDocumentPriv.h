@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -157,6 +158,9 @@ public:
 
     const SkMatrix& currentPageTransform() const;
 
+    /** Device pixels per point; page devices are this much larger than the page. */
+    SkScalar rasterScale() const { return fRasterScale; }
+
     // Canonicalized objects
     skia_private::THashMap<SkPDFImageShaderKey,
                            SkPDFIndirectReference,
@@ -164,6 +168,20 @@ public:
     skia_private::THashMap<SkPDFGradientShader::Key,
                            SkPDFIndirectReference,
                            SkPDFGradientShader::KeyHash> fGradientPatternMap;
+    skia_private::THashMap<SkPDFGradientShader::Key,
+                           SkPDFIndirectReference,
+                           SkPDFGradientShader::KeyHash> fGradientShadingMap;
+    skia_private::THashMap<SkString, SkPDFIndirectReference> fPSFunctionMap;
+    // Images emitted for rasterized fallback shaders, keyed by a hash of their pixels. The image is
+    // kept so that a hash match can be confirmed by comparing the pixels.
+    struct FallbackShaderImage {
+        sk_sp<SkImage> fImage;
+        SkPDFIndirectReference fRef;
+    };
+    skia_private::THashMap<uint64_t, FallbackShaderImage> fFallbackShaderImages;
+    // Form XObjects of pictures, keyed by SkPicture::uniqueID(). An invalid reference means the
+    // picture can not be shared and is played back each time it is drawn.
+    skia_private::THashMap<uint32_t, SkPDFIndirectReference> fPictureFormXObjects;
     skia_private::THashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
     skia_private::THashMap<SkPDFIccProfileKey,
                            SkPDFIndirectReference,
@@ -691,6 +691,114 @@ static SkPDFIndirectReference make_ps_function(std::unique_ptr<SkStreamAsset> ps
     return SkPDFStreamOut(std::move(dict), std::move(psCode), doc);
 }
 
+enum class ShadingType : int32_t {
+    Function = 1,
+    Axial = 2,
+    Radial = 3,
+    FreeFormGouraudTriangleMesh = 4,
+    LatticeFormGouraudTriangleMesh = 5,
+    CoonsPatchMesh = 6,
+    TensorProductPatchMesh = 7,
+};
+
+// An axial or radial shading only depends on the gradient in its own coordinate space, so it
+// is emitted once and shared by every pattern that draws that gradient, whatever the pattern
+// matrix or bounds.
+static SkPDFIndirectReference make_stitched_shading(SkPDFDocument* doc,
+                                                    const SkPDFGradientShader::Key& state) {
+    const SkShaderBase::GradientInfo& info = state.fInfo;
+    ShadingType shadingType;
+    auto pdfShader = SkPDFMakeDict();
+    pdfShader->insertObject("Function", gradientStitchCode(info));
+
+    if (info.fTileMode == SkTileMode::kClamp) {
+        auto extend = SkPDFMakeArray();
+        extend->reserve(2);
+        extend->appendBool(true);
+        extend->appendBool(true);
+        pdfShader->insertObject("Extend", std::move(extend));
+    }
+
+    std::unique_ptr<SkPDFArray> coords;
+    switch (state.fType) {
+        case SkShaderBase::GradientType::kLinear: {
+            shadingType = ShadingType::Axial;
+            const SkPoint& pt1 = info.fPoint[0];
+            const SkPoint& pt2 = info.fPoint[1];
+            coords = SkPDFMakeArray(pt1.x(), pt1.y(),
+                                    pt2.x(), pt2.y());
+        } break;
+        case SkShaderBase::GradientType::kRadial: {
+            shadingType = ShadingType::Radial;
+            const SkPoint& pt1 = info.fPoint[0];
+            coords = SkPDFMakeArray(pt1.x(), pt1.y(), 0,
+                                    pt1.x(), pt1.y(), info.fRadius[0]);
+        } break;
+        case SkShaderBase::GradientType::kConical: {
+            shadingType = ShadingType::Radial;
+            SkScalar r1 = info.fRadius[0];
+            SkScalar r2 = info.fRadius[1];
+            SkPoint pt1 = info.fPoint[0];
+            SkPoint pt2 = info.fPoint[1];
+            FixUpRadius(pt1, r1, pt2, r2);
+
+            coords = SkPDFMakeArray(pt1.x(), pt1.y(), r1,
+                                    pt2.x(), pt2.y(), r2);
+            break;
+        }
+        case SkShaderBase::GradientType::kSweep:
+        case SkShaderBase::GradientType::kNone:
+        default:
+            SkASSERT(false);
+            return SkPDFIndirectReference();
+    }
+    pdfShader->insertObject("Coords", std::move(coords));
+    pdfShader->insertInt("ShadingType", SkToS32(shadingType));
+    pdfShader->insertName("ColorSpace", "DeviceRGB");
+    return doc->emit(*pdfShader);
+}
+
+static SkPDFGradientShader::Key clone_key(const SkPDFGradientShader::Key& k);
+
+static SkPDFIndirectReference find_stitched_shading(SkPDFDocument* doc,
+                                                    const SkPDFGradientShader::Key& state) {
+    SkPDFGradientShader::Key key = clone_key(state);
+    key.fCanvasTransform = SkMatrix::I();
+    key.fShaderTransform = SkMatrix::I();
+    key.fBBox = SkIRect::MakeEmpty();
+    key.fHash = hash(key);
+    if (SkPDFIndirectReference* ptr = doc->fGradientShadingMap.find(key)) {
+        return *ptr;
+    }
+    SkPDFIndirectReference shading = make_stitched_shading(doc, key);
+    doc->fGradientShadingMap.set(std::move(key), shading);
+    return shading;
+}
+
+// PostScript functions are written in pattern space, so identical gradients drawn under
+// transforms that only differ by the translation of their clip bounds share the same code and
+// domain. Key the function by its content so those patterns share it.
+static SkPDFIndirectReference find_ps_function(SkPDFDocument* doc,
+                                               std::unique_ptr<SkStreamAsset> psCode,
+                                               const SkRect& domain) {
+    SkString key;
+    key.resize(sizeof(SkRect) + psCode->getLength());
+    memcpy(key.data(), &domain, sizeof(SkRect));
+    psCode->read(key.data() + sizeof(SkRect), psCode->getLength());
+    psCode->rewind();
+    if (SkPDFIndirectReference* ptr = doc->fPSFunctionMap.find(key)) {
+        return *ptr;
+    }
+    SkPDFIndirectReference function =
+            make_ps_function(std::move(psCode),
+                             SkPDFMakeArray(domain.left(), domain.right(),
+                                            domain.top(), domain.bottom()),
+                             SkPDFMakeArray(0, 1, 0, 1, 0, 1),
+                             doc);
+    doc->fPSFunctionMap.set(std::move(key), function);
+    return function;
+}
+
 static SkPDFIndirectReference make_function_shader(SkPDFDocument* doc,
                                                    const SkPDFGradientShader::Key& state) {
     SkPoint transformPoints[2];
@@ -705,160 +813,106 @@ static SkPDFIndirectReference make_function_shader(SkPDFDocument* doc,
                               info.fTileMode == SkTileMode::kDecal) &&
                              !finalMatrix.hasPerspective();
 
-    enum class ShadingType : int32_t {
-        Function = 1,
-        Axial = 2,
-        Radial = 3,
-        FreeFormGouraudTriangleMesh = 4,
-        LatticeFormGouraudTriangleMesh = 5,
-        CoonsPatchMesh = 6,
-        TensorProductPatchMesh = 7,
-    } shadingType;
-
-    auto pdfShader = SkPDFMakeDict();
+    SkPDFDict pdfFunctionShader("Pattern");
+    pdfFunctionShader.insertInt("PatternType", 2);
     if (doStitchFunctions) {
-        pdfShader->insertObject("Function", gradientStitchCode(info));
-
-        if (info.fTileMode == SkTileMode::kClamp) {
-            auto extend = SkPDFMakeArray();
-            extend->reserve(2);
-            extend->appendBool(true);
-            extend->appendBool(true);
-            pdfShader->insertObject("Extend", std::move(extend));
-        }
-
-        std::unique_ptr<SkPDFArray> coords;
-        switch (state.fType) {
-            case SkShaderBase::GradientType::kLinear: {
-                shadingType = ShadingType::Axial;
-                const SkPoint& pt1 = info.fPoint[0];
-                const SkPoint& pt2 = info.fPoint[1];
-                coords = SkPDFMakeArray(pt1.x(), pt1.y(),
-                                        pt2.x(), pt2.y());
-            } break;
-            case SkShaderBase::GradientType::kRadial: {
-                shadingType = ShadingType::Radial;
-                const SkPoint& pt1 = info.fPoint[0];
-                coords = SkPDFMakeArray(pt1.x(), pt1.y(), 0,
-                                        pt1.x(), pt1.y(), info.fRadius[0]);
-            } break;
-            case SkShaderBase::GradientType::kConical: {
-                shadingType = ShadingType::Radial;
-                SkScalar r1 = info.fRadius[0];
-                SkScalar r2 = info.fRadius[1];
-                SkPoint pt1 = info.fPoint[0];
-                SkPoint pt2 = info.fPoint[1];
-                FixUpRadius(pt1, r1, pt2, r2);
-
-                coords = SkPDFMakeArray(pt1.x(), pt1.y(), r1,
-                                        pt2.x(), pt2.y(), r2);
-                break;
-            }
-            case SkShaderBase::GradientType::kSweep:
-            case SkShaderBase::GradientType::kNone:
-            default:
-                SkASSERT(false);
-                return SkPDFIndirectReference();
-        }
-        pdfShader->insertObject("Coords", std::move(coords));
-    } else {
-        shadingType = ShadingType::Function;
-
-        // Transform the coordinate space for the type of gradient.
-        transformPoints[0] = info.fPoint[0];
-        transformPoints[1] = info.fPoint[1];
-        switch (state.fType) {
-            case SkShaderBase::GradientType::kLinear:
-                break;
-            case SkShaderBase::GradientType::kRadial:
-                transformPoints[1] = transformPoints[0];
-                transformPoints[1].fX += info.fRadius[0];
-                break;
-            case SkShaderBase::GradientType::kConical: {
-                transformPoints[1] = transformPoints[0];
-                transformPoints[1].fX += SK_Scalar1;
-                break;
-            }
-            case SkShaderBase::GradientType::kSweep:
-                transformPoints[1] = transformPoints[0];
-                transformPoints[1].fX += SK_Scalar1;
-                break;
-            case SkShaderBase::GradientType::kNone:
-            default:
-                return SkPDFIndirectReference();
+        SkPDFIndirectReference shading = find_stitched_shading(doc, state);
+        if (!shading) {
+            return SkPDFIndirectReference();
         }
+        pdfFunctionShader.insertObject("Matrix", SkPDFUtils::MatrixToArray(finalMatrix));
+        pdfFunctionShader.insertRef("Shading", shading);
+        return doc->emit(pdfFunctionShader);
+    }
 
-        // Move any scaling (assuming a unit gradient) or translation
-        // (and rotation for linear gradient), of the final gradient from
-        // info.fPoints to the matrix (updating bbox appropriately).  Now
-        // the gradient can be drawn on on the unit segment.
-        SkMatrix mapperMatrix;
-        unit_to_points_matrix(transformPoints, &mapperMatrix);
-
-        finalMatrix.preConcat(mapperMatrix);
-
-        // Preserves as much as possible in the final matrix, and only removes
-        // the perspective. The inverse of the perspective is stored in
-        // perspectiveInverseOnly matrix and has 3 useful numbers
-        // (p0, p1, p2), while everything else is either 0 or 1.
-        // In this way the shader will handle it eficiently, with minimal code.
-        SkMatrix perspectiveInverseOnly = SkMatrix::I();
-        if (finalMatrix.hasPerspective()) {
-            if (!split_perspective(finalMatrix,
-                                   &finalMatrix, &perspectiveInverseOnly)) {
-                return SkPDFIndirectReference();
-            }
+    // Transform the coordinate space for the type of gradient.
+    transformPoints[0] = info.fPoint[0];
+    transformPoints[1] = info.fPoint[1];
+    switch (state.fType) {
+        case SkShaderBase::GradientType::kLinear:
+            break;
+        case SkShaderBase::GradientType::kRadial:
+            transformPoints[1] = transformPoints[0];
+            transformPoints[1].fX += info.fRadius[0];
+            break;
+        case SkShaderBase::GradientType::kConical: {
+            transformPoints[1] = transformPoints[0];
+            transformPoints[1].fX += SK_Scalar1;
+            break;
         }
+        case SkShaderBase::GradientType::kSweep:
+            transformPoints[1] = transformPoints[0];
+            transformPoints[1].fX += SK_Scalar1;
+            break;
+        case SkShaderBase::GradientType::kNone:
+        default:
+            return SkPDFIndirectReference();
+    }
 
-        SkRect bbox;
-        bbox.set(state.fBBox);
-        if (!SkPDFUtils::InverseTransformBBox(finalMatrix, &bbox)) {
+    // Move any scaling (assuming a unit gradient) or translation
+    // (and rotation for linear gradient), of the final gradient from
+    // info.fPoints to the matrix (updating bbox appropriately).  Now
+    // the gradient can be drawn on on the unit segment.
+    SkMatrix mapperMatrix;
+    unit_to_points_matrix(transformPoints, &mapperMatrix);
+
+    finalMatrix.preConcat(mapperMatrix);
+
+    // Preserves as much as possible in the final matrix, and only removes
+    // the perspective. The inverse of the perspective is stored in
+    // perspectiveInverseOnly matrix and has 3 useful numbers
+    // (p0, p1, p2), while everything else is either 0 or 1.
+    // In this way the shader will handle it eficiently, with minimal code.
+    SkMatrix perspectiveInverseOnly = SkMatrix::I();
+    if (finalMatrix.hasPerspective()) {
+        if (!split_perspective(finalMatrix,
+                               &finalMatrix, &perspectiveInverseOnly)) {
             return SkPDFIndirectReference();
         }
+    }
 
-        SkDynamicMemoryWStream functionCode;
-        switch (state.fType) {
-            case SkShaderBase::GradientType::kLinear:
-                linearCode(info, perspectiveInverseOnly, &functionCode);
-                break;
-            case SkShaderBase::GradientType::kRadial:
-                radialCode(info, perspectiveInverseOnly, &functionCode);
-                break;
-            case SkShaderBase::GradientType::kConical: {
-                // The two point radial gradient further references state.fInfo
-                // in translating from x, y coordinates to the t parameter. So, we have
-                // to transform the points and radii according to the calculated matrix.
-                SkShaderBase::GradientInfo infoCopy = info;
-                SkMatrix inverseMapperMatrix;
-                if (!mapperMatrix.invert(&inverseMapperMatrix)) {
-                    return SkPDFIndirectReference();
-                }
-                inverseMapperMatrix.mapPoints(infoCopy.fPoint, 2);
-                infoCopy.fRadius[0] = inverseMapperMatrix.mapRadius(info.fRadius[0]);
-                infoCopy.fRadius[1] = inverseMapperMatrix.mapRadius(info.fRadius[1]);
-                twoPointConicalCode(infoCopy, perspectiveInverseOnly, &functionCode);
-            } break;
-            case SkShaderBase::GradientType::kSweep:
-                sweepCode(info, perspectiveInverseOnly, &functionCode);
-                break;
-            default:
-                SkASSERT(false);
-        }
-        pdfShader->insertObject(
-                "Domain", SkPDFMakeArray(bbox.left(), bbox.right(), bbox.top(), bbox.bottom()));
-
-        auto domain = SkPDFMakeArray(bbox.left(), bbox.right(), bbox.top(), bbox.bottom());
-        std::unique_ptr<SkPDFArray> rangeObject = SkPDFMakeArray(0, 1, 0, 1, 0, 1);
-        pdfShader->insertRef("Function",
-                             make_ps_function(functionCode.detachAsStream(), std::move(domain),
-                                              std::move(rangeObject), doc));
+    SkRect bbox;
+    bbox.set(state.fBBox);
+    if (!SkPDFUtils::InverseTransformBBox(finalMatrix, &bbox)) {
+        return SkPDFIndirectReference();
     }
 
-    pdfShader->insertInt("ShadingType", SkToS32(shadingType));
+    SkDynamicMemoryWStream functionCode;
+    switch (state.fType) {
+        case SkShaderBase::GradientType::kLinear:
+            linearCode(info, perspectiveInverseOnly, &functionCode);
+            break;
+        case SkShaderBase::GradientType::kRadial:
+            radialCode(info, perspectiveInverseOnly, &functionCode);
+            break;
+        case SkShaderBase::GradientType::kConical: {
+            // The two point radial gradient further references state.fInfo
+            // in translating from x, y coordinates to the t parameter. So, we have
+            // to transform the points and radii according to the calculated matrix.
+            SkShaderBase::GradientInfo infoCopy = info;
+            SkMatrix inverseMapperMatrix;
+            if (!mapperMatrix.invert(&inverseMapperMatrix)) {
+                return SkPDFIndirectReference();
+            }
+            inverseMapperMatrix.mapPoints(infoCopy.fPoint, 2);
+            infoCopy.fRadius[0] = inverseMapperMatrix.mapRadius(info.fRadius[0]);
+            infoCopy.fRadius[1] = inverseMapperMatrix.mapRadius(info.fRadius[1]);
+            twoPointConicalCode(infoCopy, perspectiveInverseOnly, &functionCode);
+        } break;
+        case SkShaderBase::GradientType::kSweep:
+            sweepCode(info, perspectiveInverseOnly, &functionCode);
+            break;
+        default:
+            SkASSERT(false);
+    }
+    auto pdfShader = SkPDFMakeDict();
+    pdfShader->insertObject(
+            "Domain", SkPDFMakeArray(bbox.left(), bbox.right(), bbox.top(), bbox.bottom()));
+    pdfShader->insertRef("Function",
+                         find_ps_function(doc, functionCode.detachAsStream(), bbox));
+    pdfShader->insertInt("ShadingType", SkToS32(ShadingType::Function));
     pdfShader->insertName("ColorSpace", "DeviceRGB");
 
-    SkPDFDict pdfFunctionShader("Pattern");
-    pdfFunctionShader.insertInt("PatternType", 2);
     pdfFunctionShader.insertObject("Matrix", SkPDFUtils::MatrixToArray(finalMatrix));
     pdfFunctionShader.insertObject("Shading", std::move(pdfShader));
     return doc->emit(pdfFunctionShader);
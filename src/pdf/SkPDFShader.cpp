@@ -21,6 +21,7 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/base/SkTPin.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkKeyedImage.h"
@@ -30,7 +31,10 @@
 #include "src/pdf/SkPDFUtils.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <utility>
 
 static void draw(SkCanvas* canvas, const SkImage* image, SkColor4f paintColor) {
@@ -266,6 +270,26 @@ static SkPDFIndirectReference make_image_shader(SkPDFDocument* doc,
     return SkPDFStreamOut(std::move(dict), std::move(imageShader), doc);
 }
 
+// Every rasterized fallback shader is a new SkImage, so repeated draws of the same shader
+// would each emit their own image. The document remembers the image it emitted for each hash of
+// the pixels, and later images with the same hash and the same pixels use it.
+static std::optional<uint64_t> fallback_image_hash(const SkImage* image) {
+    SkPixmap pixmap;
+    if (!image->peekPixels(&pixmap) || pixmap.rowBytes() != pixmap.info().minRowBytes()) {
+        return std::nullopt;
+    }
+    return SkChecksum::Hash64(pixmap.addr(), pixmap.computeByteSize(),
+                              (uint64_t)pixmap.width() << 32 | pixmap.height());
+}
+
+// Both images have tightly packed pixels, as checked by fallback_image_hash().
+static bool same_fallback_pixels(const SkImage* a, const SkImage* b) {
+    SkPixmap pa, pb;
+    SkAssertResult(a->peekPixels(&pa) && b->peekPixels(&pb));
+    return pa.info() == pb.info() &&
+           0 == memcmp(pa.addr(), pb.addr(), pa.computeByteSize());
+}
+
 // Generic fallback for unsupported shaders:
 //  * allocate a surfaceBBox-sized bitmap
 //  * shade the whole area
@@ -314,12 +338,37 @@ static SkPDFIndirectReference make_fallback_shader(SkPDFDocument* doc,
 
     sk_sp<SkImage> image = surface->makeImageSnapshot();
     SkASSERT(image);
-    return make_image_shader(doc,
-                             SkMatrix::Concat(canvasTransform, shaderTransform),
-                             SkTileMode::kClamp, SkTileMode::kClamp,
-                             SkRect::Make(surfaceBBox),
-                             image.get(),
-                             paintColor);
+    const SkBitmapKey imageKey = SkBitmapKeyFromImage(image.get());
+    const std::optional<uint64_t> imageHash = fallback_image_hash(image.get());
+    if (imageHash) {
+        const auto* found = doc->fFallbackShaderImages.find(*imageHash);
+        if (found && same_fallback_pixels(found->fImage.get(), image.get())) {
+            doc->fPDFBitmapMap.set(imageKey, found->fRef);
+        }
+    }
+    SkMatrix finalMatrix = SkMatrix::Concat(canvasTransform, shaderTransform);
+    SkPDFImageShaderKey key = {
+        finalMatrix,
+        surfaceBBox,
+        SkBitmapKeyFromImage(image.get()),
+        {SkTileMode::kClamp, SkTileMode::kClamp},
+        paintColor};
+    if (SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key)) {
+        return *shaderPtr;
+    }
+    SkPDFIndirectReference pdfShader = make_image_shader(doc,
+                                                         finalMatrix,
+                                                         SkTileMode::kClamp, SkTileMode::kClamp,
+                                                         SkRect::Make(surfaceBBox),
+                                                         image.get(),
+                                                         paintColor);
+    doc->fImageShaderMap.set(std::move(key), pdfShader);
+    if (imageHash && !doc->fFallbackShaderImages.find(*imageHash)) {
+        if (SkPDFIndirectReference* emitted = doc->fPDFBitmapMap.find(imageKey)) {
+            doc->fFallbackShaderImages.set(*imageHash, {image, *emitted});
+        }
+    }
+    return pdfShader;
 }
 
 static SkColor4f adjust_color(SkShader* shader, SkColor4f paintColor) {
@@ -372,6 +421,5 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
         doc->fImageShaderMap.set(std::move(key), pdfShader);
         return pdfShader;
     }
-    // Don't bother to de-dup fallback shader.
     return make_fallback_shader(doc, shader, canvasTransform, surfaceBBox, paintColor);
 }
@@ -41,6 +41,8 @@
 #include "src/utils/SkCallableTraits.h"
 #include "src/utils/SkMatrix22.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <tuple>
@@ -128,16 +130,37 @@ using FT_Alloc_size_t = SkCallableTraits<FT_Alloc_Func>::argument<1>::type;
 static_assert(std::is_same<FT_Alloc_size_t, long  >::value ||
               std::is_same<FT_Alloc_size_t, size_t>::value,"");
 
+// Each FreeType block starts with its size, so frees can be counted as well as allocations.
+static constexpr size_t kFTBlockHeader = alignof(std::max_align_t);
+// Bytes FreeType allocated on this thread less those it freed, used to measure what a face holds.
+static thread_local ptrdiff_t gFTThreadHeldBytes = 0;
+
 extern "C" {
     static void* sk_ft_alloc(FT_Memory, FT_Alloc_size_t size) {
-        return sk_malloc_canfail(size);
+        char* block = static_cast<char*>(sk_malloc_canfail(kFTBlockHeader + size));
+        if (!block) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t*>(block) = size;
+        gFTThreadHeldBytes += size;
+        return block + kFTBlockHeader;
     }
     static void sk_ft_free(FT_Memory, void* block) {
-        sk_free(block);
+        if (!block) {
+            return;
+        }
+        char* header = static_cast<char*>(block) - kFTBlockHeader;
+        gFTThreadHeldBytes -= *reinterpret_cast<size_t*>(header);
+        sk_free(header);
     }
-    static void* sk_ft_realloc(FT_Memory, FT_Alloc_size_t cur_size,
+    static void* sk_ft_realloc(FT_Memory, FT_Alloc_size_t,
                                           FT_Alloc_size_t new_size, void* block) {
-        return sk_realloc_throw(block, new_size);
+        char* header = block ? static_cast<char*>(block) - kFTBlockHeader : nullptr;
+        const size_t oldSize = header ? *reinterpret_cast<size_t*>(header) : 0;
+        header = static_cast<char*>(sk_realloc_throw(header, kFTBlockHeader + new_size));
+        *reinterpret_cast<size_t*>(header) = new_size;
+        gFTThreadHeldBytes += static_cast<ptrdiff_t>(new_size) - static_cast<ptrdiff_t>(oldSize);
+        return header + kFTBlockHeader;
     }
 }
 FT_MemoryRec_ gFTMemory = { nullptr, sk_ft_alloc, sk_ft_free, sk_ft_realloc };
@@ -197,6 +220,19 @@ static SkMutex& f_t_mutex() {
 
 static FreeTypeLibrary* gFTLibrary;
 
+// The first scaler context of a typeface borrows the typeface's FT_Face. Any other context that is
+// alive at the same time takes a private face from the typeface's pool, opening one if the pool is
+// empty, and returns it to the pool when it is destroyed. FreeType allows distinct faces of one
+// FT_Library to be used concurrently, so glyphs can then be generated without holding f_t_mutex(),
+// which otherwise serializes all glyph generation in the process. Only opening and closing faces
+// (and sizes) still needs f_t_mutex(). The FreeType heap held by the open private faces is capped
+// by this budget; once it is spent, new scaler contexts share the typeface's face again. Define as
+// 0 to disable.
+#ifndef SK_FREETYPE_PRIVATE_FACE_BUDGET
+    #define SK_FREETYPE_PRIVATE_FACE_BUDGET (4 * 1024 * 1024)
+#endif
+static size_t gPrivateFaceBytes = 0;  // Guarded by f_t_mutex().
+
 ///////////////////////////////////////////////////////////////////////////
 
 class SkTypeface_FreeType::FaceRec {
@@ -206,6 +242,7 @@ public:
     std::unique_ptr<SkStreamAsset> fSkStream;
     FT_UShort fFTPaletteEntryCount = 0;
     std::unique_ptr<SkColor[]> fSkPalette;
+    size_t fOpenBytes = 0;  // FreeType heap still held after opening this face.
 
     static std::unique_ptr<FaceRec> Make(const SkTypeface_FreeType* typeface);
     ~FaceRec();
@@ -391,6 +428,7 @@ SkTypeface_FreeType::FaceRec::Make(const SkTypeface_FreeType* typeface) {
         args.stream = &rec->fFTStream;
     }
 
+    const ptrdiff_t heldBefore = gFTThreadHeldBytes;
     {
         FT_Face rawFace;
         FT_Error err = FT_Open_Face(gFTLibrary->library(), &args, data->getIndex(), &rawFace);
@@ -414,6 +452,7 @@ SkTypeface_FreeType::FaceRec::Make(const SkTypeface_FreeType* typeface) {
     if (!rec->fFace->charmap) {
         FT_Select_Charmap(rec->fFace.get(), FT_ENCODING_MS_SYMBOL);
     }
+    rec->fOpenBytes = std::max<ptrdiff_t>(gFTThreadHeldBytes - heldBefore, 0);
 
     return rec;
 }
@@ -466,7 +505,11 @@ private:
     // This value was chosen by eyeballing the result in Firefox and trying to match it.
     static const FT_Pos kBitmapEmboldenStrength = 1 << 6;
 
-    SkTypeface_FreeType::FaceRec* fFaceRec; // Borrowed face from the typeface's FaceRec.
+    // This context's face from the typeface's pool, if it got one. See
+    // SK_FREETYPE_PRIVATE_FACE_BUDGET.
+    std::unique_ptr<SkTypeface_FreeType::FaceRec> fPrivateFaceRec;
+    SkMutex fPrivateFaceMutex;
+    SkTypeface_FreeType::FaceRec* fFaceRec; // fPrivateFaceRec or the typeface's FaceRec.
     FT_Face   fFace;  // Borrowed face from fFaceRec.
     FT_Size   fFTSize;  // The size to apply to the fFace.
     FT_Int    fStrikeIndex; // The bitmap strike for the fFace (or -1 if none).
@@ -487,14 +530,16 @@ private:
     bool      fDoLinearMetrics;
     bool      fLCDIsVert;
 
+    // Guards fFace: f_t_mutex() when it is shared with the typeface and other contexts.
+    SkMutex& faceMutex() { return fPrivateFaceRec ? fPrivateFaceMutex : f_t_mutex(); }
     FT_Error setupSize();
-    // Caller must lock f_t_mutex() before calling this function.
+    // Caller must lock faceMutex() before calling this function.
     static bool getBoundsOfCurrentOutlineGlyph(FT_GlyphSlot glyph, SkRect* bounds);
-    // Caller must lock f_t_mutex() before calling this function.
+    // Caller must lock faceMutex() before calling this function.
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
     static void updateGlyphBoundsIfSubpixel(const SkGlyph&, SkRect* bounds, bool subpixel);
     void updateGlyphBoundsIfLCD(GlyphMetrics* mx);
-    // Caller must lock f_t_mutex() before calling this function.
+    // Caller must lock faceMutex() before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph, SkGlyphID gid);
     bool shouldSubpixelBitmap(const SkGlyph&, const SkMatrix&);
@@ -901,7 +946,9 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface_FreeType> ty
     , fStrikeIndex(-1)
 {
     SkAutoMutexExclusive  ac(f_t_mutex());
-    fFaceRec = static_cast<SkTypeface_FreeType*>(this->getTypeface())->getFaceRec();
+    auto ftTypeface = static_cast<SkTypeface_FreeType*>(this->getTypeface());
+    fPrivateFaceRec = ftTypeface->acquireFaceRec();
+    fFaceRec = fPrivateFaceRec ? fPrivateFaceRec.get() : ftTypeface->getFaceRec();
 
     // load the font file
     if (nullptr == fFaceRec) {
@@ -1085,13 +1132,15 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     }
 
     fFaceRec = nullptr;
+    static_cast<SkTypeface_FreeType*>(this->getTypeface())->releaseFaceRec(
+            std::move(fPrivateFaceRec));
 }
 
 /*  We call this before each use of the fFace, since we may be sharing
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    f_t_mutex().assertHeld();
+    this->faceMutex().assertHeld();
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -1171,7 +1220,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 
 SkScalerContext::GlyphMetrics SkScalerContext_FreeType::generateMetrics(const SkGlyph& glyph,
                                                                         SkArenaAlloc* alloc) {
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(this->faceMutex());
 
     GlyphMetrics mx(glyph.maskFormat());
 
@@ -1350,7 +1399,7 @@ SkScalerContext::GlyphMetrics SkScalerContext_FreeType::generateMetrics(const Sk
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph, void* imageBuffer) {
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(this->faceMutex());
 
     if (this->setupSize()) {
         sk_bzero(imageBuffer, glyph.imageSize());
@@ -1417,13 +1466,12 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph, void* imageBu
 }
 
 sk_sp<SkDrawable> SkScalerContext_FreeType::generateDrawable(const SkGlyph& glyph) {
-    // Because FreeType's FT_Face is stateful (not thread safe) and the current design of this
-    // SkTypeface and SkScalerContext does not work around this, it is necessary lock at least the
-    // FT_Face when using it (this implementation currently locks the whole FT_Library).
+    // Because FreeType's FT_Face is stateful (not thread safe), it is necessary to lock the FT_Face
+    // when using it (this locks the whole FT_Library unless this context has its own face).
     // It should be possible to draw the drawable straight out of the FT_Face. However, this would
     // mean locking each time any such drawable is drawn. To avoid locking, this implementation
     // creates drawables backed as pictures so that they can be played back later without locking.
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(this->faceMutex());
 
     if (this->setupSize()) {
         return nullptr;
@@ -1474,7 +1522,7 @@ sk_sp<SkDrawable> SkScalerContext_FreeType::generateDrawable(const SkGlyph& glyp
 bool SkScalerContext_FreeType::generatePath(const SkGlyph& glyph, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(this->faceMutex());
 
     SkGlyphID glyphID = glyph.getGlyphID();
     // FT_IS_SCALABLE is documented to mean the face contains outline glyphs.
@@ -1516,7 +1564,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkFontMetrics* metrics) {
         return;
     }
 
-    SkAutoMutexExclusive ac(f_t_mutex());
+    SkAutoMutexExclusive ac(this->faceMutex());
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
@@ -1705,9 +1753,13 @@ SkTypeface_FreeType::SkTypeface_FreeType(const SkFontStyle& style, bool isFixedP
 {}
 
 SkTypeface_FreeType::~SkTypeface_FreeType() {
-    if (fFaceRec) {
+    if (fFaceRec || !fFacePool.empty()) {
         SkAutoMutexExclusive ac(f_t_mutex());
         fFaceRec.reset();
+        for (std::unique_ptr<FaceRec>& rec : fFacePool) {
+            gPrivateFaceBytes -= rec->fOpenBytes;
+        }
+        fFacePool.clear();
     }
 }
 
@@ -1724,13 +1776,7 @@ void SkTypeface_FreeType::onCharsToGlyphs(const SkUnichar uni[], int count,
     {
         // Optimistically use a shared lock.
         SkAutoSharedMutexShared ama(fC2GCacheMutex);
-        for (i = 0; i < count; ++i) {
-            int index = fC2GCache.findGlyphIndex(uni[i]);
-            if (index < 0) {
-                break;
-            }
-            glyphs[i] = SkToU16(index);
-        }
+        i = fC2GCache.findGlyphs(uni, count, glyphs);
         if (i == count) {
             // we're done, no need to access the freetype objects
             return;
@@ -1931,6 +1977,41 @@ SkTypeface_FreeType::FaceRec* SkTypeface_FreeType::getFaceRec() const {
     return fFaceRec.get();
 }
 
+std::unique_ptr<SkTypeface_FreeType::FaceRec> SkTypeface_FreeType::acquireFaceRec() const {
+    f_t_mutex().assertHeld();
+    if (fSharedFaceContextCount > 0) {
+        if (!fFacePool.empty()) {
+            std::unique_ptr<FaceRec> rec = std::move(fFacePool.back());
+            fFacePool.pop_back();
+            return rec;
+        }
+        if (gPrivateFaceBytes < SK_FREETYPE_PRIVATE_FACE_BUDGET) {
+            std::unique_ptr<FaceRec> rec = FaceRec::Make(this);
+            if (rec) {
+                gPrivateFaceBytes += rec->fOpenBytes;
+                return rec;
+            }
+        }
+    }
+    ++fSharedFaceContextCount;
+    return nullptr;
+}
+
+void SkTypeface_FreeType::releaseFaceRec(std::unique_ptr<FaceRec> rec) const {
+    f_t_mutex().assertHeld();
+    if (rec) {
+        fFacePool.push_back(std::move(rec));
+    } else {
+        SkASSERT(fSharedFaceContextCount > 0);
+        --fSharedFaceContextCount;
+    }
+}
+
+int SkTypeface_FreeType::pooledFaceCount() const {
+    SkAutoMutexExclusive ac(f_t_mutex());
+    return SkToInt(fFacePool.size());
+}
+
 std::unique_ptr<SkFontData> SkTypeface_FreeType::makeFontData() const {
     return this->onMakeFontData();
 }
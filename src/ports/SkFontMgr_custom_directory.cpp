@@ -5,26 +5,204 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/ports/SkFontMgr_directory.h"
+#include "include/private/base/SkTArray.h"
 #include "src/core/SkFontScanner.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkTHash.h"
+#include "src/core/SkWriteBuffer.h"
 #include "src/ports/SkFontMgr_custom.h"
 #include "src/ports/SkTypeface_FreeType.h"
 #include "src/utils/SkOSPath.h"
 
+#include <cstdint>
+#include <cstdio>
+
+using namespace skia_private;
+
+namespace {
+
+// What scanning a font file found, so the file need not be opened again until it is used.
+struct FontFileEntry {
+    struct Instance {
+        SkString    fFamilyName;
+        SkFontStyle fStyle;
+        bool        fIsFixedPitch;
+        int         fIndex;  // (instanceIndex << 16) + faceIndex
+    };
+    size_t            fSize = 0;
+    int64_t           fModified = 0;
+    TArray<Instance>  fInstances;
+};
+
+using FontFileIndex = THashMap<SkString, FontFileEntry>;
+
+// The index file is an SkBinaryWriteBuffer: magic, version, file count, then for each file its
+// path, size, modification time and instances.
+constexpr uint32_t kIndexMagic = SkSetFourByteTag('s', 'k', 'f', 'i');
+// Bump when the index layout or what the scanner reports changes.
+constexpr uint32_t kIndexVersion = 1;
+
+void write_u64(SkWriteBuffer& buffer, uint64_t value) {
+    buffer.writeUInt(static_cast<uint32_t>(value));
+    buffer.writeUInt(static_cast<uint32_t>(value >> 32));
+}
+
+uint64_t read_u64(SkReadBuffer& buffer) {
+    uint64_t lo = buffer.readUInt();
+    uint64_t hi = buffer.readUInt();
+    return lo | (hi << 32);
+}
+
+FontFileIndex read_index(const char* indexPath) {
+    FontFileIndex index;
+    // The index is memory mapped and read in place.
+    sk_sp<SkData> data = SkData::MakeFromFileName(indexPath);
+    if (!data) {
+        return index;
+    }
+    SkReadBuffer buffer(data->data(), data->size());
+    if (buffer.readUInt() != kIndexMagic || buffer.readUInt() != kIndexVersion) {
+        return index;
+    }
+    const uint32_t fileCount = buffer.readUInt();
+    for (uint32_t i = 0; i < fileCount && buffer.isValid(); ++i) {
+        SkString path;
+        buffer.readString(&path);
+        FontFileEntry entry;
+        entry.fSize = static_cast<size_t>(read_u64(buffer));
+        entry.fModified = static_cast<int64_t>(read_u64(buffer));
+        const uint32_t instanceCount = buffer.readUInt();
+        if (!buffer.validate(instanceCount <= buffer.available())) {
+            break;
+        }
+        for (uint32_t j = 0; j < instanceCount && buffer.isValid(); ++j) {
+            FontFileEntry::Instance& instance = entry.fInstances.push_back();
+            buffer.readString(&instance.fFamilyName);
+            const int weight = buffer.readInt();
+            const int width = buffer.readInt();
+            const int slant = buffer.readInt();
+            instance.fStyle = SkFontStyle(weight, width, (SkFontStyle::Slant)slant);
+            instance.fIsFixedPitch = buffer.readBool();
+            instance.fIndex = buffer.readInt();
+            buffer.validate(SkFontStyle::kUpright_Slant <= slant &&
+                            slant <= SkFontStyle::kOblique_Slant);
+        }
+        index.set(std::move(path), std::move(entry));
+    }
+    if (!buffer.isValid()) {
+        index.reset();
+    }
+    return index;
+}
+
+void write_index(const char* indexPath, const FontFileIndex& index) {
+    SkBinaryWriteBuffer buffer({});
+    buffer.writeUInt(kIndexMagic);
+    buffer.writeUInt(kIndexVersion);
+    buffer.writeUInt(index.count());
+    index.foreach([&](const SkString& path, const FontFileEntry& entry) {
+        buffer.writeString(path.c_str());
+        write_u64(buffer, entry.fSize);
+        write_u64(buffer, static_cast<uint64_t>(entry.fModified));
+        buffer.writeUInt(entry.fInstances.size());
+        for (const FontFileEntry::Instance& instance : entry.fInstances) {
+            buffer.writeString(instance.fFamilyName.c_str());
+            buffer.writeInt(instance.fStyle.weight());
+            buffer.writeInt(instance.fStyle.width());
+            buffer.writeInt(instance.fStyle.slant());
+            buffer.writeBool(instance.fIsFixedPitch);
+            buffer.writeInt(instance.fIndex);
+        }
+    });
+
+    // Other processes may have the old index mapped, so replace it rather than rewriting it.
+    SkString tempPath = SkStringPrintf("%s.tmp", indexPath);
+    {
+        SkFILEWStream stream(tempPath.c_str());
+        if (!stream.isValid() || !buffer.writeToStream(&stream)) {
+            return;
+        }
+    }
+    if (0 != std::rename(tempPath.c_str(), indexPath)) {
+        std::remove(indexPath);
+        if (0 != std::rename(tempPath.c_str(), indexPath)) {
+            std::remove(tempPath.c_str());
+        }
+    }
+}
+
+// Returns false if the file could not be read, so should not be indexed.
+bool scan_file(const SkFontScanner* scanner, const SkString& filename, FontFileEntry* entry) {
+    std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
+    if (!stream) {
+        // SkDebugf("---- failed to open <%s>\n", filename.c_str());
+        return false;
+    }
+
+    int numFaces;
+    if (!scanner->scanFile(stream.get(), &numFaces)) {
+        // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+        return true;
+    }
+
+    for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+        int numInstances;
+        if (!scanner->scanFace(stream.get(), faceIndex, &numInstances)) {
+            // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
+            continue;
+        }
+        for (int instanceIndex = 0; instanceIndex <= numInstances; ++instanceIndex) {
+            bool isFixedPitch;
+            SkString realname;
+            SkFontStyle style = SkFontStyle(); // avoid uninitialized warning
+            if (!scanner->scanInstance(stream.get(),
+                                       faceIndex,
+                                       instanceIndex,
+                                       &realname,
+                                       &style,
+                                       &isFixedPitch,
+                                       nullptr)) {
+                // SkDebugf("---- failed to open <%s> <%d> as a font\n",
+                //          filename.c_str(), faceIndex);
+                continue;
+            }
+            entry->fInstances.push_back({std::move(realname), style, isFixedPitch,
+                                         (instanceIndex << 16) + faceIndex});
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 class DirectorySystemFontLoader : public SkFontMgr_Custom::SystemFontLoader {
 public:
-    DirectorySystemFontLoader(const char* dir) : fBaseDirectory(dir) { }
+    DirectorySystemFontLoader(const char* dir, const char* indexPath)
+        : fBaseDirectory(dir), fIndexPath(indexPath ? indexPath : "") { }
 
     void loadSystemFonts(const SkFontScanner* scanner,
                          SkFontMgr_Custom::Families* families) const override
     {
-        load_directory_fonts(scanner, fBaseDirectory, ".ttf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".ttc", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".otf", families);
-        load_directory_fonts(scanner, fBaseDirectory, ".pfb", families);
+        // With an index, only files which are new or changed since it was written are scanned;
+        // every other font is added from its index entry without being opened.
+        const bool useIndex = !fIndexPath.isEmpty();
+        const FontFileIndex oldIndex = useIndex ? read_index(fIndexPath.c_str()) : FontFileIndex();
+        Loader loader{scanner, families, useIndex, &oldIndex, {}, false};
+
+        load_directory_fonts(loader, fBaseDirectory, ".ttf");
+        load_directory_fonts(loader, fBaseDirectory, ".ttc");
+        load_directory_fonts(loader, fBaseDirectory, ".otf");
+        load_directory_fonts(loader, fBaseDirectory, ".pfb");
+
+        if (useIndex && (loader.fIndexChanged || loader.fNewIndex.count() != oldIndex.count())) {
+            write_index(fIndexPath.c_str(), loader.fNewIndex);
+        }
 
         if (families->empty()) {
             SkFontStyleSet_Custom* family = new SkFontStyleSet_Custom(SkString());
@@ -34,6 +212,15 @@ public:
     }
 
 private:
+    struct Loader {
+        const SkFontScanner* fScanner;
+        SkFontMgr_Custom::Families* fFamilies;
+        bool fUseIndex;
+        const FontFileIndex* fOldIndex;
+        FontFileIndex fNewIndex;
+        bool fIndexChanged = false;
+    };
+
     static SkFontStyleSet_Custom* find_family(SkFontMgr_Custom::Families& families,
                                               const char familyName[])
     {
@@ -45,59 +232,54 @@ private:
         return nullptr;
     }
 
-    static void load_directory_fonts(const SkFontScanner* scanner,
-                                     const SkString& directory, const char* suffix,
-                                     SkFontMgr_Custom::Families* families)
+    static void add_file(Loader& loader, const SkString& filename) {
+        FontFileEntry scanned;
+        const FontFileEntry* entry = nullptr;
+        if (loader.fUseIndex) {
+            if (!sk_stat(filename.c_str(), &scanned.fSize, &scanned.fModified)) {
+                return;
+            }
+            const FontFileEntry* indexed = loader.fOldIndex->find(filename);
+            if (indexed && indexed->fSize == scanned.fSize &&
+                indexed->fModified == scanned.fModified) {
+                entry = indexed;
+            }
+        }
+        if (!entry) {
+            // Files which are not fonts are indexed too, with no instances, so they are not
+            // rescanned every time.
+            if (!scan_file(loader.fScanner, filename, &scanned)) {
+                return;
+            }
+            entry = &scanned;
+            loader.fIndexChanged = true;
+        }
+
+        for (const FontFileEntry::Instance& instance : entry->fInstances) {
+            SkFontStyleSet_Custom* addTo = find_family(*loader.fFamilies,
+                                                       instance.fFamilyName.c_str());
+            if (nullptr == addTo) {
+                addTo = new SkFontStyleSet_Custom(instance.fFamilyName);
+                loader.fFamilies->push_back().reset(addTo);
+            }
+            addTo->appendTypeface(sk_make_sp<SkTypeface_File>(
+                    instance.fStyle, instance.fIsFixedPitch, true, instance.fFamilyName,
+                    filename.c_str(), instance.fIndex));
+        }
+
+        if (loader.fUseIndex) {
+            loader.fNewIndex.set(filename, *entry);
+        }
+    }
+
+    static void load_directory_fonts(Loader& loader, const SkString& directory,
+                                     const char* suffix)
     {
         SkOSFile::Iter iter(directory.c_str(), suffix);
         SkString name;
 
         while (iter.next(&name, false)) {
-            SkString filename(SkOSPath::Join(directory.c_str(), name.c_str()));
-            std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(filename.c_str());
-            if (!stream) {
-                // SkDebugf("---- failed to open <%s>\n", filename.c_str());
-                continue;
-            }
-
-            int numFaces;
-            if (!scanner->scanFile(stream.get(), &numFaces)) {
-                // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
-                continue;
-            }
-
-            for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
-                int numInstances;
-                if (!scanner->scanFace(stream.get(), faceIndex, &numInstances)) {
-                    // SkDebugf("---- failed to open <%s> as a font\n", filename.c_str());
-                    continue;
-                }
-                for (int instanceIndex = 0; instanceIndex <= numInstances; ++instanceIndex) {
-                    bool isFixedPitch;
-                    SkString realname;
-                    SkFontStyle style = SkFontStyle(); // avoid uninitialized warning
-                    if (!scanner->scanInstance(stream.get(),
-                                               faceIndex,
-                                               instanceIndex,
-                                               &realname,
-                                               &style,
-                                               &isFixedPitch,
-                                               nullptr)) {
-                        // SkDebugf("---- failed to open <%s> <%d> as a font\n",
-                        //          filename.c_str(), faceIndex);
-                        continue;
-                    }
-
-                    SkFontStyleSet_Custom* addTo = find_family(*families, realname.c_str());
-                    if (nullptr == addTo) {
-                        addTo = new SkFontStyleSet_Custom(realname);
-                        families->push_back().reset(addTo);
-                    }
-                    addTo->appendTypeface(sk_make_sp<SkTypeface_File>(
-                            style, isFixedPitch, true, realname, filename.c_str(),
-                            (instanceIndex << 16) + faceIndex));
-                }
-            }
+            add_file(loader, SkOSPath::Join(directory.c_str(), name.c_str()));
         }
 
         SkOSFile::Iter dirIter(directory.c_str());
@@ -106,13 +288,18 @@ private:
                 continue;
             }
             SkString dirname(SkOSPath::Join(directory.c_str(), name.c_str()));
-            load_directory_fonts(scanner, dirname, suffix, families);
+            load_directory_fonts(loader, dirname, suffix);
         }
     }
 
     SkString fBaseDirectory;
+    SkString fIndexPath;
 };
 
 sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir) {
-    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir));
+    return SkFontMgr_New_Custom_Directory(dir, nullptr);
+}
+
+sk_sp<SkFontMgr> SkFontMgr_New_Custom_Directory(const char* dir, const char* indexPath) {
+    return sk_make_sp<SkFontMgr_Custom>(DirectorySystemFontLoader(dir, indexPath));
 }
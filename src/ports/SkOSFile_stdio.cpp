@@ -156,6 +156,16 @@ bool sk_isdir(const char *path) {
     return false;
 }
 
+bool sk_stat(const char* path, size_t* size, int64_t* modified) {
+    struct stat status = {};
+    if (stat(path, &status) != 0) {
+        return false;
+    }
+    *size = static_cast<size_t>(status.st_size);
+    *modified = static_cast<int64_t>(status.st_mtime);
+    return true;
+}
+
 bool sk_mkdir(const char* path) {
     if (sk_isdir(path)) {
         return true;
@@ -20,6 +20,9 @@
 #include "src/core/SkFontScanner.h"
 #include "src/utils/SkCharToGlyphCache.h"
 
+#include <memory>
+#include <vector>
+
 class SkFontData;
 
 // These are forward declared to avoid pimpl but also hide the FreeType implementation.
@@ -39,6 +42,14 @@ public:
     class FaceRec;
     FaceRec* getFaceRec() const;
 
+    // Scaler contexts call these with the FreeType mutex held. acquireFaceRec() returns a face
+    // that no other context uses, or nullptr if the context should share getFaceRec(). Contexts
+    // pass what it returned to releaseFaceRec() when they are destroyed.
+    std::unique_ptr<FaceRec> acquireFaceRec() const;
+    void releaseFaceRec(std::unique_ptr<FaceRec>) const;
+    // How many private faces are waiting in the pool for a scaler context.
+    int pooledFaceCount() const;
+
     static constexpr SkTypeface::FactoryId FactoryId = SkSetFourByteTag('f','r','e','e');
     static sk_sp<SkTypeface> MakeFromStream(std::unique_ptr<SkStreamAsset>, const SkFontArguments&);
 
@@ -79,6 +90,9 @@ protected:
 private:
     mutable SkOnce fFTFaceOnce;
     mutable std::unique_ptr<FaceRec> fFaceRec;
+    // Guarded by the FreeType mutex.
+    mutable int fSharedFaceContextCount = 0;
+    mutable std::vector<std::unique_ptr<FaceRec>> fFacePool;
 
     mutable SkSharedMutex fC2GCacheMutex;
     mutable SkCharToGlyphCache fC2GCache;
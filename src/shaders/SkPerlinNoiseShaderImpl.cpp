@@ -9,18 +9,23 @@
 
 #include "include/core/SkColor.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkShader.h"
 #include "include/effects/SkPerlinNoiseShader.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkEffectPriv.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
 #include "src/core/SkRasterPipelineOpList.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkResourceCache.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/shaders/SkPerlinNoiseShaderType.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <optional>
 
 SkPerlinNoiseShader::SkPerlinNoiseShader(SkPerlinNoiseShaderType type,
@@ -80,18 +85,95 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-bool SkPerlinNoiseShader::appendStages(const SkStageRec& rec,
-                                       const SkShaders::MatrixRec& mRec) const {
-    std::optional<SkShaders::MatrixRec> newMRec = mRec.apply(rec);
-    if (!newMRec.has_value()) {
-        return false;
+namespace {
+
+// On the raster backend, the noise over every stitched tile a draw with a whole pixel translation
+// covers is generated once, cached, and read back by the perlin_noise stage. The stitched noise
+// doesn't repeat exactly from tile to tile, so the tiles are generated where they are drawn rather
+// than copied from the first one, and kept as F32 so they hold exactly what the stage computes.
+constexpr int kMaxCachedNoisePixels = 512 * 512;
+
+static unsigned gNoiseTileKeyNamespaceLabel;
+
+struct NoiseTileKey : public SkResourceCache::Key {
+public:
+    NoiseTileKey(SkPerlinNoiseShaderType type, SkScalar baseFrequencyX, SkScalar baseFrequencyY,
+                 int numOctaves, SkScalar seed, SkISize tileSize, const SkIRect& bounds)
+            : fType(static_cast<int32_t>(type))
+            , fBaseFrequencyX(baseFrequencyX)
+            , fBaseFrequencyY(baseFrequencyY)
+            , fNumOctaves(numOctaves)
+            , fSeed(seed)
+            , fTileWidth(tileSize.width())
+            , fTileHeight(tileSize.height())
+            , fBounds(bounds) {
+        this->init(&gNoiseTileKeyNamespaceLabel, 0,
+                   sizeof(fType) + sizeof(fBaseFrequencyX) + sizeof(fBaseFrequencyY) +
+                   sizeof(fNumOctaves) + sizeof(fSeed) + sizeof(fTileWidth) + sizeof(fTileHeight) +
+                   sizeof(fBounds));
     }
 
+    int32_t  fType;
+    SkScalar fBaseFrequencyX;
+    SkScalar fBaseFrequencyY;
+    int32_t  fNumOctaves;
+    SkScalar fSeed;
+    int32_t  fTileWidth;
+    int32_t  fTileHeight;
+    SkIRect  fBounds;
+};
+
+struct NoiseTileRec : public SkResourceCache::Rec {
+    NoiseTileRec(const NoiseTileKey& key, const SkBitmap& tile) : fKey(key), fTile(tile) {}
+
+    NoiseTileKey fKey;
+    SkBitmap     fTile;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fTile.computeByteSize(); }
+    const char* getCategory() const override { return "perlin-noise-tile"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const NoiseTileRec& rec = static_cast<const NoiseTileRec&>(baseRec);
+        *static_cast<SkBitmap*>(contextData) = rec.fTile;
+        return true;
+    }
+};
+
+// Past this, pixel centers offset by a whole translation may round differently when the cache is
+// filled than when they are drawn.
+constexpr int kMaxExactNoiseCoord = 1 << 22;
+
+// The whole tiles, in noise coordinates, under a 'dstSize' device translated by (tx, ty); empty if
+// they reach past kMaxExactNoiseCoord.
+SkIRect covered_tiles(SkISize dstSize, SkScalar tx, SkScalar ty, SkISize tileSize) {
+    if (!(SkScalarAbs(tx) <= kMaxExactNoiseCoord && SkScalarAbs(ty) <= kMaxExactNoiseCoord)) {
+        return SkIRect::MakeEmpty();
+    }
+    auto floorDiv = [](int64_t a, int64_t b) { return a >= 0 ? a / b : -((b - 1 - a) / b); };
+    const int64_t left   = -static_cast<int64_t>(SkScalarRoundToInt(tx)),
+                  top    = -static_cast<int64_t>(SkScalarRoundToInt(ty)),
+                  right  = left + dstSize.width(),
+                  bottom = top + dstSize.height();
+    const int64_t tileLeft   = floorDiv(left, tileSize.width()) * tileSize.width(),
+                  tileTop    = floorDiv(top, tileSize.height()) * tileSize.height(),
+                  tileRight  = (floorDiv(right - 1, tileSize.width()) + 1) * tileSize.width(),
+                  tileBottom = (floorDiv(bottom - 1, tileSize.height()) + 1) * tileSize.height();
+    if (std::max({-tileLeft, -tileTop, tileRight, tileBottom}) > kMaxExactNoiseCoord) {
+        return SkIRect::MakeEmpty();
+    }
+    return SkIRect::MakeLTRB(SkToS32(tileLeft), SkToS32(tileTop),
+                             SkToS32(tileRight), SkToS32(tileBottom));
+}
+
+}  // namespace
+
+SkRasterPipeline_PerlinNoiseCtx* SkPerlinNoiseShader::makeContext(SkArenaAlloc* alloc) const {
     fInitPaintingDataOnce([&] {
         const_cast<SkPerlinNoiseShader*>(this)->fPaintingData = this->getPaintingData();
     });
 
-    auto* ctx = rec.fAlloc->make<SkRasterPipeline_PerlinNoiseCtx>();
+    auto* ctx = alloc->make<SkRasterPipeline_PerlinNoiseCtx>();
     ctx->noiseType = fType;
     ctx->baseFrequencyX = fPaintingData->fBaseFrequency.fX;
     ctx->baseFrequencyY = fPaintingData->fBaseFrequency.fY;
@@ -101,7 +183,77 @@ bool SkPerlinNoiseShader::appendStages(const SkStageRec& rec,
     ctx->numOctaves = fNumOctaves;
     ctx->latticeSelector = fPaintingData->fLatticeSelector;
     ctx->noiseData = &fPaintingData->fNoise[0][0][0];
+    return ctx;
+}
+
+SkBitmap SkPerlinNoiseShader::findOrMakeTiles(const SkIRect& bounds) const {
+    const NoiseTileKey key(fType, fBaseFrequencyX, fBaseFrequencyY, fNumOctaves, fSeed,
+                           fTileSize, bounds);
+    SkBitmap tile;
+    if (SkResourceCache::Find(key, NoiseTileRec::Visitor, &tile)) {
+        return tile;
+    }
+
+    if (!tile.tryAllocPixels(
+                SkImageInfo::Make(bounds.size(), kRGBA_F32_SkColorType, kPremul_SkAlphaType))) {
+        return {};
+    }
+    // Evaluate the noise at the centers of the pixels in 'bounds', as a draw with no translation
+    // would. Those are whole pixels away from the seeded centers, so the sums are exact.
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipelineOp::seed_shader);
+    p.appendMatrix(&alloc, SkMatrix::Translate(bounds.left(), bounds.top()));
+    p.append(SkRasterPipelineOp::perlin_noise, this->makeContext(&alloc));
+    SkRasterPipeline_MemoryCtx dst = {tile.getPixels(), tile.rowBytesAsPixels()};
+    p.appendStore(kRGBA_F32_SkColorType, &dst);
+    p.run(0, 0, tile.width(), tile.height());
+    tile.setImmutable();
+
+    SkResourceCache::Add(new NoiseTileRec(key, tile));
+    return tile;
+}
+
+bool SkPerlinNoiseShader::appendStages(const SkStageRec& rec,
+                                       const SkShaders::MatrixRec& mRec) const {
+    SkBitmap tile;
+    SkIRect tileBounds = SkIRect::MakeEmpty();
+    if (fStitchTiles && mRec.totalMatrixIsValid()) {
+        const SkMatrix totalMatrix = mRec.totalMatrix();
+        if (totalMatrix.isTranslate() && SkScalarIsInt(totalMatrix.getTranslateX()) &&
+            SkScalarIsInt(totalMatrix.getTranslateY())) {
+            // Cover the whole tiles under the pixels drawn into, or just the first tile if they
+            // aren't known.
+            tileBounds = SkIRect::MakeSize(fTileSize);
+            if (!rec.fDstSize.isEmpty()) {
+                tileBounds = covered_tiles(rec.fDstSize,
+                                           totalMatrix.getTranslateX(),
+                                           totalMatrix.getTranslateY(),
+                                           fTileSize);
+            }
+            if (!tileBounds.isEmpty() &&
+                tileBounds.width64() * tileBounds.height64() <= kMaxCachedNoisePixels) {
+                tile = this->findOrMakeTiles(tileBounds);
+            }
+        }
+    }
 
+    std::optional<SkShaders::MatrixRec> newMRec = mRec.apply(rec);
+    if (!newMRec.has_value()) {
+        return false;
+    }
+
+    SkRasterPipeline_PerlinNoiseCtx* ctx = this->makeContext(rec.fAlloc);
+    if (!tile.drawsNothing()) {
+        // Every pixel center maps to a tile pixel center, where the tile holds exactly what the
+        // stage computes. Keep the pixels alive with the pipeline.
+        ctx->cache = static_cast<const float*>(rec.fAlloc->make<SkBitmap>(tile)->getPixels());
+        SkASSERT(tile.rowBytesAsPixels() == tile.width());
+        ctx->cacheLeft = tileBounds.left();
+        ctx->cacheTop = tileBounds.top();
+        ctx->cacheWidth = tileBounds.width();
+        ctx->cacheHeight = tileBounds.height();
+    }
     rec.fPipeline->append(SkRasterPipelineOp::perlin_noise, ctx);
     return true;
 }
@@ -26,8 +26,10 @@
 #include <cstring>
 #include <memory>
 
+class SkArenaAlloc;
 class SkReadBuffer;
 enum class SkPerlinNoiseShaderType;
+struct SkRasterPipeline_PerlinNoiseCtx;
 struct SkStageRec;
 class SkWriteBuffer;
 
@@ -263,6 +265,11 @@ protected:
 private:
     SK_FLATTENABLE_HOOKS(SkPerlinNoiseShader)
 
+    SkRasterPipeline_PerlinNoiseCtx* makeContext(SkArenaAlloc*) const;
+    // The noise over 'bounds', a block of whole stitched tiles, from SkResourceCache; empty if it
+    // can't be allocated.
+    SkBitmap findOrMakeTiles(const SkIRect& bounds) const;
+
     const SkPerlinNoiseShaderType fType;
     const SkScalar fBaseFrequencyX;
     const SkScalar fBaseFrequencyY;
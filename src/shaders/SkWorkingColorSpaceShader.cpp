@@ -44,7 +44,8 @@ bool SkWorkingColorSpaceShader::appendStages(const SkStageRec& rec,
                              rec.fDstColorType,
                              fWorkingSpace.get(),
                              paintColorInWorkingSpace,
-                             rec.fSurfaceProps};
+                             rec.fSurfaceProps,
+                             rec.fDstSize};
 
     if (!as_SB(fShader)->appendStages(workingRec, mRec)) {
         return false;
@@ -7,6 +7,8 @@
 
 #include "src/utils/SkCharToGlyphCache.h"
 
+#include <cstring>
+
 SkCharToGlyphCache::SkCharToGlyphCache() {
     this->reset();
 }
@@ -24,6 +26,9 @@ void SkCharToGlyphCache::reset() {
     *fK32.append() = 0x7FFFFFFF;    *fV16.append() = 0;
 
     fDenom = 0;
+
+    memset(fPageIndex, 0, sizeof(fPageIndex));
+    fPages.reset();
 }
 
 // Determined experimentally. For N much larger, the slope technique is faster.
@@ -93,6 +98,13 @@ static int find_with_slope(const SkUnichar base[], int count, SkUnichar value, d
 }
 
 int SkCharToGlyphCache::findGlyphIndex(SkUnichar unichar) const {
+    if (const Page* page = this->findPage(unichar)) {
+        const int i = unichar & 0xFF;
+        if (page->fPresent[i >> 5] & (1u << (i & 31))) {
+            return page->fGlyphs[i];
+        }
+    }
+
     const int count = fK32.size();
     int index;
     if (count <= kSmallCountLimit) {
@@ -106,6 +118,38 @@ int SkCharToGlyphCache::findGlyphIndex(SkUnichar unichar) const {
     return index;
 }
 
+int SkCharToGlyphCache::findGlyphs(const SkUnichar unichars[], int count,
+                                   SkGlyphID glyphs[]) const {
+    for (int i = 0; i < count; ++i) {
+        int index = this->findGlyphIndex(unichars[i]);
+        if (index < 0) {
+            return i;
+        }
+        glyphs[i] = SkToU16(index);
+    }
+    return count;
+}
+
+void SkCharToGlyphCache::addToPage(SkUnichar unichar, SkGlyphID glyph) {
+    if (unichar < 0 || unichar > 0xFFFF) {
+        return;
+    }
+    uint8_t& pageIndex = fPageIndex[unichar >> 8];
+    if (!pageIndex) {
+        // Past a few pages the unichars are scattered, and the search is good enough.
+        if (fPages.size() == kMaxPages) {
+            return;
+        }
+        Page* page = fPages.append();
+        memset(page->fPresent, 0, sizeof(page->fPresent));
+        pageIndex = SkToU8(fPages.size());
+    }
+    Page& page = fPages[pageIndex - 1];
+    const int i = unichar & 0xFF;
+    page.fPresent[i >> 5] |= 1u << (i & 31);
+    page.fGlyphs[i] = glyph;
+}
+
 void SkCharToGlyphCache::insertCharAndGlyph(int index, SkUnichar unichar, SkGlyphID glyph) {
     SkASSERT(fK32.size() == fV16.size());
     SkASSERT(index < fK32.size());
@@ -113,6 +157,7 @@ void SkCharToGlyphCache::insertCharAndGlyph(int index, SkUnichar unichar, SkGlyp
 
     *fK32.insert(index) = unichar;
     *fV16.insert(index) = glyph;
+    this->addToPage(unichar, glyph);
 
     // if we've changed the first [1] or last [count-2] entry, recompute our slope
     const int count = fK32.size();
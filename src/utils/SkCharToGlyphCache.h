@@ -46,6 +46,12 @@ public:
      */
     void insertCharAndGlyph(int index, SkUnichar, SkGlyphID);
 
+    /**
+     *  Look up the glyphs of count unichars, stopping at the first one which is not cached.
+     *  Returns how many were found, whose glyphIDs are written to glyphs[].
+     */
+    int findGlyphs(const SkUnichar unichars[], int count, SkGlyphID glyphs[]) const;
+
     // helper to pre-seed an entry in the cache
     void addCharAndGlyph(SkUnichar unichar, SkGlyphID glyph) {
         int index = this->findGlyphIndex(unichar);
@@ -57,9 +63,27 @@ public:
     }
 
 private:
+    // The glyphs of cached BMP unichars are also kept in pages of 256, so unichars from the few
+    // blocks a typeface is mostly used for (Latin, punctuation, ...) are found without a search.
+    struct Page {
+        uint32_t  fPresent[256 / 32];
+        SkGlyphID fGlyphs[256];
+    };
+    static constexpr int kMaxPages = 16;
+
+    const Page* findPage(SkUnichar unichar) const {
+        if (unichar < 0 || unichar > 0xFFFF || !fPageIndex[unichar >> 8]) {
+            return nullptr;
+        }
+        return &fPages[fPageIndex[unichar >> 8] - 1];
+    }
+    void addToPage(SkUnichar unichar, SkGlyphID glyph);
+
     SkTDArray<int32_t>   fK32;
     SkTDArray<uint16_t>  fV16;
     double               fDenom;
+    uint8_t              fPageIndex[256];  // 1 + the index in fPages of each page, or 0.
+    SkTDArray<Page>      fPages;
 };
 
 #endif
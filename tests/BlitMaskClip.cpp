@@ -5,15 +5,22 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkMask.h"
 #include "tests/Test.h"
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 class TestBlitter : public SkBlitter {
 public:
@@ -67,3 +74,54 @@ DEF_TEST(BlitAndClip, reporter) {
         delete [] bits;
     }
 }
+
+template <typename Blitter>
+static void check_blit_masks(skiatest::Reporter* reporter, const std::vector<SkMask>& masks,
+                             const SkIRect& clip, SkColor color) {
+    SkPaint paint;
+    paint.setColor(color);
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(40, 40);
+    actual.allocN32Pixels(40, 40);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    Blitter oneByOne(expected.pixmap(), paint);
+    for (const SkMask& mask : masks) {
+        SkIRect r;
+        if (r.intersect(mask.fBounds, clip)) {
+            oneByOne.blitMask(mask, r);
+        }
+    }
+    Blitter batched(actual.pixmap(), paint);
+    batched.blitMasks(masks, clip);
+
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.computeByteSize()));
+}
+
+// Blitting a run of overlapping, clipped A8 masks at once must match blitting them one by one.
+DEF_TEST(BlitMasks_MatchesBlitMask, reporter) {
+    constexpr int kMaskCount = 40;
+    constexpr int kMaskSize = 12;
+    SkRandom rand;
+    uint8_t alphas[kMaskCount][kMaskSize * kMaskSize];
+    for (auto& alpha : alphas) {
+        for (uint8_t& a : alpha) {
+            a = SkToU8(rand.nextU() & 0xFF);
+        }
+    }
+    std::vector<SkMask> masks;
+    for (int i = 0; i < kMaskCount; ++i) {
+        SkIRect bounds = SkIRect::MakeXYWH((int)rand.nextULessThan(40) - 6,
+                                           (int)rand.nextULessThan(40) - 6,
+                                           kMaskSize, kMaskSize);
+        masks.emplace_back(alphas[i], bounds, kMaskSize, SkMask::kA8_Format);
+    }
+    const SkIRect clip = SkIRect::MakeLTRB(2, 3, 38, 36);
+
+    check_blit_masks<SkARGB32_Blitter>(reporter, masks, clip,
+                                       SkColorSetARGB(0x80, 0x20, 0x90, 0xF0));
+    check_blit_masks<SkARGB32_Opaque_Blitter>(reporter, masks, clip, SK_ColorBLUE);
+    check_blit_masks<SkARGB32_Black_Blitter>(reporter, masks, clip, SK_ColorBLACK);
+}
@@ -34,6 +34,7 @@
 #include "src/base/SkFloatBits.h"
 #include "src/base/SkMathPriv.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkBlurNinePatchCache.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/effects/SkEmbossMaskFilter.h"
@@ -586,3 +587,46 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+DEF_SERIAL_TEST(BlurNinePatchCache, reporter) {
+    SkBlurNinePatchCache* cache = SkBlurNinePatchCache::Get();
+    cache->purgeAll();
+    const int hits = cache->hitCount();
+
+    auto surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(400, 400));
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paint;
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4));
+
+    // Round rects of different sizes with the same corners share one mask...
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 20, 100, 100), 10, 10), paint);
+    REPORTER_ASSERT(reporter, cache->count() == 1);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20.5f, 150, 300, 80), 10, 10), paint);
+    REPORTER_ASSERT(reporter, cache->count() == 1);
+    REPORTER_ASSERT(reporter, cache->hitCount() == hits + 1);
+
+    // ... but the mask is blurred for the exact scale, so another scale needs another one.
+    canvas->save();
+    canvas->scale(1.001f, 1.001f);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 250, 200, 100), 10, 10), paint);
+    canvas->restore();
+    REPORTER_ASSERT(reporter, cache->count() == 2);
+    REPORTER_ASSERT(reporter, cache->hitCount() == hits + 1);
+
+    // Different corners need another mask.
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(250, 20, 100, 100), 20, 20), paint);
+    REPORTER_ASSERT(reporter, cache->count() == 3);
+
+    // Lowering the limit evicts masks; round rects are still drawn without them.
+    const size_t limit = cache->setByteLimit(0);
+    REPORTER_ASSERT(reporter, cache->count() == 0 && cache->bytesUsed() == 0);
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 20, 100, 100), 10, 10), paint);
+    REPORTER_ASSERT(reporter, cache->count() == 0);
+    SkPixmap pixmap;
+    SkAssertResult(surface->peekPixels(&pixmap));
+    REPORTER_ASSERT(reporter, SkColorGetA(pixmap.getColor(70, 70)) == 0xFF);
+    REPORTER_ASSERT(reporter, SkColorGetA(pixmap.getColor(20, 70)) > 0);
+    REPORTER_ASSERT(reporter, SkColorGetA(pixmap.getColor(2, 70)) == 0);
+    cache->setByteLimit(limit);
+}
@@ -17,6 +17,7 @@
 #include "include/core/SkPoint.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkSurfaceProps.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
@@ -25,21 +26,26 @@
 #include "include/gpu/GpuTypes.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkAutoMalloc.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkColorFilterPriv.h"
+#include "src/core/SkEffectPriv.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 
 class SkFlattenable;
 struct GrContextOptions;
-struct SkStageRec;
 
 static sk_sp<SkColorFilter> reincarnate_colorfilter(SkFlattenable* obj) {
     SkBinaryWriteBuffer wb({});
@@ -200,3 +206,117 @@ DEF_TEST(ColorFilter_OpaqueShaderPaintAlpha, r) {
     canvas.drawPaint(paint);
     REPORTER_ASSERT(r, bmp.getColor(0, 0) == SK_ColorWHITE);
 }
+
+static int count_stages(const SkColorFilter* filter) {
+    SkSTArenaAlloc<2048> alloc;
+    SkRasterPipeline pipeline(&alloc);
+    SkSurfaceProps props{};
+    SkStageRec rec = {&pipeline, &alloc, kRGBA_F32_SkColorType, nullptr, SkColors::kBlack, props};
+    SkAssertResult(as_CFB(filter)->appendStages(rec, /*shaderIsOpaque=*/false));
+    return pipeline.getNumStages();
+}
+
+// Checks that a composed chain of filters gives the colors of applying them one at a time, and
+// whether it runs in as few stages as its first filter alone.
+static void check_chain(skiatest::Reporter* r,
+                        const sk_sp<SkColorFilter> filters[], int count,
+                        bool expectFolded) {
+    sk_sp<SkColorFilter> chain = filters[0];
+    for (int i = 1; i < count; ++i) {
+        chain = SkColorFilters::Compose(filters[i], std::move(chain));
+    }
+    REPORTER_ASSERT(r, (count_stages(chain.get()) == count_stages(filters[0].get())) ==
+                       expectFolded);
+
+    const SkColor4f colors[] = {
+        {0.2f, 0.4f, 0.6f, 1.0f},
+        {0.9f, 0.1f, 0.5f, 0.5f},
+        {1.0f, 1.0f, 1.0f, 0.25f},
+        {0.0f, 0.0f, 0.0f, 0.0f},
+    };
+    for (const SkColor4f& color : colors) {
+        SkColor4f expected = color;
+        for (int i = 0; i < count; ++i) {
+            expected = filters[i]->filterColor4f(expected, nullptr, nullptr);
+        }
+        const SkPMColor4f actual = chain->filterColor4f(color, nullptr, nullptr).premul();
+        const SkPMColor4f expectedPM = expected.premul();
+        for (int c = 0; c < 4; ++c) {
+            REPORTER_ASSERT(r, std::abs(actual[c] - expectedPM[c]) < 1e-4f,
+                            "channel %d: %g != %g", c, actual[c], expectedPM[c]);
+        }
+    }
+}
+
+DEF_TEST(ColorFilter_FoldedChains, r) {
+    using Clamp = SkColorFilters::Clamp;
+
+    SkColorMatrix saturate;
+    saturate.setSaturation(1.5f);
+    SkColorMatrix scale;
+    scale.setScale(0.5f, 2.0f, 1.0f, 0.5f);
+    SkColorMatrix boost;
+    boost.setScale(1.0f, 1.0f, 1.0f, 2.0f);
+    const SkColorMatrix tint(0, 0, 0, 0, 1.5f,
+                             0, 0, 0, 0, 0.25f,
+                             0, 0, 0, 0, 0.5f,
+                             0, 0, 0, 1, 0);
+
+    {
+        // Unclamped matrices fold into the last one.
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::Matrix(saturate, Clamp::kNo),
+            SkColorFilters::Matrix(scale, Clamp::kNo),
+            SkColorFilters::Matrix(saturate, Clamp::kYes),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/true);
+    }
+    {
+        // Clamping the oversaturated colors in between matters.
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::Matrix(saturate, Clamp::kYes),
+            SkColorFilters::Matrix(scale, Clamp::kYes),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/false);
+    }
+    {
+        // A constant color can be clamped up front.
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::Matrix(tint, Clamp::kYes),
+            SkColorFilters::Matrix(saturate, Clamp::kYes),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/true);
+    }
+    {
+        // Scaling up alpha gets clamped in between.
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::Matrix(boost, Clamp::kNo),
+            SkColorFilters::Matrix(saturate, Clamp::kNo),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/false);
+    }
+
+    uint8_t invert[256], square[256], zero[256], opaque[256];
+    for (int i = 0; i < 256; ++i) {
+        invert[i] = 255 - i;
+        square[i] = SkToU8(i * i / 255);
+        zero[i] = 0;
+        opaque[i] = 255;
+    }
+    {
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::TableARGB(square, invert, square, invert),
+            SkColorFilters::TableARGB(nullptr, square, invert, nullptr),
+            SkColorFilters::TableARGB(nullptr, invert, invert, invert),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/true);
+    }
+    {
+        // Colors are lost where the first table makes them transparent and the second opaque.
+        const sk_sp<SkColorFilter> filters[] = {
+            SkColorFilters::TableARGB(zero, invert, square, invert),
+            SkColorFilters::TableARGB(opaque, square, invert, nullptr),
+        };
+        check_chain(r, filters, std::size(filters), /*expectFolded=*/false);
+    }
+}
@@ -22,10 +22,19 @@
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkScalerContext.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 #include "tools/flags/CommandLineFlags.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#if defined(SK_FONTMGR_FREETYPE_DIRECTORY_AVAILABLE)
+#include "include/ports/SkFontMgr_directory.h"
+#include "src/core/SkOSFile.h"
+#include "src/utils/SkOSPath.h"
+#endif
+
+#include <algorithm>
 #include <cstddef>
+#include <cstdio>
 #include <cstdint>
 #include <initializer_list>
 #include <memory>
@@ -804,3 +813,44 @@ DEF_TEST(FontMgr_MatchCharacter, reporter) {
     fm->matchFamilyStyleCharacter("Blah", SkFontStyle::Normal(), nullptr, 0, 0x1FFFFF);
     fm->matchFamilyStyleCharacter("Blah", SkFontStyle::Normal(), nullptr, 0, -1);
 }
+
+#if defined(SK_FONTMGR_FREETYPE_DIRECTORY_AVAILABLE)
+// A directory font manager built from its index must find the same fonts as one which scans.
+DEF_TEST(FontMgr_CustomDirectoryIndex, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString fontDir = GetResourcePath("fonts");
+    SkString indexPath = SkOSPath::Join(tmpDir.c_str(), "FontMgr_CustomDirectoryIndex.index");
+    remove(indexPath.c_str());
+
+    sk_sp<SkFontMgr> scanned = SkFontMgr_New_Custom_Directory(fontDir.c_str());
+    sk_sp<SkFontMgr> indexing = SkFontMgr_New_Custom_Directory(fontDir.c_str(),
+                                                               indexPath.c_str());
+    REPORTER_ASSERT(reporter, sk_exists(indexPath.c_str()));
+    sk_sp<SkFontMgr> indexed = SkFontMgr_New_Custom_Directory(fontDir.c_str(),
+                                                              indexPath.c_str());
+
+    for (const sk_sp<SkFontMgr>& fm : {indexing, indexed}) {
+        REPORTER_ASSERT(reporter, fm->countFamilies() == scanned->countFamilies());
+        for (int i = 0; i < std::min(fm->countFamilies(), scanned->countFamilies()); ++i) {
+            SkString name, expectedName;
+            fm->getFamilyName(i, &name);
+            scanned->getFamilyName(i, &expectedName);
+            REPORTER_ASSERT(reporter, name == expectedName);
+
+            sk_sp<SkFontStyleSet> set = fm->createStyleSet(i);
+            sk_sp<SkFontStyleSet> expectedSet = scanned->createStyleSet(i);
+            REPORTER_ASSERT(reporter, set->count() == expectedSet->count());
+            for (int j = 0; j < std::min(set->count(), expectedSet->count()); ++j) {
+                SkFontStyle style, expectedStyle;
+                set->getStyle(j, &style, nullptr);
+                expectedSet->getStyle(j, &expectedStyle, nullptr);
+                REPORTER_ASSERT(reporter, style == expectedStyle);
+            }
+        }
+    }
+    remove(indexPath.c_str());
+}
+#endif
@@ -8,6 +8,7 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorSpace.h"
@@ -17,9 +18,11 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkImageFilters.h"
@@ -29,6 +32,7 @@
 #include "include/gpu/ganesh/SkImageGanesh.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/gpu/ganesh/GrTypesPriv.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkSpecialImage.h"
@@ -41,6 +45,7 @@
 #include "src/gpu/ganesh/image/SkSpecialImage_Ganesh.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <cstddef>
 #include <tuple>
@@ -184,6 +189,119 @@ static void test_explicit_purging(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
 }
 
+// Results are reused for regions they cover, or cover all but an edge strip of, when the layer
+// matrix matches up to an integer translation and the source moved with it.
+static void test_overlapping(skiatest::Reporter* reporter, const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    const SkIRect clip = SkIRect::MakeWH(100, 100);
+    const SkIRect srcBounds = SkIRect::MakeWH(kFullSize, kFullSize);
+    SkImageFilterCacheKey key0(0, SkMatrix::I(), clip, SK_InvalidUniqueID, SkIRect::MakeEmpty());
+    SkImageFilterCacheKey key1(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    auto filter0 = make_filter();
+    auto filter1 = make_filter();
+
+    skif::FilterResult found;
+    SkIVector translation;
+    SkIRect validBounds, uncovered;
+    auto getOverlapping = [&](const SkImageFilterCacheKey& key,
+                              const SkIRect& keySrcBounds = SkIRect::MakeEmpty()) {
+        return cache->getOverlapping(key, keySrcBounds, &found, &translation,
+                                     &validBounds, &uncovered);
+    };
+
+    // Nothing is indexed by region until the cache reuses overlapping results.
+    cache->set(key0, filter0.get(), skif::FilterResult(image));
+    REPORTER_ASSERT(reporter, !getOverlapping(key0));
+    cache->setReuseOverlapping(true);
+    REPORTER_ASSERT(reporter, !getOverlapping(key0));
+    cache->set(key0, filter0.get(), skif::FilterResult(image));
+    cache->set(key1, filter1.get(), skif::FilterResult(image), srcBounds);
+
+    // A smaller region is covered.
+    SkImageFilterCacheKey inside(0, SkMatrix::I(), SkIRect::MakeLTRB(10, 10, 50, 50),
+                                 SK_InvalidUniqueID, SkIRect::MakeEmpty());
+    REPORTER_ASSERT(reporter, !cache->get(inside, &found));
+    REPORTER_ASSERT(reporter, getOverlapping(inside));
+    REPORTER_ASSERT(reporter, translation == SkIVector::Make(0, 0));
+    REPORTER_ASSERT(reporter, validBounds == clip);
+    REPORTER_ASSERT(reporter, uncovered.isEmpty());
+
+    // Scrolling up by 8 pixels leaves a strip along the bottom.
+    SkImageFilterCacheKey scrolled(0, SkMatrix::Translate(0, -8), clip,
+                                   SK_InvalidUniqueID, SkIRect::MakeEmpty());
+    REPORTER_ASSERT(reporter, getOverlapping(scrolled));
+    REPORTER_ASSERT(reporter, translation == SkIVector::Make(0, -8));
+    REPORTER_ASSERT(reporter, validBounds == SkIRect::MakeLTRB(0, -8, 100, 92));
+    REPORTER_ASSERT(reporter, uncovered == SkIRect::MakeLTRB(0, 92, 100, 100));
+
+    // Scrolling diagonally would leave two strips, and a fractional scroll resamples.
+    SkImageFilterCacheKey diagonal(0, SkMatrix::Translate(5, -8), clip,
+                                   SK_InvalidUniqueID, SkIRect::MakeEmpty());
+    REPORTER_ASSERT(reporter, !getOverlapping(diagonal));
+    SkImageFilterCacheKey fractional(0, SkMatrix::Translate(0, -7.5f), clip,
+                                     SK_InvalidUniqueID, SkIRect::MakeEmpty());
+    REPORTER_ASSERT(reporter, !getOverlapping(fractional));
+
+    // A result filtered from the source is only reused if the source moved with the layer.
+    SkImageFilterCacheKey scrolledSrc(1, SkMatrix::Translate(0, -8), clip,
+                                      image->uniqueID(), image->subset());
+    REPORTER_ASSERT(reporter, !getOverlapping(scrolledSrc, srcBounds));
+    REPORTER_ASSERT(reporter, getOverlapping(scrolledSrc, srcBounds.makeOffset(0, -8)));
+
+    SkImageFilterCache::Stats stats = cache->stats();
+    REPORTER_ASSERT(reporter, stats.fLookups == 1 && stats.fHits == 0);
+    REPORTER_ASSERT(reporter, stats.fOverlappingHits == 1);
+    REPORTER_ASSERT(reporter, stats.fPartialHits == 2);
+
+    // Purged results are no longer found.
+    cache->purgeByImageFilter(filter0.get());
+    REPORTER_ASSERT(reporter, !getOverlapping(inside));
+    cache->purge();
+    REPORTER_ASSERT(reporter, !getOverlapping(scrolledSrc, srcBounds.makeOffset(0, -8)));
+}
+
+// A result filtered from a source recorded as damaged serves the same request for the source's
+// next version, placed where it was.
+static void test_damaged(skiatest::Reporter* reporter, const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    const SkIRect clip = SkIRect::MakeWH(100, 100);
+    const SkIRect srcBounds = SkIRect::MakeWH(kFullSize, kFullSize);
+    const uint32_t previousID = image->uniqueID();
+    const uint32_t currentID = previousID + 1;
+    SkImageFilterCacheKey previous(0, SkMatrix::I(), clip, previousID, image->subset());
+    SkImageFilterCacheKey current(0, SkMatrix::I(), clip, currentID, image->subset());
+    auto filter = make_filter();
+
+    skif::FilterResult found;
+    SkIRect damage;
+    cache->set(previous, filter.get(), skif::FilterResult(image), srcBounds);
+    REPORTER_ASSERT(reporter, !cache->getDamaged(current, srcBounds, &found, &damage));
+
+    const SkIRect dirty = SkIRect::MakeXYWH(3, 4, 5, 6);
+    cache->setSourceDamage(previousID, currentID, dirty);
+    REPORTER_ASSERT(reporter, !cache->get(current, &found));
+    REPORTER_ASSERT(reporter, cache->getDamaged(current, srcBounds, &found, &damage));
+    REPORTER_ASSERT(reporter, found.image() == image.get());
+    REPORTER_ASSERT(reporter, damage == dirty);
+
+    // The source has to be where it was, and only the same region is patched.
+    REPORTER_ASSERT(reporter,
+                    !cache->getDamaged(current, srcBounds.makeOffset(1, 0), &found, &damage));
+    SkImageFilterCacheKey otherClip(0, SkMatrix::I(), SkIRect::MakeWH(50, 50),
+                                    currentID, image->subset());
+    REPORTER_ASSERT(reporter, !cache->getDamaged(otherClip, srcBounds, &found, &damage));
+    REPORTER_ASSERT(reporter, cache->stats().fDamagedHits == 1);
+
+    // Purging forgets both the results and the damage.
+    cache->purge();
+    cache->set(previous, filter.get(), skif::FilterResult(image), srcBounds);
+    REPORTER_ASSERT(reporter, !cache->getDamaged(current, srcBounds, &found, &damage));
+}
+
 DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     SkBitmap srcBM = create_bm();
 
@@ -200,8 +318,104 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_overlapping(reporter, fullImg);
+    test_damaged(reporter, fullImg);
+}
+
+// Drawing a scrolled layer reuses the result from before the scroll and filters only the strip
+// scrolled into view, and draws the same pixels as filtering everything again.
+DEF_SERIAL_TEST(ImageFilterCache_ScrollingLayer, reporter) {
+    SkRandom random;
+    sk_sp<SkImage> content = ToolUtils::create_random_premul_bitmap(64, 256, &random).asImage();
+
+    // Dilation reads only nearby pixels, so filtering a strip gives the same pixels as filtering
+    // the whole region.
+    auto makeFilter = [&]() {
+        return SkImageFilters::Dilate(2, 3, SkImageFilters::Image(content, SkFilterMode::kNearest));
+    };
+    auto draw = [&](const sk_sp<SkImageFilter>& filter, int scroll) {
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bm);
+        canvas.translate(0, -scroll);
+        SkPaint paint;
+        paint.setImageFilter(filter);
+        canvas.drawPaint(paint);
+        return bm;
+    };
+
+    sk_sp<SkImageFilterCache> cache = SkImageFilterCache::Get();
+    cache->purge();
+    cache->setReuseOverlapping(true);
+    sk_sp<SkImageFilter> filter = makeFilter();
+    draw(filter, 0);
+    for (int scroll : {5, 12, 40}) {
+        const SkImageFilterCache::Stats before = cache->stats();
+        SkBitmap reused = draw(filter, scroll);
+        REPORTER_ASSERT(reporter, cache->stats().fPartialHits > before.fPartialHits,
+                        "scroll %d", scroll);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(reused, draw(makeFilter(), scroll)),
+                        "scroll %d", scroll);
+    }
+    cache->setReuseOverlapping(false);
+    cache->purge();
 }
 
+// Drawing the next frame of an image recorded as damaged patches the previous frame's result,
+// and draws the same pixels as filtering the whole frame again.
+DEF_SERIAL_TEST(ImageFilterCache_DamagedSource, reporter) {
+    SkRandom random;
+    SkBitmap frame = ToolUtils::create_random_premul_bitmap(64, 64, &random);
+
+    auto makeFilter = [](int index) -> sk_sp<SkImageFilter> {
+        switch (index) {
+            case 0:
+                return SkImageFilters::Blur(2, 3, nullptr);
+            case 1:
+                return SkImageFilters::Offset(5, -3, SkImageFilters::Dilate(2, 1, nullptr));
+            default:
+                return SkImageFilters::Compose(
+                        SkImageFilters::ColorFilter(
+                                SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kSrcIn), nullptr),
+                        SkImageFilters::Erode(1, 2, nullptr));
+        }
+    };
+    auto draw = [&](const sk_sp<SkImageFilter>& filter, const sk_sp<SkImage>& image) {
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bm);
+        SkPaint paint;
+        paint.setImageFilter(filter);
+        canvas.drawImage(image, 0, 0, SkSamplingOptions(), &paint);
+        return bm;
+    };
+
+    sk_sp<SkImageFilterCache> cache = SkImageFilterCache::Get();
+    cache->purge();
+    for (int index = 0; index < 3; ++index) {
+        sk_sp<SkImageFilter> filter = makeFilter(index);
+        sk_sp<SkImage> previous = frame.asImage();
+        draw(filter, previous);
+        for (const SkIRect& damage : {SkIRect::MakeXYWH(20, 30, 4, 3),
+                                      SkIRect::MakeXYWH(0, 60, 10, 4)}) {
+            ToolUtils::fill_random_premul(&frame, damage, &random);
+            sk_sp<SkImage> current = frame.asImage();
+            SkGraphics::SetImageFilterSourceDamage(previous->uniqueID(), current->uniqueID(),
+                                                   damage);
+            const SkImageFilterCache::Stats before = cache->stats();
+            SkBitmap patched = draw(filter, current);
+            REPORTER_ASSERT(reporter, cache->stats().fDamagedHits > before.fDamagedHits,
+                            "filter %d", index);
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(patched,
+                                                              draw(makeFilter(index), current)),
+                            "filter %d", index);
+            previous = current;
+        }
+    }
+    cache->purge();
+}
 
 // Shared test code for both the raster and gpu-backed image cases
 static void test_image_backed(skiatest::Reporter* reporter,
@@ -12,10 +12,13 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
@@ -43,7 +46,9 @@
 #include "include/gpu/GpuTypes.h"
 #include "include/gpu/GrTypes.h"
 #include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImageFilterTypes.h"
@@ -79,10 +84,13 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <utility>
 #include <limits>
+#include <vector>
 
 using namespace skia_private;
 
@@ -746,6 +754,72 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ImageFilterZeroBlurSigma_Gpu,
     test_zero_blur_sigma(reporter, ctxInfo.directContext());
 }
 
+// Returns whether 'draw' produces the same pixels on the calling thread (given a null executor) as
+// when given an executor to spread its work over.
+static bool serial_matches_parallel(const std::function<SkBitmap(SkExecutor*)>& draw) {
+    // Other tests may be filtering meanwhile, so the executor is never destroyed.
+    static SkExecutor* executor = SkExecutor::MakeFIFOThreadPool(3).release();
+    return ToolUtils::equal_pixels(draw(nullptr), draw(executor));
+}
+
+// Tests that blurs split into bands on an executor match the blurs done on the calling thread.
+DEF_TEST(ImageFilterBlurRasterExecutor, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(301, 203, &random);
+    sk_sp<SkImage> image = source.asImage();
+
+    const SkSize sigmas[] = {{12, 7}, {20, 0}, {0, 20}, {60, 45}};
+    for (SkSize sigma : sigmas) {
+        auto draw = [&](SkExecutor* blurExecutor) {
+            SkGraphics::SetRasterBlurExecutor(blurExecutor);
+            SkBitmap result;
+            result.allocN32Pixels(source.width(), source.height());
+            SkCanvas canvas(result);
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Blur(sigma.width(), sigma.height(), nullptr));
+            canvas.drawImage(image, 0, 0, SkSamplingOptions(), &paint);
+            SkGraphics::SetRasterBlurExecutor(nullptr);
+            return result;
+        };
+        REPORTER_ASSERT(reporter, serial_matches_parallel(draw),
+                        "sigma %g %g", sigma.width(), sigma.height());
+    }
+}
+
+DEF_TEST(ImageFilterInputsRasterExecutor, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(151, 103, &random);
+    sk_sp<SkImage> image = source.asImage();
+
+    // A small byte limit makes the branches run in several batches.
+    const size_t byteLimits[] = {64 * 1024 * 1024, 100 * 1024};
+    for (size_t byteLimit : byteLimits) {
+        auto draw = [&](SkExecutor* filterExecutor) {
+            // New filters each time, so nothing is found in the image filter cache.
+            sk_sp<SkImageFilter> shared = SkImageFilters::Blur(3, 3, nullptr);
+            sk_sp<SkImageFilter> inputs[] = {
+                SkImageFilters::Blur(6, 2, nullptr),
+                SkImageFilters::Offset(7, -5, shared),
+                nullptr,
+                SkImageFilters::Dilate(2, 4, SkImageFilters::Blur(1, 5, nullptr)),
+                shared,
+                SkImageFilters::Blend(SkBlendMode::kMultiply, shared,
+                                      SkImageFilters::Erode(3, 1, nullptr)),
+            };
+            SkGraphics::SetImageFilterExecutor(filterExecutor, byteLimit);
+            SkBitmap result;
+            result.allocN32Pixels(source.width(), source.height());
+            SkCanvas canvas(result);
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::Merge(inputs, std::size(inputs)));
+            canvas.drawImage(image, 0, 0, SkSamplingOptions(), &paint);
+            SkGraphics::SetImageFilterExecutor(nullptr);
+            return result;
+        };
+        REPORTER_ASSERT(reporter, serial_matches_parallel(draw), "byte limit %zu", byteLimit);
+    }
+}
+
 // Tests that, even when an upstream filter has returned null (due to failure or clipping), a
 // downstream filter that affects transparent black still does so even with a nullptr input.
 static void test_fail_affects_transparent_black(skiatest::Reporter* reporter,
@@ -1222,6 +1296,344 @@ DEF_TEST(ImageFilterMatrixConvolutionBorder, reporter) {
     canvas.restore();
 }
 
+// The raster tests below draw an image of random premultiplied colors, mostly at this origin.
+static constexpr SkIPoint kImageOrigin = {4, 5};
+
+// The raster backend convolves the pixels directly, splitting separable kernels into two passes.
+// Compare that against evaluating the convolution the way the shader does.
+DEF_TEST(ImageFilterMatrixConvolutionRaster, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(37, 29, &random);
+    sk_sp<SkImage> image = source.asImage();
+
+    struct Kernel {
+        SkISize size;
+        std::vector<float> coeffs;
+        SkIPoint offset;
+        float gain, bias;
+    };
+    const float binomial[] = {1, 4, 6, 4, 1};
+    Kernel separable{{5, 5}, {}, {2, 1}, 1 / 256.f, 0};
+    for (float y : binomial) {
+        for (float x : binomial) {
+            separable.coeffs.push_back(x * y);
+        }
+    }
+    Kernel general{{4, 3}, {}, {3, 0}, 0.4f, 20};
+    for (int i = 0; i < 12; ++i) {
+        general.coeffs.push_back(random.nextRangeF(-1, 2));
+    }
+    const Kernel row{{7, 1}, {1, 1, 1, 1, 1, 1, 1}, {3, 0}, 1 / 7.f, 0};
+
+    auto sample = [&](int x, int y) {
+        x -= kImageOrigin.fX;
+        y -= kImageOrigin.fY;
+        if (x < 0 || y < 0 || x >= source.width() || y >= source.height()) {
+            return SkColor4f{0, 0, 0, 0};
+        }
+        const uint32_t c = *source.getAddr32(x, y);
+        return SkColor4f{((c >>  0) & 0xff) / 255.f, ((c >>  8) & 0xff) / 255.f,
+                         ((c >> 16) & 0xff) / 255.f, ((c >> 24) & 0xff) / 255.f};
+    };
+
+    const Kernel* kernels[] = {&separable, &general, &row};
+    for (const Kernel* kernel : kernels) {
+        for (bool convolveAlpha : {true, false}) {
+            SkBitmap result;
+            result.allocN32Pixels(48, 40);
+            result.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(result);
+            SkPaint paint;
+            paint.setImageFilter(SkImageFilters::MatrixConvolution(
+                    kernel->size, kernel->coeffs.data(), kernel->gain, kernel->bias,
+                    kernel->offset, SkTileMode::kDecal, convolveAlpha, nullptr));
+            canvas.drawImage(image, kImageOrigin.fX, kImageOrigin.fY, SkSamplingOptions(),
+                             &paint);
+
+            int maxError = 0;
+            for (int y = 0; y < result.height(); ++y) {
+                for (int x = 0; x < result.width(); ++x) {
+                    float sum[4] = {0, 0, 0, 0};
+                    for (int ky = 0; ky < kernel->size.height(); ++ky) {
+                        for (int kx = 0; kx < kernel->size.width(); ++kx) {
+                            SkColor4f c = sample(x + kx - kernel->offset.fX,
+                                                 y + ky - kernel->offset.fY);
+                            if (!convolveAlpha) {
+                                c = c.fA > 0 ? SkColor4f{c.fR / c.fA, c.fG / c.fA, c.fB / c.fA,
+                                                         c.fA}
+                                             : SkColor4f{0, 0, 0, 0};
+                            }
+                            const float k = kernel->coeffs[ky * kernel->size.width() + kx];
+                            const float channels[4] = {c.fR, c.fG, c.fB, c.fA};
+                            for (int i = 0; i < 4; ++i) {
+                                sum[i] += k * channels[i];
+                            }
+                        }
+                    }
+                    float color[4];
+                    for (int i = 0; i < 4; ++i) {
+                        color[i] = sum[i] * kernel->gain + kernel->bias / 255.f;
+                    }
+                    if (!convolveAlpha) {
+                        const float a = sample(x, y).fA;
+                        for (int i = 0; i < 3; ++i) {
+                            color[i] *= a;
+                        }
+                        color[3] = a;
+                    } else {
+                        color[3] = SkTPin(color[3], 0.f, 1.f);
+                    }
+                    const uint32_t actual = *result.getAddr32(x, y);
+                    for (int i = 0; i < 4; ++i) {
+                        const int expected = SkScalarRoundToInt(
+                                255 * SkTPin(color[i], 0.f, color[3]));
+                        const int channel = (actual >> (8 * i)) & 0xff;
+                        maxError = std::max(maxError, std::abs(expected - channel));
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, maxError <= 1, "kernel %dx%d convolveAlpha %d error %d",
+                            kernel->size.width(), kernel->size.height(), convolveAlpha, maxError);
+        }
+    }
+}
+
+// The raster backend dilates and erodes with running extrema, in three operations per pixel for
+// any radius. Compare that against taking the extremum of each window directly.
+DEF_TEST(ImageFilterMorphologyRaster, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(45, 31, &random);
+    sk_sp<SkImage> image = source.asImage();
+    static constexpr SkIPoint kMorphologyOrigin = {30, 20};
+
+    auto sample = [&](int x, int y, int channel) -> int {
+        x -= kMorphologyOrigin.fX;
+        y -= kMorphologyOrigin.fY;
+        if (x < 0 || y < 0 || x >= source.width() || y >= source.height()) {
+            return 0;
+        }
+        return (*source.getAddr32(x, y) >> (8 * channel)) & 0xff;
+    };
+
+    const SkISize radii[] = {{1, 0}, {0, 2}, {3, 5}, {20, 7}, {40, 40}};
+    for (SkISize radius : radii) {
+        for (bool dilate : {true, false}) {
+            SkBitmap result;
+            result.allocN32Pixels(105, 71);
+            result.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(result);
+            SkPaint paint;
+            paint.setImageFilter(
+                    dilate ? SkImageFilters::Dilate(radius.width(), radius.height(), nullptr)
+                           : SkImageFilters::Erode(radius.width(), radius.height(), nullptr));
+            canvas.drawImage(image, kMorphologyOrigin.fX, kMorphologyOrigin.fY, SkSamplingOptions(),
+                             &paint);
+
+            // The extremum over each window's rows, then over those for each window.
+            auto extremum = [dilate](int a, int b) { return dilate ? std::max(a, b)
+                                                                   : std::min(a, b); };
+            const int rows = result.height() + 2 * radius.height();
+            std::vector<int> rowExtrema(rows * result.width() * 4);
+            for (int r = 0; r < rows; ++r) {
+                for (int x = 0; x < result.width(); ++x) {
+                    for (int c = 0; c < 4; ++c) {
+                        int v = sample(x - radius.width(), r - radius.height(), c);
+                        for (int dx = -radius.width() + 1; dx <= radius.width(); ++dx) {
+                            v = extremum(v, sample(x + dx, r - radius.height(), c));
+                        }
+                        rowExtrema[(r * result.width() + x) * 4 + c] = v;
+                    }
+                }
+            }
+            int mismatches = 0;
+            for (int y = 0; y < result.height(); ++y) {
+                for (int x = 0; x < result.width(); ++x) {
+                    for (int c = 0; c < 4; ++c) {
+                        int expected = rowExtrema[(y * result.width() + x) * 4 + c];
+                        for (int r = y + 1; r <= y + 2 * radius.height(); ++r) {
+                            expected = extremum(expected,
+                                                rowExtrema[(r * result.width() + x) * 4 + c]);
+                        }
+                        if (expected != (int)((*result.getAddr32(x, y) >> (8 * c)) & 0xff)) {
+                            ++mismatches;
+                        }
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "%s %dx%d: %d mismatches",
+                            dilate ? "dilate" : "erode", radius.width(), radius.height(),
+                            mismatches);
+        }
+    }
+}
+
+// The raster backend computes a normal map for each row and then the lighting equation, rather than
+// evaluating the shaders. Compare that against the equations the shaders evaluate, on the pixels
+// whose Sobel kernel stays within the image.
+DEF_TEST(ImageFilterLightingRaster, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(37, 29, &random);
+    sk_sp<SkImage> image = source.asImage();
+    auto alphaAt = [&](int x, int y) {
+        return SkGetPackedA32(*source.getAddr32(x - kImageOrigin.fX, y - kImageOrigin.fY)) /
+               255.f;
+    };
+
+    static constexpr float kDepth = 2.f;
+    static constexpr float kK = 0.8f;
+    static constexpr float kShininess = 6.f;
+    static constexpr SkColor kLightColor = 0xFFFFC080;
+    const SkPoint3 location = {30, 12, 25};
+    const SkPoint3 target = {18, 20, 0};
+    const SkPoint3 direction = {-1, 2, 3};
+    static constexpr float kFalloff = 2.f;
+    static constexpr float kCutoffAngle = 40.f;
+
+    enum class LightType { kDistant, kPoint, kSpot };
+    for (LightType lightType : {LightType::kDistant, LightType::kPoint, LightType::kSpot}) {
+        for (bool specular : {false, true}) {
+            sk_sp<SkImageFilter> filter;
+            switch (lightType) {
+                case LightType::kDistant:
+                    filter = specular ? SkImageFilters::DistantLitSpecular(
+                                                direction, kLightColor, kDepth, kK, kShininess,
+                                                nullptr)
+                                      : SkImageFilters::DistantLitDiffuse(
+                                                direction, kLightColor, kDepth, kK, nullptr);
+                    break;
+                case LightType::kPoint:
+                    filter = specular ? SkImageFilters::PointLitSpecular(
+                                                location, kLightColor, kDepth, kK, kShininess,
+                                                nullptr)
+                                      : SkImageFilters::PointLitDiffuse(
+                                                location, kLightColor, kDepth, kK, nullptr);
+                    break;
+                case LightType::kSpot:
+                    filter = specular ? SkImageFilters::SpotLitSpecular(
+                                                location, target, kFalloff, kCutoffAngle,
+                                                kLightColor, kDepth, kK, kShininess, nullptr)
+                                      : SkImageFilters::SpotLitDiffuse(
+                                                location, target, kFalloff, kCutoffAngle,
+                                                kLightColor, kDepth, kK, nullptr);
+                    break;
+            }
+
+            SkBitmap result;
+            result.allocN32Pixels(48, 40);
+            result.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(result);
+            SkPaint paint;
+            paint.setImageFilter(std::move(filter));
+            canvas.drawImage(image, kImageOrigin.fX, kImageOrigin.fY, SkSamplingOptions(),
+                             &paint);
+
+            const SkPoint3 spotDir = [&] {
+                SkPoint3 d = target - location;
+                d.normalize();
+                return d;
+            }();
+            const float cosCutoff = std::cos(SkDegreesToRadians(kCutoffAngle));
+            int maxError = 0;
+            for (int y = kImageOrigin.fY + 1; y < kImageOrigin.fY + source.height() - 1; ++y) {
+                for (int x = kImageOrigin.fX + 1; x < kImageOrigin.fX + source.width() - 1; ++x) {
+                    auto column = [&](int cx) {
+                        return alphaAt(cx, y - 1) + 2 * alphaAt(cx, y) + alphaAt(cx, y + 1);
+                    };
+                    auto row = [&](int cy) {
+                        return alphaAt(x - 1, cy) + 2 * alphaAt(x, cy) + alphaAt(x + 1, cy);
+                    };
+                    SkPoint3 normal = {-kDepth * 0.25f * (column(x + 1) - column(x - 1)),
+                                       -kDepth * 0.25f * (row(y + 1) - row(y - 1)),
+                                       1};
+                    normal.normalize();
+
+                    SkPoint3 toLight = direction;
+                    if (lightType != LightType::kDistant) {
+                        toLight = location - SkPoint3{x + 0.5f, y + 0.5f, kDepth * alphaAt(x, y)};
+                    }
+                    toLight.normalize();
+
+                    float scale = 1;
+                    if (lightType == LightType::kSpot) {
+                        const float cosAngle = -toLight.dot(spotDir);
+                        scale = cosAngle < cosCutoff ? 0 : std::pow(cosAngle, kFalloff);
+                        if (cosAngle >= cosCutoff && cosAngle < cosCutoff + 0.016f) {
+                            scale *= (cosAngle - cosCutoff) / 0.016f;
+                        }
+                    }
+                    float coeff;
+                    if (specular) {
+                        SkPoint3 halfDir = toLight + SkPoint3{0, 0, 1};
+                        halfDir.normalize();
+                        coeff = std::pow(std::max(normal.dot(halfDir), 0.f), kShininess);
+                    } else {
+                        coeff = normal.dot(toLight);
+                    }
+                    const float color[3] = {
+                            SkTPin(coeff * scale * kK * SkColorGetR(kLightColor) / 255, 0.f, 1.f),
+                            SkTPin(coeff * scale * kK * SkColorGetG(kLightColor) / 255, 0.f, 1.f),
+                            SkTPin(coeff * scale * kK * SkColorGetB(kLightColor) / 255, 0.f, 1.f)};
+                    const float alpha = specular ? std::max({color[0], color[1], color[2]}) : 1;
+
+                    const SkPMColor actual = *result.getAddr32(x, y);
+                    const int channels[4] = {(int)SkGetPackedR32(actual),
+                                             (int)SkGetPackedG32(actual),
+                                             (int)SkGetPackedB32(actual),
+                                             (int)SkGetPackedA32(actual)};
+                    const float expected[4] = {color[0], color[1], color[2], alpha};
+                    for (int i = 0; i < 4; ++i) {
+                        maxError = std::max(maxError,
+                                            std::abs(SkScalarRoundToInt(255 * expected[i]) -
+                                                     channels[i]));
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, maxError <= 1, "light %d specular %d error %d",
+                            (int)lightType, specular, maxError);
+        }
+    }
+}
+
+// The raster backend gathers the displaced color pixels directly. Compare that against sampling
+// the color image at the displaced pixel centers.
+DEF_TEST(ImageFilterDisplacementRaster, reporter) {
+    SkRandom random;
+    SkBitmap source = ToolUtils::create_random_premul_bitmap(37, 29, &random);
+    // An opaque displacement map keeps the displaced centers away from pixel edges, so rounding
+    // can't pick a different pixel.
+    SkBitmap displacement = ToolUtils::create_random_premul_bitmap(48, 40, &random,
+                                                                   /*opaque=*/true);
+    static constexpr float kScale = 12.f;
+
+    SkBitmap result;
+    result.allocN32Pixels(48, 40);
+    result.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(result);
+    SkPaint paint;
+    paint.setImageFilter(SkImageFilters::DisplacementMap(
+            SkColorChannel::kR, SkColorChannel::kG, kScale,
+            SkImageFilters::Image(displacement.asImage(), SkFilterMode::kNearest), nullptr));
+    canvas.drawImage(source.asImage(), kImageOrigin.fX, kImageOrigin.fY, SkSamplingOptions(),
+                     &paint);
+
+    int mismatches = 0;
+    for (int y = 0; y < result.height(); ++y) {
+        for (int x = 0; x < result.width(); ++x) {
+            const SkPMColor displ = *displacement.getAddr32(x, y);
+            const float dx = kScale * (SkGetPackedR32(displ) / 255.f - 0.5f);
+            const float dy = kScale * (SkGetPackedG32(displ) / 255.f - 0.5f);
+            const int sx = (int)std::floor(x + 0.5f + dx) - kImageOrigin.fX;
+            const int sy = (int)std::floor(y + 0.5f + dy) - kImageOrigin.fY;
+            const bool inside = sx >= 0 && sx < source.width() && sy >= 0 && sy < source.height();
+            const SkPMColor expected = inside ? *source.getAddr32(sx, sy) : 0;
+            if (expected != *result.getAddr32(x, y)) {
+                ++mismatches;
+            }
+        }
+    }
+    REPORTER_ASSERT(reporter, mismatches == 0, "%d mismatches", mismatches);
+}
+
 static void test_big_kernel(skiatest::Reporter* reporter, GrRecordingContext* rContext) {
     // Check that a kernel that is too big for the GPU still works
     SkScalar identityKernel[49] = {
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkFont.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "src/core/SkMSDFGlyphCache.h"
+#include "src/core/SkMultiDistanceFieldGen.h"
+#include "tests/Test.h"
+#include "tools/fonts/FontToolUtils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+extern bool gSkUseMSDFText;
+
+static int median(const uint8_t* p) {
+    return std::max(std::min(p[0], p[1]), std::min(std::max(p[0], p[1]), p[2]));
+}
+
+DEF_TEST(MultiDistanceField_Square, reporter) {
+    const SkPath square = SkPath::Rect(SkRect::MakeWH(16, 16));
+    const SkIRect bounds = SkIRect::MakeLTRB(-4, -4, 20, 20);
+    const int w = bounds.width();
+    std::vector<uint8_t> field(w * bounds.height() * 4);
+    REPORTER_ASSERT(reporter, SkGenerateMultiDistanceField(field.data(), w * 4, square, bounds, 4));
+    auto pixel = [&](int x, int y) { return &field[(y * w + x) * 4]; };
+
+    // The center is further inside than the range, the corner of the field further outside.
+    REPORTER_ASSERT(reporter, median(pixel(12, 12)) == 255);
+    REPORTER_ASSERT(reporter, median(pixel(0, 0)) == 0);
+
+    // Half a pixel diagonally outside the corner, at (-0.5, -0.5). The median measures the
+    // distance to the sides' extensions, 0.5, so the corner stays square; the true distance in
+    // alpha is sqrt(0.5).
+    const uint8_t* corner = pixel(3, 3);
+    REPORTER_ASSERT(reporter, std::abs(median(corner) - 112) <= 1, "%d", median(corner));
+    REPORTER_ASSERT(reporter, std::abs(corner[3] - 105) <= 1, "%d", corner[3]);
+}
+
+// A glyph magnified from its field should match the glyph rasterized from its path.
+DEF_TEST(MultiDistanceField_GlyphCache, reporter) {
+    SkFont font = ToolUtils::DefaultPortableFont();
+    font.setHinting(SkFontHinting::kNone);
+    const SkGlyphID glyph = font.unicharToGlyph('H');
+    SkMSDFGlyphCache cache;
+
+    for (float size : {24.f, 128.f}) {
+        font.setSize(size);
+        const SkPoint origin = {10.25f, size};
+        const SkIRect bounds = cache.glyphBounds(font, glyph, origin);
+        REPORTER_ASSERT(reporter, !bounds.isEmpty());
+        if (bounds.isEmpty()) {
+            return;
+        }
+
+        SkBitmap msdf, expected;
+        msdf.allocPixels(SkImageInfo::MakeA8(bounds.width(), bounds.height()));
+        expected.allocPixels(SkImageInfo::MakeA8(bounds.width(), bounds.height()));
+        msdf.eraseColor(SK_ColorTRANSPARENT);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        REPORTER_ASSERT(reporter, cache.drawGlyph(font, glyph, origin, msdf.pixmap(),
+                                                  bounds.topLeft()));
+
+        SkPath path;
+        font.getPath(glyph, &path);
+        SkCanvas canvas(expected);
+        canvas.translate(origin.fX - bounds.fLeft, origin.fY - bounds.fTop);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas.drawPath(path, paint);
+
+        int wrong = 0;
+        for (int y = 0; y < bounds.height(); ++y) {
+            for (int x = 0; x < bounds.width(); ++x) {
+                if (std::abs(*msdf.getAddr8(x, y) - *expected.getAddr8(x, y)) > 0x80) {
+                    wrong++;
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, wrong * 50 <= bounds.width() * bounds.height(),
+                        "size %g: %d of %d pixels differ", size, wrong,
+                        bounds.width() * bounds.height());
+    }
+    // Both sizes were drawn from the one field.
+    REPORTER_ASSERT(reporter, cache.count() == 1);
+}
+
+// With gSkUseMSDFText, large text drawn to a raster canvas comes from the fields, and should still
+// match text drawn through the strikes.
+DEF_SERIAL_TEST(MultiDistanceField_DrawText, reporter) {
+    SkFont font = ToolUtils::DefaultPortableFont();
+    font.setHinting(SkFontHinting::kNone);
+    font.setSize(64);
+    const char* text = "Hello";
+
+    auto draw = [&](bool useFields, float scale) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(400, 200);
+        bitmap.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bitmap);
+        canvas.scale(scale, scale);
+        const bool wasUsingFields = gSkUseMSDFText;
+        gSkUseMSDFText = useFields;
+        canvas.drawString(text, 10.5f, 70, font, SkPaint());
+        gSkUseMSDFText = wasUsingFields;
+        return bitmap;
+    };
+
+    for (float scale : {1.f, 2.5f}) {
+        const SkBitmap msdf = draw(true, scale), expected = draw(false, scale);
+        int wrong = 0, inked = 0;
+        for (int y = 0; y < msdf.height(); ++y) {
+            for (int x = 0; x < msdf.width(); ++x) {
+                const int a = SkColorGetR(msdf.getColor(x, y)),
+                          b = SkColorGetR(expected.getColor(x, y));
+                inked += b < 0x80;
+                wrong += std::abs(a - b) > 0x80;
+            }
+        }
+        REPORTER_ASSERT(reporter, inked > 0);
+        REPORTER_ASSERT(reporter, wrong * 50 <= inked,
+                        "scale %g: %d of %d inked pixels differ", scale, wrong, inked);
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkDocument.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypes.h"
+#include "include/docs/SkPDFDocument.h"
+#include "src/core/SkAutoPixmapStorage.h"
+#include "tests/Test.h"
+#include "tools/DecodeUtils.h"
+#include "tools/Resources.h"
+
+#include <algorithm>
+#include <cstring>
+
+static bool contains(const SkData* haystack, const void* needle, size_t size) {
+    if (size > haystack->size()) {
+        return false;
+    }
+    for (size_t i = 0; i <= haystack->size() - size; ++i) {
+        if (0 == memcmp(haystack->bytes() + i, needle, size)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool contains(const SkData* haystack, const char* needle) {
+    return contains(haystack, needle, strlen(needle));
+}
+
+static sk_sp<SkData> make_pdf(sk_sp<SkImage> image, const SkPDF::Metadata& metadata) {
+    SkDynamicMemoryWStream pdf;
+    auto document = SkPDF::MakeDocument(&pdf, metadata);
+    SkCanvas* canvas = document->beginPage(image->width(), image->height());
+    canvas->drawImage(image, 0, 0);
+    document->endPage();
+    document->close();
+    return pdf.detachAsData();
+}
+
+static sk_sp<SkImage> decoded(sk_sp<SkImage> image) {
+    SkAutoPixmapStorage pixmap;
+    pixmap.alloc(SkImageInfo::MakeN32Premul(image->dimensions()));
+    if (!image->readPixels(nullptr, pixmap, 0, 0)) {
+        return nullptr;
+    }
+    return SkImages::RasterFromPixmapCopy(pixmap);
+}
+
+// Returns the first IDAT chunk's payload of a PNG file.
+static sk_sp<SkData> first_idat(const SkData* png) {
+    const uint8_t* ptr = png->bytes() + 8;
+    const uint8_t* end = png->bytes() + png->size();
+    while (end - ptr >= 12) {
+        uint32_t length = (uint32_t)ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3];
+        if (0 == memcmp(ptr + 4, "IDAT", 4)) {
+            return SkData::MakeWithCopy(ptr + 8, std::min<size_t>(length, end - ptr - 8));
+        }
+        ptr += 12 + (size_t)length;
+    }
+    return nullptr;
+}
+
+/**
+ *  Test that 8-bit RGB PNG files have their compressed image data embedded directly into the
+ *  PDF (without decoding and recompressing) when lossless encoding is requested.
+ */
+DEF_TEST(SkPDF_PngEmbedTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_PngEmbedTest, r);
+    sk_sp<SkData> mandrillData = GetResourceAsData("images/mandrill_512.png");
+    if (!mandrillData) {
+        INFOF(r, "\nCould not load images/mandrill_512.png\n");
+        return;
+    }
+    sk_sp<SkData> idat = first_idat(mandrillData.get());
+    REPORTER_ASSERT(r, idat);
+    if (!idat) {
+        return;
+    }
+
+    sk_sp<SkImage> image = SkImages::DeferredFromEncodedData(mandrillData);
+    REPORTER_ASSERT(r, image);
+    sk_sp<SkData> pdfData = make_pdf(image, SkPDF::Metadata());
+    #ifndef SK_PDF_BASE85_BINARY
+    REPORTER_ASSERT(r, contains(pdfData.get(), idat->data(), idat->size()));
+    #endif
+    REPORTER_ASSERT(r, contains(pdfData.get(), "/Predictor 15"));
+
+    // Lossy encoding was asked for, so the image data should not be passed through.
+    SkPDF::Metadata lossy;
+    lossy.fEncodingQuality = 50;
+    pdfData = make_pdf(image, lossy);
+    REPORTER_ASSERT(r, !contains(pdfData.get(), idat->data(), idat->size()));
+}
+
+DEF_TEST(SkPDF_PngPredictorTest, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_PngPredictorTest, r);
+    sk_sp<SkImage> image = decoded(ToolUtils::GetResourceAsImage("images/mandrill_512.png"));
+    if (!image) {
+        INFOF(r, "\nCould not load images/mandrill_512.png\n");
+        return;
+    }
+
+    sk_sp<SkData> pdfData = make_pdf(image, SkPDF::Metadata());
+    REPORTER_ASSERT(r, contains(pdfData.get(), "/Predictor 15"));
+    REPORTER_ASSERT(r, !contains(pdfData.get(), "/DCTDecode"));
+
+    // Uncompressed streams can not use a predictor.
+    SkPDF::Metadata uncompressed;
+    uncompressed.fCompressionLevel = SkPDF::Metadata::CompressionLevel::None;
+    pdfData = make_pdf(image, uncompressed);
+    REPORTER_ASSERT(r, !contains(pdfData.get(), "/Predictor"));
+
+    // The mandrill is photographic, so may be encoded as a JPEG if allowed.
+    SkPDF::Metadata photographic;
+    photographic.fPhotographicEncodingQuality = 75;
+    pdfData = make_pdf(image, photographic);
+    REPORTER_ASSERT(r, contains(pdfData.get(), "/DCTDecode"));
+}
@@ -19,15 +19,20 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/private/base/SkDebug.h"
@@ -469,6 +474,110 @@ DEF_TEST(SkPDF_Clusterator, reporter) {
     }
 }
 
+static int count_occurrences(const SkData* haystack, const char* needle) {
+    size_t size = strlen(needle);
+    int count = 0;
+    for (size_t i = 0; i + size <= haystack->size(); ++i) {
+        if (0 == memcmp(haystack->bytes() + i, needle, size)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// The same gradient drawn under different transforms needs a pattern for each transform, but
+// they should all share a single shading.
+DEF_TEST(SkPDF_GradientShadingShared, reporter) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_GradientShadingShared, reporter);
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream);
+    SkCanvas* canvas = doc->beginPage(500, 500);
+    const SkPoint pts[2] = {{0, 0}, {40, 40}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, std::size(colors),
+                                                 SkTileMode::kClamp));
+    for (int i = 0; i < 10; ++i) {
+        canvas->save();
+        canvas->translate(45.0f * i, 45.0f * i);
+        canvas->drawRect(SkRect::MakeWH(40, 40), paint);
+        canvas->restore();
+    }
+    doc->close();
+    sk_sp<SkData> pdf = stream.detachAsData();
+    REPORTER_ASSERT(reporter, count_occurrences(pdf.get(), "/PatternType 2") == 10);
+    REPORTER_ASSERT(reporter, count_occurrences(pdf.get(), "/ShadingType") == 1);
+}
+
+// Identical rasterized fallback shaders should share their images.
+DEF_TEST(SkPDF_FallbackShaderImageShared, reporter) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_FallbackShaderImageShared, reporter);
+    auto countImages = [](int pageCount) {
+        SkDynamicMemoryWStream stream;
+        auto doc = SkPDF::MakeDocument(&stream);
+        SkPaint paint;
+        paint.setShader(SkShaders::MakeFractalNoise(0.05f, 0.05f, 2, 0, nullptr));
+        for (int page = 0; page < pageCount; ++page) {
+            SkCanvas* canvas = doc->beginPage(100, 100);
+            canvas->drawRect(SkRect::MakeWH(100, 100), paint);
+            doc->endPage();
+        }
+        doc->close();
+        sk_sp<SkData> pdf = stream.detachAsData();
+        return count_occurrences(pdf.get(), "/Subtype /Image");
+    };
+    int onePage = countImages(1);
+    REPORTER_ASSERT(reporter, onePage > 0);
+    REPORTER_ASSERT(reporter, countImages(3) == onePage);
+}
+
+static int count_picture_forms(SkBlendMode mode, sk_sp<SkShader> shader = nullptr) {
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(SkRect::MakeWH(50, 50));
+    SkPaint paint;
+    paint.setBlendMode(mode);
+    paint.setColor(SK_ColorRED);
+    paint.setShader(std::move(shader));
+    recordingCanvas->drawRect(SkRect::MakeWH(50, 25), paint);
+    paint.setShader(nullptr);
+    paint.setColor(SK_ColorBLUE);
+    recordingCanvas->drawCircle(25, 35, 10, paint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream);
+    SkCanvas* canvas = doc->beginPage(600, 100);
+    for (int i = 0; i < 10; ++i) {
+        canvas->save();
+        canvas->translate(60.0f * i, 0);
+        canvas->clipRect(SkRect::MakeWH(40, 40));
+        canvas->drawPicture(picture);
+        canvas->restore();
+    }
+    doc->endPage();
+    doc->close();
+    sk_sp<SkData> pdf = stream.detachAsData();
+    return count_occurrences(pdf.get(), "/Subtype /Form");
+}
+
+DEF_TEST(SkPDF_PictureFormShared, reporter) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_PictureFormShared, reporter);
+    REPORTER_ASSERT(reporter, count_picture_forms(SkBlendMode::kSrcOver) == 1);
+    // Pictures which blend with their backdrop can not become an isolated form.
+    REPORTER_ASSERT(reporter, count_picture_forms(SkBlendMode::kMultiply) == 0);
+    // Gradients are written as patterns, which scale with the form...
+    const SkPoint points[] = {{0, 0}, {50, 0}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    REPORTER_ASSERT(reporter, count_picture_forms(SkBlendMode::kSrcOver,
+                                                  SkGradientShader::MakeLinear(
+                                                          points, colors, nullptr, 2,
+                                                          SkTileMode::kClamp)) == 1);
+    // ... but noise is rasterized, so it must be drawn at each draw's own resolution.
+    REPORTER_ASSERT(reporter, count_picture_forms(SkBlendMode::kSrcOver,
+                                                  SkShaders::MakeFractalNoise(
+                                                          0.05f, 0.05f, 2, 0, nullptr)) == 0);
+}
+
 DEF_TEST(fuzz875632f0, reporter) {
     SkNullWStream stream;
     auto doc = SkPDF::MakeDocument(&stream);
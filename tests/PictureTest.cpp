@@ -900,7 +900,10 @@ DEF_TEST(Picture_nested_op_count, r) {
             if (pic) {
                 c->drawPicture(pic);
             } else {
-                c->drawRect({0,0, 100,100}, SkPaint{});
+                // Anti-aliased, so the later rects don't hide the earlier ones.
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                c->drawRect({0,0, 100,100}, paint);
             }
         }
         return rec.finishRecordingAsPicture();
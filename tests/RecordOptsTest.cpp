@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
@@ -16,6 +18,7 @@
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
@@ -25,6 +28,7 @@
 #include "src/core/SkRecords.h"
 #include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <array>
 #include <cstddef>
@@ -426,3 +430,143 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint aa;
+    aa.setAntiAlias(true);
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 50, 50), SkPaint());   // Hidden.
+    recorder.drawOval(SkRect::MakeXYWH(20, 20, 50, 50), aa);          // Anti-aliased.
+    recorder.drawRect(SkRect::MakeXYWH(150, 10, 50, 50), SkPaint());  // Not entirely covered.
+    recorder.drawRect(SkRect::MakeWH(100, 100), translucent);         // Hidden.
+    recorder.drawRect(SkRect::MakeWH(180, 100), SkPaint());
+    recorder.drawRect(SkRect::MakeWH(W, H), translucent);             // Hides nothing.
+
+    REPORTER_ASSERT(r, 2 == SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H)));
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::DrawOval>(r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::NoOp>    (r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsUnderMatrixAndClip, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.drawRect(SkRect::MakeWH(80, 80), SkPaint());                     // 0, hidden by 5
+    recorder.drawRect(SkRect::MakeWH(81, 80), SkPaint());                     // 1
+    recorder.save();                                                          // 2
+        recorder.scale(2, 2);                                                 // 3
+        recorder.clipRect(SkRect::MakeWH(40, 40));                            // 4
+        recorder.drawPaint(SkPaint());                                        // 5
+    recorder.restore();                                                       // 6
+
+    recorder.drawRect(SkRect::MakeXYWH(200, 0, 50, 50), SkPaint());           // 7
+    recorder.save();                                                          // 8
+        recorder.clipRect(SkRect::MakeXYWH(200, 0, 50, 50), true);            // 9
+        recorder.drawPaint(SkPaint());                                        // 10, AA clip
+    recorder.restore();                                                       // 11
+
+    recorder.drawRect(SkRect::MakeXYWH(300, 0, 10, 10), SkPaint());           // 12
+    recorder.save();                                                          // 13
+        recorder.rotate(45, 305, 5);                                          // 14
+        recorder.drawRect(SkRect::MakeXYWH(250, -50, 110, 110), SkPaint());   // 15, rotated
+    recorder.restore();                                                       // 16
+
+    recorder.drawRect(SkRect::MakeXYWH(0, 200, 50, 50), SkPaint());           // 17
+    recorder.save();                                                          // 18
+        recorder.clipRegion(SkRegion(SkIRect::MakeXYWH(0, 200, 50, 50)));     // 19
+        recorder.drawPaint(SkPaint());                                        // 20, device clip
+    recorder.restore();                                                       // 21
+
+    REPORTER_ASSERT(r, 1 == SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H)));
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+    assert_type<SkRecords::DrawRect>(r, record, 12);
+    assert_type<SkRecords::DrawRect>(r, record, 17);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsInLayers, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint blur;
+    blur.setImageFilter(SkImageFilters::Blur(4, 4, nullptr));
+
+    recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());                     // 0
+    recorder.saveLayer(nullptr, nullptr);                                     // 1
+        recorder.drawRect(SkRect::MakeWH(50, 50), SkPaint());                 // 2, hidden by 3
+        recorder.drawRect(SkRect::MakeWH(100, 100), SkPaint());               // 3
+    recorder.restore();                                                       // 4
+    recorder.saveLayer(nullptr, &blur);                                       // 5
+        recorder.drawRect(SkRect::MakeXYWH(200, 0, 50, 50), SkPaint());       // 6, blurred
+    recorder.restore();                                                       // 7
+    recorder.drawRect(SkRect::MakeXYWH(150, 0, 150, 100), SkPaint());         // 8
+
+    // The opaque draw in the first layer covers the layer, not what's under it, and the blur
+    // can spread the second layer's rect out from under the last one.
+    REPORTER_ASSERT(r, 1 == SkRecordNoopOccludedDraws(&record, SkRect::MakeWH(W, H)));
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 6);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawsDrawTheSame, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint aa;
+        aa.setAntiAlias(true);
+        aa.setColor(SK_ColorBLUE);
+        SkPaint green;
+        green.setColor(SK_ColorGREEN);
+
+        canvas->drawColor(SK_ColorWHITE);
+        canvas->drawRect(SkRect::MakeXYWH(10, 10, 30, 30), green);
+        canvas->drawOval(SkRect::MakeXYWH(30, 30, 30, 30), aa);
+        canvas->save();
+            canvas->clipRect(SkRect::MakeXYWH(5, 5, 50, 40));
+            canvas->drawColor(SK_ColorRED);
+        canvas->restore();
+        canvas->drawRect(SkRect::MakeXYWH(20, 20, 60, 60), green);
+    };
+
+    // With a BBH, the BBH is built from the bounds the occlusion pass computed.
+    SkRTreeFactory rtreeFactory;
+    for (SkBBHFactory* bbhFactory : {static_cast<SkBBHFactory*>(nullptr),
+                                     static_cast<SkBBHFactory*>(&rtreeFactory)}) {
+        SkPictureRecorder recorder;
+        draw(recorder.beginRecording(SkRect::MakeWH(100, 100), bbhFactory));
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+        // Hidden draws stay hidden however the picture is transformed.
+        for (SkScalar degrees : {0.0f, 17.0f}) {
+            for (SkScalar scale : {1.0f, 0.3f, 2.7f}) {
+                SkBitmap expected, actual;
+                expected.allocN32Pixels(100, 100);
+                actual.allocN32Pixels(100, 100);
+                for (SkBitmap* bitmap : {&expected, &actual}) {
+                    SkCanvas canvas(*bitmap);
+                    canvas.clear(SK_ColorBLACK);
+                    canvas.rotate(degrees, 50, 50);
+                    canvas.scale(scale, scale);
+                    if (bitmap == &expected) {
+                        draw(&canvas);
+                    } else {
+                        canvas.drawPicture(picture);
+                    }
+                }
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual),
+                                "bbh %d, degrees %g, scale %g", bbhFactory != nullptr, degrees,
+                                scale);
+            }
+        }
+    }
+}
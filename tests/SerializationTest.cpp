@@ -1039,3 +1039,54 @@ DEF_TEST(ReadBuffer_empty, reporter) {
     REPORTER_ASSERT(reporter, data->size() == 0);
     REPORTER_ASSERT(reporter, reader.readInt() == 321);
 }
+
+DEF_TEST(Serialization_ShareSourceData, reporter) {
+    SkPictureRecorder recorder;
+    draw_something(recorder.beginRecording(SkIntToScalar(kBitmapSize),
+                                           SkIntToScalar(kBitmapSize)));
+    sk_sp<SkPicture> pict = recorder.finishRecordingAsPicture();
+
+    SkSerialProcs sProcs;
+    sProcs.fImageProc = [](SkImage* img, void*) -> sk_sp<SkData> {
+        return SkPngEncoder::Encode(nullptr, img, SkPngEncoder::Options{});
+    };
+    sk_sp<SkData> data = pict->serialize(&sProcs);
+    REPORTER_ASSERT(reporter, data);
+    sk_sp<SkImage> expected = render(*pict);
+
+    for (bool share : {false, true}) {
+        struct Context {
+            const SkData* source;
+            int images = 0;
+            int shared = 0;
+        } ctx = {data.get()};
+
+        SkDeserialProcs dProcs;
+        dProcs.fShareSourceData = share;
+        dProcs.fImageCtx = &ctx;
+        dProcs.fImageDataProc = [](sk_sp<SkData> encoded, std::optional<SkAlphaType> alphaType,
+                                   void* ctx) {
+            auto context = static_cast<Context*>(ctx);
+            const uint8_t* begin = context->source->bytes();
+            const uint8_t* end = begin + context->source->size();
+            context->images++;
+            if (encoded->bytes() >= begin && encoded->bytes() + encoded->size() <= end) {
+                context->shared++;
+            }
+            return SkImages::DeferredFromEncodedData(std::move(encoded), alphaType);
+        };
+
+        sk_sp<SkPicture> readPict = SkPicture::MakeFromData(data.get(), &dProcs);
+        REPORTER_ASSERT(reporter, readPict);
+        REPORTER_ASSERT(reporter, ctx.images > 0);
+        REPORTER_ASSERT(reporter, ctx.shared == (share ? ctx.images : 0),
+                        "share %d: %d of %d images shared", share, ctx.shared, ctx.images);
+
+        // The images keep the source data alive.
+        const bool unique = data->unique();
+        REPORTER_ASSERT(reporter, unique == !share);
+
+        sk_sp<SkImage> actual = render(*readPict);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected.get(), actual.get()));
+    }
+}
@@ -182,6 +182,47 @@ DEF_TEST(ShaderTestNestedBlendsCpu, reporter) {
     test_nested_blends(reporter, surface.get());
 }
 
+DEF_TEST(PerlinNoiseStitchedTileCpu, reporter) {
+    // Drawn with a whole pixel translation, stitched noise is read from the cached tiles the draw
+    // covers. Drawn mirrored, it is evaluated per pixel at the same points. The two must match
+    // exactly, over the first tile and over the many tiles around it.
+    const SkISize tileSize = SkISize::Make(64, 48);
+    const SkImageInfo ii = SkImageInfo::MakeN32Premul(5 * tileSize.width(), 4 * tileSize.height());
+    for (bool turbulence : {false, true}) {
+        sk_sp<SkShader> shader =
+                turbulence ? SkShaders::MakeTurbulence(0.05f, 0.07f, 3, 4.0f, &tileSize)
+                           : SkShaders::MakeFractalNoise(0.05f, 0.07f, 3, 4.0f, &tileSize);
+        SkPaint paint;
+        paint.setShader(shader);
+        paint.setBlendMode(SkBlendMode::kSrc);
+
+        for (SkIPoint offset : {SkIPoint{0, 0}, SkIPoint{133, 61}, SkIPoint{-200, -150}}) {
+            sk_sp<SkSurface> tiled = SkSurfaces::Raster(ii);
+            tiled->getCanvas()->translate(offset.fX, offset.fY);
+            tiled->getCanvas()->drawPaint(paint);
+
+            sk_sp<SkSurface> mirrored = SkSurfaces::Raster(ii);
+            SkMatrix mirror;
+            mirror.setScaleTranslate(-1, 1, ii.width() - offset.fX, offset.fY);
+            mirrored->getCanvas()->setMatrix(mirror);
+            mirrored->getCanvas()->drawPaint(paint);
+
+            SkPixmap expected, actual;
+            SkAssertResult(mirrored->peekPixels(&expected));
+            SkAssertResult(tiled->peekPixels(&actual));
+            int mismatches = 0;
+            for (int y = 0; y < ii.height(); ++y) {
+                for (int x = 0; x < ii.width(); ++x) {
+                    mismatches += *expected.addr32(ii.width() - 1 - x, y) != *actual.addr32(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0,
+                            "turbulence %d, offset (%d, %d): %d pixels differ",
+                            turbulence, offset.fX, offset.fY, mismatches);
+        }
+    }
+}
+
 #if defined(SK_GANESH)
 DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ShaderTestNestedBlendsGanesh,
                                        reporter,
@@ -5,21 +5,32 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
+#include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrike.h"  // IWYU pragma: keep
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkStrikeStore.h"
+#include "src/text/GlyphRun.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 #include "tools/fonts/FontToolUtils.h"
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
     SkStrikeCache cache;
 
@@ -61,3 +72,182 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
 
 
 }
+
+DEF_TEST(SkStrikeCache_CountLimit, Reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(8);
+
+    SkFont font;
+    font.setTypeface(ToolUtils::CreatePortableTypeface("serif", SkFontStyle::Normal()));
+
+    SkPaint defaultPaint;
+    // The strikes land in different shards, but the limit holds for the whole cache.
+    for (int size = 1; size <= 64; ++size) {
+        font.setSize(size);
+        SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+                font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I());
+        sk_sp<SkStrike> strike = strikeSpec.findOrCreateStrike(&cache);
+        REPORTER_ASSERT(Reporter, strike);
+        REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() <= 8);
+    }
+
+    cache.purgeAll();
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
+}
+
+DEF_TEST(SkStrikeCache_StrikeStore, Reporter) {
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(typeface, 24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkPaint defaultPaint;
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    SkPackedGlyphID glyphIDs[4];
+    for (int i = 0; i < 4; ++i) {
+        glyphIDs[i] = SkPackedGlyphID{font.unicharToGlyph("Skia"[i])};
+    }
+
+    SkStrikeCache writer;
+    sk_sp<SkStrike> written = strikeSpec.findOrCreateStrike(&writer);
+    const SkGlyph* writtenGlyphs[4];
+    written->prepareImages(glyphIDs, writtenGlyphs);
+
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(Reporter, SkStrikeStore::Write(&writer, &stream));
+    sk_sp<SkData> data = stream.detachAsData();
+    sk_sp<SkStrikeStore> store = SkStrikeStore::MakeFromData(data);
+    REPORTER_ASSERT(Reporter, store && store->count() == 1);
+    if (!store) {
+        return;
+    }
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() - 4);
+    REPORTER_ASSERT(Reporter, !SkStrikeStore::MakeFromData(truncated));
+
+    // A cache without the store only has the empty strike.
+    SkStrikeCache plain;
+    sk_sp<SkStrike> plainStrike = strikeSpec.findOrCreateStrike(&plain);
+
+    SkStrikeCache reader;
+    reader.setStrikeStore(store);
+    sk_sp<SkStrike> read = strikeSpec.findOrCreateStrike(&reader);
+    REPORTER_ASSERT(Reporter, reader.getTotalMemoryUsed() > plain.getTotalMemoryUsed());
+
+    const SkGlyph* readGlyphs[4];
+    read->prepareImages(glyphIDs, readGlyphs);
+    for (int i = 0; i < 4; ++i) {
+        REPORTER_ASSERT(Reporter,
+                        readGlyphs[i]->mask().fBounds == writtenGlyphs[i]->mask().fBounds);
+        REPORTER_ASSERT(Reporter, readGlyphs[i]->imageSize() == writtenGlyphs[i]->imageSize());
+        if (readGlyphs[i]->image() && writtenGlyphs[i]->image()) {
+            REPORTER_ASSERT(Reporter, 0 == memcmp(readGlyphs[i]->image(),
+                                                  writtenGlyphs[i]->image(),
+                                                  readGlyphs[i]->imageSize()));
+        }
+    }
+}
+
+DEF_TEST(SkStrikeCache_Prewarm, Reporter) {
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(typeface, 24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    font.setSubpixel(true);
+    SkPaint defaultPaint;
+    SkStrikeSpec strikeSpec = SkStrikeSpec::MakeMask(
+            font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+
+    // Many glyphs, at two sub-pixel positions, for the one strike, so they are generated in
+    // several chunks at once.
+    static constexpr char kText[] = "The quick brown fox jumps over the lazy dog. 0123456789";
+    const size_t textLength = strlen(kText);
+    std::vector<SkPackedGlyphID> packedIDs;
+    std::vector<SkGlyphID> glyphIDs;
+    for (size_t i = 0; i < textLength; ++i) {
+        const SkGlyphID glyphID = font.unicharToGlyph(kText[i]);
+        packedIDs.push_back(SkPackedGlyphID{glyphID});
+        packedIDs.push_back(
+                SkPackedGlyphID{glyphID, SkPoint{0.5f, 0}, SkPackedGlyphID::kXYFieldMask});
+        glyphIDs.push_back(glyphID);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkStrikeCache prewarmed;
+    sk_sp<SkStrike> strike = strikeSpec.findOrCreateStrike(&prewarmed);
+    const size_t emptySize = prewarmed.getTotalMemoryUsed();
+    SkStrikeCache::PrewarmRequest request{strike, packedIDs, glyphIDs};
+    SkStrikeCache::Prewarm({&request, 1}, executor.get());
+    REPORTER_ASSERT(Reporter, prewarmed.getTotalMemoryUsed() > emptySize);
+
+    // Everything requested is now in the strike.
+    std::vector<SkPackedGlyphID> missingImages = packedIDs;
+    std::vector<SkGlyphID> missingPaths = glyphIDs;
+    strike->removeGenerated(&missingImages, &missingPaths);
+    REPORTER_ASSERT(Reporter, missingImages.empty());
+    REPORTER_ASSERT(Reporter, missingPaths.empty());
+
+    // Prewarming again generates nothing.
+    const size_t prewarmedSize = prewarmed.getTotalMemoryUsed();
+    SkStrikeCache::Prewarm({&request, 1}, executor.get());
+    REPORTER_ASSERT(Reporter, prewarmed.getTotalMemoryUsed() == prewarmedSize);
+
+    // The glyphs are the same as the ones the strike generates itself.
+    SkStrikeCache plain;
+    sk_sp<SkStrike> plainStrike = strikeSpec.findOrCreateStrike(&plain);
+    std::vector<const SkGlyph*> expected(packedIDs.size()), actual(packedIDs.size());
+    plainStrike->prepareImages(packedIDs, expected.data());
+    strike->prepareImages(packedIDs, actual.data());
+    for (size_t i = 0; i < packedIDs.size(); ++i) {
+        REPORTER_ASSERT(Reporter, actual[i]->mask().fBounds == expected[i]->mask().fBounds);
+        REPORTER_ASSERT(Reporter, actual[i]->imageSize() == expected[i]->imageSize());
+        if (actual[i]->image() && expected[i]->image()) {
+            REPORTER_ASSERT(Reporter, 0 == memcmp(actual[i]->image(),
+                                                  expected[i]->image(),
+                                                  actual[i]->imageSize()));
+        }
+    }
+    REPORTER_ASSERT(Reporter, prewarmed.getTotalMemoryUsed() == prewarmedSize);
+}
+
+DEF_TEST(SkStrikeCache_PrewarmTextBlob, Reporter) {
+    sk_sp<SkTypeface> typeface = ToolUtils::CreateTypefaceFromResource("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(typeface, 17);
+    font.setSubpixel(true);
+    sk_sp<SkTextBlob> blob = SkTextBlob::MakeFromString("Warm up these glyphs", font);
+
+    sk_sp<SkTextBlob> bigBlob = SkTextBlob::MakeFromString("Big", SkFont(typeface, 300));
+
+    const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    const SkImageInfo dstInfo = SkImageInfo::MakeN32Premul(256, 256);
+    SkPaint paint;
+    const SkMatrix matrix = SkMatrix::Translate(10.25f, 20);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+    SkStrikeCache::PrewarmTextBlobs({blob, bigBlob}, paint, matrix, dstInfo, props, executor.get());
+
+    // The strikes a draw would use, one with images and one with paths, have every glyph.
+    SkGlyphRunListPainterCPU painter(props, dstInfo.colorType(), dstInfo.colorSpace());
+    sktext::GlyphRunBuilder builder;
+    std::vector<SkStrikeCache::PrewarmRequest> requests;
+    for (const sk_sp<SkTextBlob>& b : {blob, bigBlob}) {
+        painter.collectPrewarmRequests(
+                builder.blobToGlyphRunList(*b, {0, 0}), paint, matrix, &requests);
+    }
+    REPORTER_ASSERT(Reporter, requests.size() == 2);
+    for (SkStrikeCache::PrewarmRequest& request : requests) {
+        request.fStrike->removeGenerated(&request.fImages, &request.fPaths);
+        REPORTER_ASSERT(Reporter, request.fImages.empty());
+        REPORTER_ASSERT(Reporter, request.fPaths.empty());
+    }
+}
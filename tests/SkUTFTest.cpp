@@ -5,6 +5,7 @@
 #include "src/base/SkUTF.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstddef>
@@ -57,6 +58,40 @@ DEF_TEST(SkUTF_UTF8, reporter) {
     }
 }
 
+DEF_TEST(SkUTF_UTF8ToUTF32, reporter) {
+    // Long enough for the 16 byte ASCII runs, with multi-byte sequences in and between them.
+    const char* texts[] = {
+        "",
+        "short",
+        "The quick brown fox jumps over the lazy dog.",
+        "caf\xC3\xA9 au lait, cr\xC3\xA8me br\xC3\xBBl\xC3\xA9""e, and \xE2\x82\xAC""5 each",
+        "0123456789abcde\xF0\x9F\x98\x80""0123456789abcdef0123456789abcdef\xE3\x83\x83",
+    };
+    for (const char* text : texts) {
+        const size_t length = strlen(text);
+        SkUnichar expected[128];
+        int expectedCount = 0;
+        for (const char* p = text; p < text + length;) {
+            expected[expectedCount++] = SkUTF::NextUTF8(&p, text + length);
+        }
+
+        SkUnichar utf32[128];
+        REPORTER_ASSERT(reporter, SkUTF::UTF8ToUTF32(nullptr, 0, text, length) == expectedCount);
+        REPORTER_ASSERT(reporter, SkUTF::UTF8ToUTF32(utf32, 128, text, length) == expectedCount);
+        REPORTER_ASSERT(reporter, 0 == memcmp(utf32, expected, expectedCount * sizeof(SkUnichar)));
+
+        // A short buffer holds as many as fit, and the whole count is returned.
+        SkUnichar partial[20] = {};
+        const int capacity = std::min(expectedCount, 20);
+        REPORTER_ASSERT(reporter,
+                        SkUTF::UTF8ToUTF32(partial, capacity, text, length) == expectedCount);
+        REPORTER_ASSERT(reporter, 0 == memcmp(partial, expected, capacity * sizeof(SkUnichar)));
+    }
+
+    const char invalid[] = "0123456789abcdef0123456789abcdef\xC2";
+    REPORTER_ASSERT(reporter, SkUTF::UTF8ToUTF32(nullptr, 0, invalid, strlen(invalid)) == -1);
+}
+
 #define ASCII_BYTE         "X"
 #define CONTINUATION_BYTE  "\xA1"
 #define LEADING_TWO_BYTE   "\xC2"
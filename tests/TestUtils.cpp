@@ -34,6 +34,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <iterator>
 #include <utility>
 
 void TestReadPixels(skiatest::Reporter* reporter,
@@ -308,3 +309,38 @@ DEF_TEST(chartoglyph_cache, reporter) {
         }
     }
 }
+
+DEF_TEST(chartoglyph_cache_findGlyphs, reporter) {
+    SkCharToGlyphCache cache;
+    // Latin text, one unichar past the BMP, and enough blocks to use up the pages.
+    const SkUnichar unichars[] = {'H', 'e', 'l', 'o', ' ', 0xE9, 0x20AC, 0x1F600};
+    for (SkUnichar c : unichars) {
+        cache.addCharAndGlyph(c, hash_to_glyph(c));
+    }
+    for (SkUnichar block = 0x0100; block < 0x2000; block += 0x100) {
+        cache.addCharAndGlyph(block + 1, hash_to_glyph(block + 1));
+    }
+
+    SkGlyphID glyphs[std::size(unichars)];
+    REPORTER_ASSERT(reporter, cache.findGlyphs(unichars, std::size(unichars), glyphs) ==
+                              (int)std::size(unichars));
+    for (size_t i = 0; i < std::size(unichars); ++i) {
+        REPORTER_ASSERT(reporter, glyphs[i] == hash_to_glyph(unichars[i]));
+    }
+    for (SkUnichar block = 0x0100; block < 0x2000; block += 0x100) {
+        REPORTER_ASSERT(reporter,
+                        cache.findGlyphIndex(block + 1) == hash_to_glyph(block + 1));
+        REPORTER_ASSERT(reporter, cache.findGlyphIndex(block + 2) < 0);
+    }
+
+    // The lookup stops at the first unichar which is not cached.
+    const SkUnichar text[] = {'H', 'e', 'y', 'o'};
+    REPORTER_ASSERT(reporter, cache.findGlyphs(text, std::size(text), glyphs) == 2);
+    int index = cache.findGlyphIndex('y');
+    REPORTER_ASSERT(reporter, index < 0);
+    cache.insertCharAndGlyph(~index, 'y', hash_to_glyph('y'));
+    REPORTER_ASSERT(reporter, cache.findGlyphs(text, std::size(text), glyphs) == 4);
+
+    cache.reset();
+    REPORTER_ASSERT(reporter, cache.findGlyphs(text, std::size(text), glyphs) == 0);
+}
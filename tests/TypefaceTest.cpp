@@ -20,10 +20,14 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkFixed.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkEndian.h"
 #include "src/base/SkUTF.h"
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkFontPriv.h"
+#include "src/core/SkGlyph.h"
+#include "src/core/SkScalerContext.h"
+#include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTypefaceCache.h"
 #include "src/sfnt/SkOTTable_OS_2.h"
 #include "src/sfnt/SkOTTable_OS_2_V0.h"
@@ -34,6 +38,10 @@
 #include "tools/fonts/FontToolUtils.h"
 #include "tools/fonts/TestEmptyTypeface.h"
 
+#ifdef SK_TYPEFACE_FACTORY_FREETYPE
+#include "src/ports/SkTypeface_FreeType.h"
+#endif
+
 #include <algorithm>
 #include <array>
 #include <cinttypes>
@@ -710,3 +718,51 @@ DEF_TEST(LegacyMakeTypeface, reporter) {
         REPORTER_ASSERT(reporter, typeface3->isBold());
     }
 }
+
+#ifdef SK_TYPEFACE_FACTORY_FREETYPE
+DEF_TEST(TypefaceFreeTypePrivateFaces, reporter) {
+    sk_sp<SkTypeface> typeface = SkTypeface_FreeType::MakeFromStream(
+            GetResourceAsStream("fonts/Roboto-Regular.ttf"), SkFontArguments());
+    if (!typeface) {
+        return;
+    }
+    auto ftTypeface = static_cast<SkTypeface_FreeType*>(typeface.get());
+    SkFont font(typeface, 24);
+    const SkStrikeSpec strikeSpec = SkStrikeSpec::MakeWithNoDevice(font);
+
+    // The first context borrows the typeface's face, the second one gets a private face.
+    std::unique_ptr<SkScalerContext> shared = strikeSpec.createScalerContext();
+    std::unique_ptr<SkScalerContext> owned = strikeSpec.createScalerContext();
+    REPORTER_ASSERT(reporter, ftTypeface->pooledFaceCount() == 0);
+
+    // Both rasterize the same glyphs.
+    SkGlyphID glyphIDs[26];
+    font.textToGlyphs("abcdefghijklmnopqrstuvwxyz", 26, SkTextEncoding::kUTF8, glyphIDs, 26);
+    SkArenaAlloc alloc(4096);
+    for (SkGlyphID glyphID : glyphIDs) {
+        SkGlyph expected = shared->makeGlyph(SkPackedGlyphID(glyphID), &alloc);
+        SkGlyph glyph = owned->makeGlyph(SkPackedGlyphID(glyphID), &alloc);
+        REPORTER_ASSERT(reporter, glyph.iRect() == expected.iRect());
+        REPORTER_ASSERT(reporter, glyph.advanceX() == expected.advanceX());
+        if (glyph.iRect() != expected.iRect() || glyph.isEmpty()) {
+            continue;
+        }
+        expected.setImage(&alloc, shared.get());
+        glyph.setImage(&alloc, owned.get());
+        REPORTER_ASSERT(reporter,
+                        0 == memcmp(glyph.image(), expected.image(), glyph.imageSize()));
+    }
+
+    // The private face goes back to the pool, and the next context takes it from there.
+    owned.reset();
+    REPORTER_ASSERT(reporter, ftTypeface->pooledFaceCount() == 1);
+    owned = strikeSpec.createScalerContext();
+    REPORTER_ASSERT(reporter, ftTypeface->pooledFaceCount() == 0);
+    owned.reset();
+
+    // With no other context alive, a context borrows the typeface's face again.
+    shared.reset();
+    shared = strikeSpec.createScalerContext();
+    REPORTER_ASSERT(reporter, ftTypeface->pooledFaceCount() == 1);
+}
+#endif
@@ -167,6 +167,21 @@ SkBitmap create_checkerboard_bitmap(int w, int h, SkColor c1, SkColor c2, int ch
     return bitmap;
 }
 
+void fill_random_premul(SkBitmap* bm, const SkIRect& rect, SkRandom* random, bool opaque) {
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            *bm->getAddr32(x, y) = SkPreMultiplyColor(random->nextU() | (opaque ? 0xFF000000 : 0));
+        }
+    }
+}
+
+SkBitmap create_random_premul_bitmap(int w, int h, SkRandom* random, bool opaque) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(w, h);
+    fill_random_premul(&bitmap, SkIRect::MakeWH(w, h), random, opaque);
+    return bitmap;
+}
+
 sk_sp<SkImage> create_checkerboard_image(int w, int h, SkColor c1, SkColor c2, int checkSize) {
     auto surf = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(w, h));
     ToolUtils::draw_checkerboard(surf->getCanvas(), c1, c2, checkSize);
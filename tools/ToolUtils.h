@@ -91,6 +91,12 @@ SkBitmap create_checkerboard_bitmap(int w, int h, SkColor c1, SkColor c2, int ch
 
 sk_sp<SkImage> create_checkerboard_image(int w, int h, SkColor c1, SkColor c2, int checkSize);
 
+/** Fill 'rect' of an N32 bitmap with random premultiplied colors, opaque ones if 'opaque'. */
+void fill_random_premul(SkBitmap* bm, const SkIRect& rect, SkRandom* random, bool opaque = false);
+
+/** Make an N32 bitmap filled with random premultiplied colors, opaque ones if 'opaque'. */
+SkBitmap create_random_premul_bitmap(int w, int h, SkRandom* random, bool opaque = false);
+
 /** A default checkerboard. */
 inline void draw_checkerboard(SkCanvas* canvas) {
     ToolUtils::draw_checkerboard(canvas, 0xFF999999, 0xFF666666, 8);
@@ -143,6 +143,20 @@ private:
     SkRecords::Draw fDraw;
 };
 
+struct IsDraw {
+    template <typename T> int operator()(const T&) {
+        return (T::kTags & SkRecords::kDraw_Tag) ? 1 : 0;
+    }
+};
+
+static int count_draws(const SkRecord& record) {
+    int draws = 0;
+    for (int i = 0; i < record.count(); i++) {
+        draws += record.visit(i, IsDraw());
+    }
+    return draws;
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::Parse(argc, argv);
 
@@ -168,8 +182,11 @@ int main(int argc, char** argv) {
         SkRecorder rec(&record, w, h);
         src->playback(&rec);
 
+        int culledDraws = 0;
         if (FLAGS_optimize) {
-            SkRecordOptimize(&record);
+            const int draws = count_draws(record);
+            SkRecordOptimize(&record, src->cullRect());
+            culledDraws = draws - count_draws(record);
         }
 
         SkBitmap bitmap;
@@ -179,6 +196,9 @@ int main(int argc, char** argv) {
                                        SkIntToScalar(FLAGS_tile)));
 
         printf("%s %s\n", FLAGS_optimize ? "optimized" : "not-optimized", FLAGS_skps[i]);
+        if (FLAGS_optimize) {
+            printf("%d occluded draws culled\n", culledDraws);
+        }
 
         Dumper dumper(&canvas, record.count());
         for (int j = 0; j < record.count(); j++) {